@@ -14,14 +14,19 @@ STATUS=0
 echo "Compiler should accept..."
 echo ""
 
+# The automata a test builds and the answers of its queries, if it has any, must match the ones in src/test/c/expected.
 for test in src/test/c/accept/*; do
-	build/Compiler >/dev/null 2>&1 <"$test"
+	OUTPUT="$(LOGGING_LEVEL=INFORMATION build/Compiler 2>&1 <"$test")"
 	RESULT="$?"
-	if [ "$RESULT" == "0" ]; then
-		echo -e "    $test, ${GREEN}and it does${OFF} (status $RESULT)"
-	else
+	EXPECTED="src/test/c/expected/$(basename "$test")"
+	if [ "$RESULT" != "0" ]; then
 		STATUS=1
 		echo -e "    $test, ${RED}but it rejects${OFF} (status $RESULT)"
+	elif [ -f "$EXPECTED" ] && ! echo "$OUTPUT" | sed 's/\x1b\[[0-9;]*m//g' | grep -o "\(Language\|Query\) .*" | diff "$EXPECTED" - >/dev/null; then
+		STATUS=1
+		echo -e "    $test, ${RED}but it builds or answers something wrong${OFF} (status $RESULT)"
+	else
+		echo -e "    $test, ${GREEN}and it does${OFF} (status $RESULT)"
 	fi
 done
 echo ""
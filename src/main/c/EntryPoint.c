@@ -1,12 +1,27 @@
 // #include "backend/code-generation/Generator.h"
-// #include "backend/domain-specific/Calculator.h"
+#include "backend/domain-specific/Alphabet.h"
+#include "backend/domain-specific/Bisimulation.h"
+#include "backend/domain-specific/Determinization.h"
+#include "backend/domain-specific/EpsilonRemoval.h"
+#include "backend/domain-specific/ExpressionRewriting.h"
+#include "backend/domain-specific/GrammarAutomaton.h"
+#include "backend/domain-specific/LanguageComparison.h"
+#include "backend/domain-specific/LanguageEvaluator.h"
+#include "backend/domain-specific/LazyDfa.h"
+#include "backend/domain-specific/Minimization.h"
+#include "backend/domain-specific/Product.h"
+#include "backend/domain-specific/SymbolClasses.h"
+#include "backend/domain-specific/WordListAutomaton.h"
 #include "frontend/lexical-analysis/FlexActions.h"
+#include "frontend/lexical-analysis/SymbolFileReader.h"
+#include "frontend/semantic-analysis/SymbolTable.h"
 #include "frontend/syntactic-analysis/ASTUtils.h"
 #include "frontend/syntactic-analysis/AbstractSyntaxTree.h"
 #include "frontend/syntactic-analysis/BisonActions.h"
 #include "frontend/syntactic-analysis/SyntacticAnalyzer.h"
 #include "shared/Array.h"
 #include "shared/CompilerState.h"
+#include "shared/Configuration.h"
 #include "shared/Logger.h"
 #include "shared/Set.h"
 #include "shared/Type.h"
@@ -21,14 +36,28 @@
 int main(const int count, const char** arguments) {
   Logger* logger = createLogger("EntryPoint");
   initializeFlexActionsModule();
+  initializeSymbolFileReaderModule();
   initializeBisonActionsModule();
   initializeSyntacticAnalyzerModule();
   initializeAbstractSyntaxTreeModule();
-  // initializeCalculatorModule();
+  initializeAlphabetModule();
+  initializeBisimulationModule();
+  initializeDeterminizationModule();
+  initializeEpsilonRemovalModule();
+  initializeExpressionRewritingModule();
+  initializeMinimizationModule();
+  initializeProductModule();
+  initializeSymbolClassesModule();
+  initializeGrammarAutomatonModule();
+  initializeWordListAutomatonModule();
+  initializeLanguageComparisonModule();
+  initializeLazyDfaModule();
+  initializeLanguageEvaluatorModule();
   // initializeGeneratorModule();
   Array_initializeLogger();
   Set_initializeLogger();
   initializeASTUtilsModule();
+  initializeSymbolTableModule();
 
   // Logs the arguments of the application.
   for (int k = 0; k < count; ++k) {
@@ -36,34 +65,49 @@ int main(const int count, const char** arguments) {
   }
 
   // Begin compilation process.
-  CompilerState compilerState = {.abstractSyntaxtTree = NULL, .succeed = false, .value = 0};
-  const SyntacticAnalysisStatus syntacticAnalysisStatus = parse(&compilerState);
+  Configuration* configuration = createConfiguration(count, arguments);
+  CompilerState compilerState = {
+    .abstractSyntaxtTree = NULL, .succeed = false, .symbolTable = NULL, .configuration = configuration, .value = 0
+  };
   CompilationStatus compilationStatus = SUCCEED;
-  if (syntacticAnalysisStatus == ACCEPT) {
+  if (configuration == NULL) {
+    logError(logger, "Invalid command-line arguments.");
+    compilationStatus = FAILED;
+  } else if (parse(&compilerState) == ACCEPT) {
     // ----------------------------------------------------------------------------------------
     // Beginning of the Backend... ------------------------------------------------------------
-    logInformation(logger, "Program:");
     Program* program = compilerState.abstractSyntaxtTree;
-
-    size_t sentencesLen = Array_getLen(program->sentences);
-    for (int i = 0; i < sentencesLen; ++i) {
-      Sentence* sentence = Array_get(program->sentences, i).sentence;
-      char* sentenceStr = Sentence_toString(sentence);
-      logInformation(logger, "Sentence %d: %s", i, sentenceStr);
-      free(sentenceStr);
+    SymbolTable symbolTable = SymbolTable_new(program);
+    if (symbolTable == NULL) {
+      logError(logger, "The semantic-analysis phase rejects the input program.");
+      compilationStatus = FAILED;
+    } else if (!SymbolTable_request(symbolTable, configuration->emittedIds, configuration->emittedIdsCount)) {
+      logError(logger, "The requested languages can't be emitted.");
+      compilationStatus = FAILED;
+    } else {
+      compilerState.symbolTable = symbolTable;
+      logInformation(logger, "Program:");
+      size_t sentencesLen = Array_getLen(program->sentences);
+      for (size_t i = 0; i < sentencesLen; ++i) {
+        // Sentences that no requested language depends on were already validated, and are never evaluated.
+        if (!SymbolTable_isRequired(symbolTable, i)) {
+          logDebugging(logger, "Skipping sentence %zu (not required).", i);
+          continue;
+        }
+        Sentence* sentence = Array_get(program->sentences, i).sentence;
+        char* sentenceStr = Sentence_toString(sentence);
+        logInformation(logger, "Sentence %zu: %s", i, sentenceStr);
+        free(sentenceStr);
+      }
+      if (!evaluateLanguages(&compilerState)) {
+        logError(logger, "The evaluation phase rejects the input program.");
+        compilationStatus = FAILED;
+      }
     }
-
-    // ComputationResult computationResult = computeExpression(program->expression);
-    // if (computationResult.succeed) {
-    //   compilerState.value = computationResult.value;
-    //   generate(&compilerState);
-    // } else {
-    //   logError(logger, "The computation phase rejects the input program.");
-    //   compilationStatus = FAILED;
-    // }
     // ...end of the Backend. -----------------------------------------------------------------
     // ----------------------------------------------------------------------------------------
     logDebugging(logger, "Releasing AST resources...");
+    if (symbolTable != NULL) SymbolTable_free(symbolTable);
     releaseProgram(program);
   } else {
     logError(logger, "The syntactic-analysis phase rejects the input program.");
@@ -73,13 +117,28 @@ int main(const int count, const char** arguments) {
   logDebugging(logger, "Releasing modules resources...");
   Array_freeLogger();
   Set_freeLogger();
+  shutdownSymbolTableModule();
   shutdownASTUtilsModule();
   // shutdownGeneratorModule();
-  // shutdownCalculatorModule();
+  shutdownLanguageEvaluatorModule();
+  shutdownLazyDfaModule();
+  shutdownLanguageComparisonModule();
+  shutdownWordListAutomatonModule();
+  shutdownGrammarAutomatonModule();
+  shutdownSymbolClassesModule();
+  shutdownProductModule();
+  shutdownMinimizationModule();
+  shutdownExpressionRewritingModule();
+  shutdownEpsilonRemovalModule();
+  shutdownDeterminizationModule();
+  shutdownBisimulationModule();
+  shutdownAlphabetModule();
   shutdownAbstractSyntaxTreeModule();
   shutdownSyntacticAnalyzerModule();
   shutdownBisonActionsModule();
+  shutdownSymbolFileReaderModule();
   shutdownFlexActionsModule();
+  destroyConfiguration(configuration);
   logDebugging(logger, "Compilation is done.");
   destroyLogger(logger);
   return compilationStatus;
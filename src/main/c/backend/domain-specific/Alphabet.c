@@ -0,0 +1,119 @@
+#include "Alphabet.h"
+#include "../../shared/Logger.h"
+#include "../../shared/hashUtils.h"
+#include "../../shared/utils.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* MODULE INTERNAL STATE */
+
+#define EMPTY_SLOT UINT32_MAX
+#define INITIAL_CAPACITY 64
+
+typedef struct {
+  char* symbol;
+  uint32_t length;
+  uint32_t hash;
+} Entry;
+
+static Logger* _logger = NULL;
+
+// Symbols by id.
+static Entry* _entries = NULL;
+static uint32_t _size = 0;
+static uint32_t _entriesCapacity = 0;
+
+// Open-addressing table of ids, with linear probing.
+static uint32_t* _slots = NULL;
+static uint32_t _slotsCapacity = 0;
+
+void initializeAlphabetModule() {
+  _logger = createLogger("Alphabet");
+  _entriesCapacity = INITIAL_CAPACITY;
+  _entries = safeMalloc(_entriesCapacity * sizeof(Entry));
+  _slotsCapacity = 2 * INITIAL_CAPACITY;
+  _slots = safeMalloc(_slotsCapacity * sizeof(uint32_t));
+  memset(_slots, 0xFF, _slotsCapacity * sizeof(uint32_t));
+  _size = 0;
+}
+
+void shutdownAlphabetModule() {
+  logDebugging(_logger, "The alphabet holds %u symbols.", _size);
+  for (uint32_t k = 0; k < _size; ++k) {
+    free(_entries[k].symbol);
+  }
+  free(_entries);
+  free(_slots);
+  _entries = NULL;
+  _slots = NULL;
+  _size = 0;
+  if (_logger != NULL) {
+    destroyLogger(_logger);
+  }
+}
+
+/* PRIVATE FUNCTIONS */
+
+static uint32_t* _findSlot(const char* symbol, size_t length, uint32_t hash) {
+  const uint32_t mask = _slotsCapacity - 1;
+  for (uint32_t k = hash & mask;; k = (k + 1) & mask) {
+    uint32_t* slot = &_slots[k];
+    if (*slot == EMPTY_SLOT) return slot;
+    const Entry* entry = &_entries[*slot];
+    if (entry->hash == hash && entry->length == length && memcmp(entry->symbol, symbol, length) == 0) return slot;
+  }
+}
+
+/**
+ * Doubles the table, keeping its load factor under 1/2.
+ */
+static void _grow() {
+  free(_slots);
+  _slotsCapacity *= 2;
+  _slots = safeMalloc(_slotsCapacity * sizeof(uint32_t));
+  memset(_slots, 0xFF, _slotsCapacity * sizeof(uint32_t));
+  const uint32_t mask = _slotsCapacity - 1;
+  for (uint32_t id = 0; id < _size; ++id) {
+    uint32_t k = _entries[id].hash & mask;
+    while (_slots[k] != EMPTY_SLOT) k = (k + 1) & mask;
+    _slots[k] = id;
+  }
+}
+
+/* PUBLIC FUNCTIONS */
+
+uint32_t Alphabet_intern(const char* symbol, size_t length) {
+  const uint32_t hash = murmurHash3(1, symbol, length);
+  uint32_t* slot = _findSlot(symbol, length, hash);
+  if (*slot != EMPTY_SLOT) return *slot;
+
+  if (_size == _entriesCapacity) {
+    _entriesCapacity *= 2;
+    _entries = realloc(_entries, _entriesCapacity * sizeof(Entry));
+    if (_entries == NULL) exitWithPerror(__func__, "realloc error");
+  }
+  char* copy = safeMalloc(length + 1);
+  memcpy(copy, symbol, length);
+  copy[length] = '\0';
+  const uint32_t id = _size++;
+  _entries[id] = (Entry){.symbol = copy, .length = (uint32_t)length, .hash = hash};
+  *slot = id;
+  if (_slotsCapacity < 2 * _size) _grow();
+  return id;
+}
+
+int64_t Alphabet_find(const char* symbol, size_t length) {
+  const uint32_t* slot = _findSlot(symbol, length, murmurHash3(1, symbol, length));
+  return *slot == EMPTY_SLOT ? -1 : (int64_t)*slot;
+}
+
+const char* Alphabet_symbol(uint32_t id) {
+  if (_size <= id) exitInvalidArgument(__func__, "Unknown symbol id");
+  return _entries[id].symbol;
+}
+
+uint32_t Alphabet_size() {
+  return _size;
+}
@@ -0,0 +1,39 @@
+#ifndef ALPHABET_HEADER
+#define ALPHABET_HEADER
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Initialize module's internal state. */
+void initializeAlphabetModule();
+
+/** Shutdown module's internal state. */
+void shutdownAlphabetModule();
+
+/**
+ * The global alphabet interns every symbol used by an automaton, so that
+ * transitions are labeled with dense integer ids instead of strings. Ids are
+ * assigned in order of first appearance, starting at 0, and never change.
+ */
+
+/**
+ * @return The id of the symbol, interning it if it wasn't already.
+ */
+uint32_t Alphabet_intern(const char* symbol, size_t length);
+
+/**
+ * @return The id of the symbol, or -1 if it was never interned.
+ */
+int64_t Alphabet_find(const char* symbol, size_t length);
+
+/**
+ * @return The (null-terminated) symbol with the given id.
+ */
+const char* Alphabet_symbol(uint32_t id);
+
+/**
+ * @return The number of interned symbols.
+ */
+uint32_t Alphabet_size();
+
+#endif
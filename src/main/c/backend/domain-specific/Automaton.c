@@ -0,0 +1,490 @@
+#include "Automaton.h"
+#include "../../shared/Bitset.h"
+#include "../../shared/String.h"
+#include "../../shared/utils.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* MODULE INTERNAL STATE */
+
+// The bytes held by every automaton alive, and the most they held at once (automata are built on worker threads too).
+static size_t _liveBytes = 0;
+static size_t _peakBytes = 0;
+
+/* PRIVATE FUNCTIONS */
+
+/**
+ * Adds bytes to what an automaton (and every automaton alive) holds.
+ */
+static void _account(Automaton* automaton, size_t bytes) {
+  automaton->footprint += bytes;
+  const size_t live = __atomic_add_fetch(&_liveBytes, bytes, __ATOMIC_RELAXED);
+  size_t peak = __atomic_load_n(&_peakBytes, __ATOMIC_RELAXED);
+  while (peak < live &&
+         !__atomic_compare_exchange_n(&_peakBytes, &peak, live, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+  }
+}
+
+// Rows up to this length are sorted in place; longer ones are packed and sorted with qsort.
+#define INSERTION_SORT_THRESHOLD 16
+
+static int _compareTransitions(const void* left, const void* right) {
+  const uint64_t a = *(const uint64_t*)left;
+  const uint64_t b = *(const uint64_t*)right;
+  return (a > b) - (a < b);
+}
+
+/**
+ * Sorts the transitions in `begin..end` by symbol, and then by target.
+ */
+static void _sortRow(Automaton* automaton, uint32_t begin, uint32_t end, uint64_t** buffer, size_t* capacity) {
+  uint32_t* symbols = automaton->symbols;
+  uint32_t* targets = automaton->targets;
+  const uint32_t length = end - begin;
+  if (length <= INSERTION_SORT_THRESHOLD) {
+    for (uint32_t k = begin + 1; k < end; ++k) {
+      const uint32_t symbol = symbols[k];
+      const uint32_t target = targets[k];
+      uint32_t j = k;
+      for (; begin < j && (symbol < symbols[j - 1] || (symbol == symbols[j - 1] && target < targets[j - 1])); --j) {
+        symbols[j] = symbols[j - 1];
+        targets[j] = targets[j - 1];
+      }
+      symbols[j] = symbol;
+      targets[j] = target;
+    }
+    return;
+  }
+  if (*capacity < length) {
+    free(*buffer);
+    *buffer = safeMalloc(length * sizeof(uint64_t));
+    *capacity = length;
+  }
+  for (uint32_t k = 0; k < length; ++k) {
+    (*buffer)[k] = (uint64_t)symbols[begin + k] << 32 | targets[begin + k];
+  }
+  qsort(*buffer, length, sizeof(uint64_t), _compareTransitions);
+  for (uint32_t k = 0; k < length; ++k) {
+    symbols[begin + k] = (uint32_t)((*buffer)[k] >> 32);
+    targets[begin + k] = (uint32_t)(*buffer)[k];
+  }
+}
+
+static void _setSink(Automaton* automaton, bool acceptingSink, const uint32_t* alphabet, uint32_t alphabetSize) {
+  automaton->acceptingSink = acceptingSink;
+  if (!acceptingSink) return;
+  automaton->sinkAlphabet = safeMalloc((alphabetSize == 0 ? 1 : alphabetSize) * sizeof(uint32_t));
+  memcpy(automaton->sinkAlphabet, alphabet, alphabetSize * sizeof(uint32_t));
+  automaton->sinkAlphabetSize = alphabetSize;
+  _account(automaton, (alphabetSize == 0 ? 1 : alphabetSize) * sizeof(uint32_t));
+}
+
+static bool _sameAlphabet(const Automaton* automaton, const uint32_t* alphabet, uint32_t alphabetSize) {
+  return automaton->sinkAlphabetSize == alphabetSize &&
+         memcmp(automaton->sinkAlphabet, alphabet, alphabetSize * sizeof(uint32_t)) == 0;
+}
+
+static bool _contains(const uint32_t* alphabet, uint32_t alphabetSize, uint32_t symbol) {
+  uint32_t low = 0;
+  uint32_t high = alphabetSize;
+  while (low < high) {
+    const uint32_t middle = low + (high - low) / 2;
+    if (alphabet[middle] < symbol) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low < alphabetSize && alphabet[low] == symbol;
+}
+
+/**
+ * Builds the closure of an automaton through a new initial state, which
+ * accepts for a star.
+ */
+static Automaton* _closure(const Automaton* automaton, bool star) {
+  if (automaton->acceptingSink) {
+    Automaton* complete = Automaton_materializeSink(automaton);
+    Automaton* closure = _closure(complete, star);
+    Automaton_free(complete);
+    return closure;
+  }
+  const uint32_t hub = automaton->stateCount;
+  const size_t transitionCount =
+    (size_t)automaton->transitionCount + Automaton_acceptingCount(automaton) + automaton->initialStateCount;
+  if (UINT32_MAX <= transitionCount || UINT32_MAX - 1 <= hub) {
+    exitInvalidArgument(__func__, "the closure is too large");
+  }
+
+  Automaton* closure = Automaton_new(hub + 1, (uint32_t)transitionCount, 1);
+  closure->initialStates[0] = hub;
+  uint32_t position = 0;
+  for (uint32_t state = 0; state < automaton->stateCount; ++state) {
+    closure->offsets[state] = position;
+    for (uint32_t k = automaton->offsets[state]; k < automaton->offsets[state + 1]; ++k) {
+      closure->symbols[position] = automaton->symbols[k];
+      closure->targets[position++] = automaton->targets[k];
+    }
+    if (Automaton_isAccepting(automaton, state)) {
+      Bitset_set(closure->accepting, state);
+      closure->symbols[position] = EPSILON;
+      closure->targets[position++] = hub;
+    }
+  }
+  closure->offsets[hub] = position;
+  for (uint32_t k = 0; k < automaton->initialStateCount; ++k) {
+    closure->symbols[position] = EPSILON;
+    closure->targets[position++] = automaton->initialStates[k];
+  }
+  closure->offsets[hub + 1] = position;
+  if (star) Bitset_set(closure->accepting, hub);
+  Automaton_normalize(closure);
+  return closure;
+}
+
+/* PUBLIC FUNCTIONS */
+
+Automaton* Automaton_new(uint32_t stateCount, uint32_t transitionCount, uint32_t initialStateCount) {
+  const size_t initialSize = (initialStateCount == 0 ? 1 : initialStateCount) * sizeof(uint32_t);
+  const size_t transitionSize = (transitionCount == 0 ? 1 : transitionCount) * sizeof(uint32_t);
+  Automaton* automaton = safeMalloc(sizeof(Automaton));
+  automaton->stateCount = stateCount;
+  automaton->transitionCount = transitionCount;
+  automaton->initialStateCount = initialStateCount;
+  automaton->initialStates = safeMalloc(initialSize);
+  automaton->offsets = safeMalloc((1 + (size_t)stateCount) * sizeof(uint32_t));
+  automaton->symbols = safeMalloc(transitionSize);
+  automaton->targets = safeMalloc(transitionSize);
+  automaton->accepting = Bitset_new(stateCount);
+  automaton->deterministic = false;
+  automaton->acceptingSink = false;
+  automaton->sinkAlphabet = NULL;
+  automaton->sinkAlphabetSize = 0;
+  automaton->references = 1;
+  automaton->footprint = 0;
+  _account(
+    automaton, sizeof(Automaton) + initialSize + (1 + (size_t)stateCount) * sizeof(uint32_t) + 2 * transitionSize +
+                 Bitset_words(stateCount) * sizeof(uint64_t)
+  );
+  return automaton;
+}
+
+Automaton* Automaton_copy(const Automaton* automaton) {
+  Automaton* copy =
+    Automaton_new(automaton->stateCount, automaton->transitionCount, automaton->initialStateCount);
+  memcpy(copy->initialStates, automaton->initialStates, automaton->initialStateCount * sizeof(uint32_t));
+  memcpy(copy->offsets, automaton->offsets, (1 + (size_t)automaton->stateCount) * sizeof(uint32_t));
+  memcpy(copy->symbols, automaton->symbols, automaton->transitionCount * sizeof(uint32_t));
+  memcpy(copy->targets, automaton->targets, automaton->transitionCount * sizeof(uint32_t));
+  memcpy(copy->accepting, automaton->accepting, Bitset_words(automaton->stateCount) * sizeof(uint64_t));
+  copy->deterministic = automaton->deterministic;
+  _setSink(copy, automaton->acceptingSink, automaton->sinkAlphabet, automaton->sinkAlphabetSize);
+  return copy;
+}
+
+Automaton* Automaton_empty() {
+  Automaton* automaton = Automaton_new(1, 0, 1);
+  automaton->initialStates[0] = 0;
+  automaton->offsets[0] = automaton->offsets[1] = 0;
+  automaton->deterministic = true;
+  return automaton;
+}
+
+Automaton* Automaton_retain(Automaton* automaton) {
+  if (automaton != NULL) ++automaton->references;
+  return automaton;
+}
+
+void Automaton_free(Automaton* automaton) {
+  if (automaton == NULL || 0 < --automaton->references) return;
+  __atomic_sub_fetch(&_liveBytes, automaton->footprint, __ATOMIC_RELAXED);
+  free(automaton->initialStates);
+  free(automaton->offsets);
+  free(automaton->symbols);
+  free(automaton->targets);
+  free(automaton->accepting);
+  free(automaton->sinkAlphabet);
+  free(automaton);
+}
+
+size_t Automaton_liveBytes() {
+  return __atomic_load_n(&_liveBytes, __ATOMIC_RELAXED);
+}
+
+size_t Automaton_peakBytes() {
+  return __atomic_load_n(&_peakBytes, __ATOMIC_RELAXED);
+}
+
+void Automaton_resetPeakBytes() {
+  __atomic_store_n(&_peakBytes, __atomic_load_n(&_liveBytes, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+}
+
+void Automaton_normalize(Automaton* automaton) {
+  uint64_t* buffer = NULL;
+  size_t capacity = 0;
+  bool deterministic = automaton->initialStateCount == 1;
+  for (uint32_t state = 0; state < automaton->stateCount; ++state) {
+    const uint32_t begin = automaton->offsets[state];
+    const uint32_t end = automaton->offsets[state + 1];
+    _sortRow(automaton, begin, end, &buffer, &capacity);
+    for (uint32_t k = begin + 1; deterministic && k < end; ++k) {
+      deterministic = automaton->symbols[k - 1] != automaton->symbols[k];
+    }
+    if (begin < end && automaton->symbols[end - 1] == EPSILON) deterministic = false;
+  }
+  free(buffer);
+  automaton->deterministic = deterministic;
+}
+
+Automaton* Automaton_reverse(const Automaton* automaton) {
+  if (automaton->acceptingSink) {
+    Automaton* complete = Automaton_materializeSink(automaton);
+    Automaton* reversed = Automaton_reverse(complete);
+    Automaton_free(complete);
+    return reversed;
+  }
+  const uint32_t stateCount = automaton->stateCount;
+  Automaton* reversed = Automaton_new(stateCount, automaton->transitionCount, Automaton_acceptingCount(automaton));
+  memset(reversed->offsets, 0, (1 + (size_t)stateCount) * sizeof(uint32_t));
+  for (uint32_t k = 0; k < automaton->transitionCount; ++k) {
+    ++reversed->offsets[automaton->targets[k] + 1];
+  }
+  for (uint32_t state = 0; state < stateCount; ++state) {
+    reversed->offsets[state + 1] += reversed->offsets[state];
+  }
+  uint32_t* next = safeMalloc((stateCount == 0 ? 1 : stateCount) * sizeof(uint32_t));
+  memcpy(next, reversed->offsets, stateCount * sizeof(uint32_t));
+  uint32_t initialCount = 0;
+  for (uint32_t state = 0; state < stateCount; ++state) {
+    if (Automaton_isAccepting(automaton, state)) reversed->initialStates[initialCount++] = state;
+    for (uint32_t k = automaton->offsets[state]; k < automaton->offsets[state + 1]; ++k) {
+      const uint32_t position = next[automaton->targets[k]]++;
+      reversed->symbols[position] = automaton->symbols[k];
+      reversed->targets[position] = state;
+    }
+  }
+  free(next);
+  for (uint32_t k = 0; k < automaton->initialStateCount; ++k) {
+    Bitset_set(reversed->accepting, automaton->initialStates[k]);
+  }
+  Automaton_normalize(reversed);
+  return reversed;
+}
+
+bool Automaton_hasEpsilons(const Automaton* automaton) {
+  for (uint32_t state = 0; state < automaton->stateCount; ++state) {
+    const uint32_t end = automaton->offsets[state + 1];
+    if (automaton->offsets[state] < end && automaton->symbols[end - 1] == EPSILON) return true;
+  }
+  return false;
+}
+
+Automaton* Automaton_concatenate(const Automaton* left, const Automaton* right) {
+  if (left->acceptingSink || right->acceptingSink) {
+    Automaton* completeLeft = Automaton_materializeSink(left);
+    Automaton* completeRight = Automaton_materializeSink(right);
+    Automaton* concatenation = Automaton_concatenate(completeLeft, completeRight);
+    Automaton_free(completeLeft);
+    Automaton_free(completeRight);
+    return concatenation;
+  }
+  // The states of `left`, then the ones of `right`, then the bridge.
+  const uint32_t shift = left->stateCount;
+  const uint32_t bridge = left->stateCount + right->stateCount;
+  const uint32_t acceptingCount = Automaton_acceptingCount(left);
+  const size_t transitionCount =
+    (size_t)left->transitionCount + right->transitionCount + acceptingCount + right->initialStateCount;
+  if (UINT32_MAX <= transitionCount || UINT32_MAX - 1 <= bridge) {
+    exitInvalidArgument(__func__, "the concatenation is too large");
+  }
+
+  Automaton* concatenation = Automaton_new(bridge + 1, (uint32_t)transitionCount, left->initialStateCount);
+  memcpy(concatenation->initialStates, left->initialStates, left->initialStateCount * sizeof(uint32_t));
+  uint32_t position = 0;
+  for (uint32_t state = 0; state < left->stateCount; ++state) {
+    concatenation->offsets[state] = position;
+    for (uint32_t k = left->offsets[state]; k < left->offsets[state + 1]; ++k) {
+      concatenation->symbols[position] = left->symbols[k];
+      concatenation->targets[position++] = left->targets[k];
+    }
+    if (Automaton_isAccepting(left, state)) {
+      concatenation->symbols[position] = EPSILON;
+      concatenation->targets[position++] = bridge;
+    }
+  }
+  for (uint32_t state = 0; state < right->stateCount; ++state) {
+    concatenation->offsets[shift + state] = position;
+    for (uint32_t k = right->offsets[state]; k < right->offsets[state + 1]; ++k) {
+      concatenation->symbols[position] = right->symbols[k];
+      concatenation->targets[position++] = shift + right->targets[k];
+    }
+    if (Automaton_isAccepting(right, state)) Bitset_set(concatenation->accepting, shift + state);
+  }
+  concatenation->offsets[bridge] = position;
+  for (uint32_t k = 0; k < right->initialStateCount; ++k) {
+    concatenation->symbols[position] = EPSILON;
+    concatenation->targets[position++] = shift + right->initialStates[k];
+  }
+  concatenation->offsets[bridge + 1] = position;
+  Automaton_normalize(concatenation);
+  return concatenation;
+}
+
+Automaton* Automaton_union(const Automaton* left, const Automaton* right) {
+  if (left->acceptingSink || right->acceptingSink) {
+    Automaton* completeLeft = Automaton_materializeSink(left);
+    Automaton* completeRight = Automaton_materializeSink(right);
+    Automaton* combined = Automaton_union(completeLeft, completeRight);
+    Automaton_free(completeLeft);
+    Automaton_free(completeRight);
+    return combined;
+  }
+  // The states of `left`, then the ones of `right`.
+  const uint32_t shift = left->stateCount;
+  const size_t stateCount = (size_t)left->stateCount + right->stateCount;
+  const size_t transitionCount = (size_t)left->transitionCount + right->transitionCount;
+  if (UINT32_MAX <= transitionCount || UINT32_MAX <= stateCount) {
+    exitInvalidArgument(__func__, "the union is too large");
+  }
+
+  Automaton* combined =
+    Automaton_new((uint32_t)stateCount, (uint32_t)transitionCount, left->initialStateCount + right->initialStateCount);
+  memcpy(combined->initialStates, left->initialStates, left->initialStateCount * sizeof(uint32_t));
+  for (uint32_t k = 0; k < right->initialStateCount; ++k) {
+    combined->initialStates[left->initialStateCount + k] = shift + right->initialStates[k];
+  }
+  memcpy(combined->offsets, left->offsets, (size_t)left->stateCount * sizeof(uint32_t));
+  memcpy(combined->symbols, left->symbols, left->transitionCount * sizeof(uint32_t));
+  memcpy(combined->targets, left->targets, left->transitionCount * sizeof(uint32_t));
+  for (uint32_t state = 0; state <= right->stateCount; ++state) {
+    combined->offsets[shift + state] = left->transitionCount + right->offsets[state];
+  }
+  memcpy(combined->symbols + left->transitionCount, right->symbols, right->transitionCount * sizeof(uint32_t));
+  for (uint32_t k = 0; k < right->transitionCount; ++k) {
+    combined->targets[left->transitionCount + k] = shift + right->targets[k];
+  }
+  for (uint32_t state = 0; state < left->stateCount; ++state) {
+    if (Automaton_isAccepting(left, state)) Bitset_set(combined->accepting, state);
+  }
+  for (uint32_t state = 0; state < right->stateCount; ++state) {
+    if (Automaton_isAccepting(right, state)) Bitset_set(combined->accepting, shift + state);
+  }
+  // Rows are copied already sorted, and with the initial states of both, the union is never deterministic.
+  return combined;
+}
+
+Automaton* Automaton_star(const Automaton* automaton) {
+  return _closure(automaton, true);
+}
+
+Automaton* Automaton_plus(const Automaton* automaton) {
+  return _closure(automaton, false);
+}
+
+bool Automaton_sinkReads(const Automaton* automaton, uint32_t symbol) {
+  return automaton->acceptingSink && _contains(automaton->sinkAlphabet, automaton->sinkAlphabetSize, symbol);
+}
+
+Automaton* Automaton_complement(const Automaton* dfa, const uint32_t* alphabet, uint32_t alphabetSize) {
+  if (!dfa->deterministic) exitInvalidArgument(__func__, "the complement needs a deterministic automaton");
+  if (dfa->acceptingSink && !_sameAlphabet(dfa, alphabet, alphabetSize)) {
+    Automaton* complete = Automaton_materializeSink(dfa);
+    Automaton* complement = Automaton_complement(complete, alphabet, alphabetSize);
+    Automaton_free(complete);
+    return complement;
+  }
+  if (dfa->initialStateCount == 0) {
+    Automaton* universal = Automaton_new(1, 0, 1);
+    universal->initialStates[0] = 0;
+    universal->offsets[0] = universal->offsets[1] = 0;
+    Bitset_set(universal->accepting, 0);
+    universal->deterministic = true;
+    _setSink(universal, true, alphabet, alphabetSize);
+    return universal;
+  }
+
+  // Words with a symbol out of the alphabet aren't in the complement, so their transitions are dropped.
+  uint32_t transitionCount = 0;
+  for (uint32_t k = 0; k < dfa->transitionCount; ++k) {
+    if (_contains(alphabet, alphabetSize, dfa->symbols[k])) ++transitionCount;
+  }
+  Automaton* complement = Automaton_new(dfa->stateCount, transitionCount, 1);
+  complement->initialStates[0] = dfa->initialStates[0];
+  uint32_t position = 0;
+  for (uint32_t state = 0; state < dfa->stateCount; ++state) {
+    complement->offsets[state] = position;
+    for (uint32_t k = dfa->offsets[state]; k < dfa->offsets[state + 1]; ++k) {
+      if (transitionCount < dfa->transitionCount && !_contains(alphabet, alphabetSize, dfa->symbols[k])) continue;
+      complement->symbols[position] = dfa->symbols[k];
+      complement->targets[position++] = dfa->targets[k];
+    }
+    if (!Automaton_isAccepting(dfa, state)) Bitset_set(complement->accepting, state);
+  }
+  complement->offsets[dfa->stateCount] = position;
+  complement->deterministic = true;
+  _setSink(complement, !dfa->acceptingSink, alphabet, alphabetSize);
+  return complement;
+}
+
+Automaton* Automaton_materializeSink(const Automaton* automaton) {
+  if (!automaton->acceptingSink) return Automaton_copy(automaton);
+  const uint32_t* alphabet = automaton->sinkAlphabet;
+  const uint32_t alphabetSize = automaton->sinkAlphabetSize;
+  const uint32_t sink = automaton->stateCount;
+  size_t transitionCount = alphabetSize;
+  for (uint32_t state = 0; state < automaton->stateCount; ++state) {
+    uint32_t present = 0;
+    for (uint32_t k = automaton->offsets[state]; k < automaton->offsets[state + 1]; ++k) {
+      if (_contains(alphabet, alphabetSize, automaton->symbols[k])) ++present;
+    }
+    transitionCount += automaton->offsets[state + 1] - automaton->offsets[state] + alphabetSize - present;
+  }
+  if (UINT32_MAX <= transitionCount) exitInvalidArgument(__func__, "too many transitions to materialize the sink");
+
+  Automaton* complete = Automaton_new(sink + 1, (uint32_t)transitionCount, automaton->initialStateCount);
+  memcpy(complete->initialStates, automaton->initialStates, automaton->initialStateCount * sizeof(uint32_t));
+  uint32_t position = 0;
+  for (uint32_t state = 0; state <= sink; ++state) {
+    complete->offsets[state] = position;
+    // Merges the row with the alphabet, sending the symbols the row doesn't read to the sink.
+    uint32_t k = state == sink ? 0 : automaton->offsets[state];
+    const uint32_t end = state == sink ? 0 : automaton->offsets[state + 1];
+    uint32_t a = 0;
+    while (k < end || a < alphabetSize) {
+      if (a == alphabetSize || (k < end && automaton->symbols[k] <= alphabet[a])) {
+        if (a < alphabetSize && automaton->symbols[k] == alphabet[a]) ++a;
+        complete->symbols[position] = automaton->symbols[k];
+        complete->targets[position++] = automaton->targets[k++];
+      } else {
+        complete->symbols[position] = alphabet[a++];
+        complete->targets[position++] = sink;
+      }
+    }
+    if (state == sink || Automaton_isAccepting(automaton, state)) Bitset_set(complete->accepting, state);
+  }
+  complete->offsets[sink + 1] = position;
+  Automaton_normalize(complete);
+  return complete;
+}
+
+uint32_t Automaton_acceptingCount(const Automaton* automaton) {
+  return (uint32_t)Bitset_count(automaton->accepting, automaton->stateCount);
+}
+
+char* Automaton_toString(const Automaton* automaton) {
+  if (automaton->acceptingSink) {
+    return safeAsprintf(
+      "Automaton{ states: %u, transitions: %u, initial: %u, accepting: %u, %s, accepting sink over %u symbols }",
+      automaton->stateCount, automaton->transitionCount, automaton->initialStateCount,
+      Automaton_acceptingCount(automaton), automaton->deterministic ? "deterministic" : "non-deterministic",
+      automaton->sinkAlphabetSize
+    );
+  }
+  return safeAsprintf(
+    "Automaton{ states: %u, transitions: %u, initial: %u, accepting: %u, %s }", automaton->stateCount,
+    automaton->transitionCount, automaton->initialStateCount, Automaton_acceptingCount(automaton),
+    automaton->deterministic ? "deterministic" : "non-deterministic"
+  );
+}
@@ -0,0 +1,178 @@
+#ifndef AUTOMATON_HEADER
+#define AUTOMATON_HEADER
+
+#include "../../shared/Bitset.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * A finite automaton in compressed-sparse-row (CSR) layout: the transitions
+ * leaving state `q` are `symbols[k] -> targets[k]` for `k` in
+ * `offsets[q]..offsets[q + 1]`, sorted by symbol (an interned id of the
+ * global alphabet). Every automaton operation works on this layout.
+ *
+ * Transitions labeled with `EPSILON` read nothing. They sort after every
+ * symbol, so they are the tail of each row.
+ *
+ * An automaton is deterministic when it has a single initial state, no
+ * epsilon transitions, and no state has two transitions with the same symbol. It may still be partial:
+ * missing transitions go to an implicit rejecting state.
+ *
+ * A complemented DFA flips that state into an implicit accepting sink
+ * instead: a missing transition on a symbol of `sinkAlphabet` leads to a
+ * state that accepts every word over it, and one on any other symbol still
+ * rejects. The sink is never built, so complementing doesn't depend on the
+ * size of the alphabet.
+ */
+/** The label of the transitions that read no symbol. */
+#define EPSILON UINT32_MAX
+
+typedef struct {
+  uint32_t stateCount;
+  uint32_t transitionCount;
+  uint32_t initialStateCount;
+  uint32_t* initialStates;
+  uint32_t* offsets;
+  uint32_t* symbols;
+  uint32_t* targets;
+  Bitset accepting;
+  bool deterministic;
+  bool acceptingSink;
+  // The sorted symbols the accepting sink reads (NULL without one).
+  uint32_t* sinkAlphabet;
+  uint32_t sinkAlphabetSize;
+  // The holders of the automaton, and the bytes it was allocated with.
+  uint32_t references;
+  size_t footprint;
+} Automaton;
+
+/**
+ * Allocates an automaton with room for the given number of states,
+ * transitions and initial states. Every array is left uninitialized, except
+ * for the accepting states (none).
+ *
+ * Automata are reference-counted: the new one has a single holder, each
+ * `Automaton_retain` adds one, and each `Automaton_free` releases one (the
+ * automaton is freed with the last). A shared automaton must not be
+ * modified. Retaining and releasing aren't thread-safe.
+ */
+Automaton* Automaton_new(uint32_t stateCount, uint32_t transitionCount, uint32_t initialStateCount);
+Automaton* Automaton_copy(const Automaton* automaton);
+
+/**
+ * @return The minimal automaton of the empty language: a single initial
+ *         state, which rejects.
+ */
+Automaton* Automaton_empty();
+
+/**
+ * Shares an automaton with a new holder, instead of copying it.
+ *
+ * @return The same automaton.
+ */
+Automaton* Automaton_retain(Automaton* automaton);
+void Automaton_free(Automaton* automaton);
+
+/**
+ * @return The bytes held by every automaton alive.
+ */
+size_t Automaton_liveBytes();
+
+/**
+ * @return The most bytes held at once by the automata alive, since the last
+ *         `Automaton_resetPeakBytes` (or ever).
+ */
+size_t Automaton_peakBytes();
+
+/**
+ * Starts measuring the peak again from the bytes held now.
+ */
+void Automaton_resetPeakBytes();
+
+static inline bool Automaton_isAccepting(const Automaton* automaton, uint32_t state) {
+  return Bitset_test(automaton->accepting, state);
+}
+
+/**
+ * Sorts the transitions of every state by symbol (and target), and
+ * recomputes whether the automaton is deterministic. Builders that emit
+ * transitions in any order call it once, at the end.
+ */
+void Automaton_normalize(Automaton* automaton);
+
+/**
+ * @return A new automaton for the reversed language: every transition points
+ *         the other way, and the initial and accepting states are swapped.
+ */
+Automaton* Automaton_reverse(const Automaton* automaton);
+
+/**
+ * @return Whether the automaton has epsilon transitions.
+ */
+bool Automaton_hasEpsilons(const Automaton* automaton);
+
+/**
+ * @return A new automaton for the concatenation of both languages: `left`
+ *         and `right` side by side, with epsilon transitions from the
+ *         accepting states of `left` to the initial states of `right`,
+ *         through a single bridge state.
+ */
+Automaton* Automaton_concatenate(const Automaton* left, const Automaton* right);
+
+/**
+ * @return A new (nondeterministic) automaton for the union of both
+ *         languages: `left` and `right` side by side, with the initial
+ *         states of both.
+ */
+Automaton* Automaton_union(const Automaton* left, const Automaton* right);
+
+/**
+ * @return A new automaton for the Kleene closure of the language: a new
+ *         initial and accepting state, with epsilon transitions to the
+ *         initial states of the automaton, and from its accepting states
+ *         back to the new one.
+ */
+Automaton* Automaton_star(const Automaton* automaton);
+
+/**
+ * @return A new automaton for the concatenations of one or more words of the
+ *         language: as `Automaton_star`, but the new state doesn't accept.
+ */
+Automaton* Automaton_plus(const Automaton* automaton);
+
+/**
+ * @return Whether a missing transition on `symbol` leads to the accepting
+ *         sink of the automaton (if it has one).
+ */
+bool Automaton_sinkReads(const Automaton* automaton, uint32_t symbol);
+
+/**
+ * Builds the complement of the language of a DFA with respect to the words
+ * over `alphabet` (sorted), by swapping its accepting and rejecting states,
+ * the implicit one included. Only the existing states are touched, so the
+ * complement of a complement gives the original DFA back.
+ *
+ * @return A heap-allocated deterministic automaton.
+ */
+Automaton* Automaton_complement(const Automaton* dfa, const uint32_t* alphabet, uint32_t alphabetSize);
+
+/**
+ * @return A copy of an automaton with an accepting sink where the sink is an
+ *         explicit state (the last one), for the operations that can't
+ *         follow it implicitly. It costs a transition per missing symbol of
+ *         every state.
+ */
+Automaton* Automaton_materializeSink(const Automaton* automaton);
+
+/**
+ * @return The number of accepting states.
+ */
+uint32_t Automaton_acceptingCount(const Automaton* automaton);
+
+/**
+ * @return A heap-allocated summary of the automaton (sizes, not contents).
+ */
+char* Automaton_toString(const Automaton* automaton);
+
+#endif
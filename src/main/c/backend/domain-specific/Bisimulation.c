@@ -0,0 +1,267 @@
+#include "Bisimulation.h"
+#include "../../shared/Bitset.h"
+#include "../../shared/Logger.h"
+#include "../../shared/utils.h"
+#include "Automaton.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* MODULE INTERNAL STATE */
+
+#define EMPTY_SLOT UINT32_MAX
+
+static Logger* _logger = NULL;
+
+void initializeBisimulationModule() {
+  _logger = createLogger("Bisimulation");
+}
+
+void shutdownBisimulationModule() {
+  if (_logger != NULL) {
+    destroyLogger(_logger);
+  }
+}
+
+/**
+ * The state of a forward refinement. The signature of state `q` is the
+ * sorted, repetition-free `signatures[signatureOffsets[q]..signatureOffsets[q + 1]]`,
+ * each one a symbol (high half) and the class of a target (low half).
+ * Classes are numbered in the order their first state appears, so a round
+ * that doesn't split any class numbers them as the previous one did.
+ */
+typedef struct {
+  const Automaton* automaton;
+  uint32_t* classes;
+  uint32_t* next;
+  uint32_t classCount;
+  // The first state of each class.
+  uint32_t* representatives;
+  uint64_t* signatures;
+  uint32_t* signatureOffsets;
+  uint64_t* hashes;
+  uint32_t* slots;
+  uint32_t slotCapacity;
+} Refinement;
+
+/* PRIVATE FUNCTIONS */
+
+static inline uint64_t _mix(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+static int _comparePairs(const void* left, const void* right) {
+  const uint64_t a = *(const uint64_t*)left;
+  const uint64_t b = *(const uint64_t*)right;
+  return (a > b) - (a < b);
+}
+
+static bool _sameSignature(const Refinement* refinement, uint32_t state, uint32_t other) {
+  if (refinement->hashes[state] != refinement->hashes[other] ||
+      refinement->classes[state] != refinement->classes[other]) {
+    return false;
+  }
+  const uint32_t begin = refinement->signatureOffsets[state];
+  const uint32_t length = refinement->signatureOffsets[state + 1] - begin;
+  const uint32_t otherBegin = refinement->signatureOffsets[other];
+  return length == refinement->signatureOffsets[other + 1] - otherBegin &&
+         memcmp(refinement->signatures + begin, refinement->signatures + otherBegin, length * sizeof(uint64_t)) == 0;
+}
+
+/**
+ * Computes the signature of every state under the current classes, and
+ * groups the states by it.
+ *
+ * @return The number of classes after the round.
+ */
+static uint32_t _refineOnce(Refinement* refinement) {
+  const Automaton* automaton = refinement->automaton;
+  uint32_t position = 0;
+  for (uint32_t state = 0; state < automaton->stateCount; ++state) {
+    const uint32_t begin = position;
+    refinement->signatureOffsets[state] = begin;
+    for (uint32_t k = automaton->offsets[state]; k < automaton->offsets[state + 1]; ++k) {
+      refinement->signatures[position++] =
+        (uint64_t)automaton->symbols[k] << 32 | refinement->classes[automaton->targets[k]];
+    }
+    // Rows are sorted by symbol, but not by the classes of their targets.
+    if (1 < position - begin) {
+      qsort(refinement->signatures + begin, position - begin, sizeof(uint64_t), _comparePairs);
+      uint32_t kept = begin + 1;
+      for (uint32_t k = begin + 1; k < position; ++k) {
+        if (refinement->signatures[k] != refinement->signatures[kept - 1]) {
+          refinement->signatures[kept++] = refinement->signatures[k];
+        }
+      }
+      position = kept;
+    }
+    uint64_t hash = _mix(refinement->classes[state]);
+    for (uint32_t k = begin; k < position; ++k) {
+      hash = _mix(hash ^ refinement->signatures[k]);
+    }
+    refinement->hashes[state] = hash;
+  }
+  refinement->signatureOffsets[automaton->stateCount] = position;
+
+  memset(refinement->slots, 0xFF, refinement->slotCapacity * sizeof(uint32_t));
+  const uint32_t mask = refinement->slotCapacity - 1;
+  uint32_t count = 0;
+  for (uint32_t state = 0; state < automaton->stateCount; ++state) {
+    uint32_t slot = (uint32_t)refinement->hashes[state] & mask;
+    while (refinement->slots[slot] != EMPTY_SLOT && !_sameSignature(refinement, state, refinement->slots[slot])) {
+      slot = (slot + 1) & mask;
+    }
+    if (refinement->slots[slot] == EMPTY_SLOT) {
+      refinement->slots[slot] = state;
+      refinement->representatives[count] = state;
+      refinement->next[state] = count++;
+    } else {
+      refinement->next[state] = refinement->next[refinement->slots[slot]];
+    }
+  }
+  uint32_t* swap = refinement->classes;
+  refinement->classes = refinement->next;
+  refinement->next = swap;
+  return count;
+}
+
+/**
+ * @return The quotient of the automaton by its refined classes: a state per
+ *         class, with the signature of its representative as its row.
+ */
+static Automaton* _quotient(const Refinement* refinement) {
+  const Automaton* automaton = refinement->automaton;
+  uint32_t transitionCount = 0;
+  for (uint32_t c = 0; c < refinement->classCount; ++c) {
+    const uint32_t representative = refinement->representatives[c];
+    transitionCount +=
+      refinement->signatureOffsets[representative + 1] - refinement->signatureOffsets[representative];
+  }
+  Automaton* quotient = Automaton_new(refinement->classCount, transitionCount, automaton->initialStateCount);
+  uint32_t position = 0;
+  for (uint32_t c = 0; c < refinement->classCount; ++c) {
+    const uint32_t representative = refinement->representatives[c];
+    quotient->offsets[c] = position;
+    for (uint32_t k = refinement->signatureOffsets[representative];
+         k < refinement->signatureOffsets[representative + 1]; ++k) {
+      quotient->symbols[position] = (uint32_t)(refinement->signatures[k] >> 32);
+      quotient->targets[position++] = (uint32_t)refinement->signatures[k];
+    }
+    if (Automaton_isAccepting(automaton, representative)) Bitset_set(quotient->accepting, c);
+  }
+  quotient->offsets[refinement->classCount] = position;
+  Bitset initial = Bitset_new(refinement->classCount);
+  uint32_t initialCount = 0;
+  for (uint32_t k = 0; k < automaton->initialStateCount; ++k) {
+    const uint32_t c = refinement->classes[automaton->initialStates[k]];
+    if (Bitset_test(initial, c)) continue;
+    Bitset_set(initial, c);
+    quotient->initialStates[initialCount++] = c;
+  }
+  quotient->initialStateCount = initialCount;
+  free(initial);
+  Automaton_normalize(quotient);
+  return quotient;
+}
+
+/**
+ * @return The quotient of the automaton by its forward bisimulation, or NULL
+ *         if no two states are bisimilar.
+ */
+static Automaton* _mergeForward(const Automaton* automaton, uint32_t* rounds) {
+  const uint32_t stateCount = automaton->stateCount;
+  if (stateCount < 2) return NULL;
+  uint32_t slotCapacity = 64;
+  while (slotCapacity < 2 * stateCount) slotCapacity *= 2;
+  Refinement refinement = {
+    .automaton = automaton,
+    .classes = safeMalloc(stateCount * sizeof(uint32_t)),
+    .next = safeMalloc(stateCount * sizeof(uint32_t)),
+    .representatives = safeMalloc(stateCount * sizeof(uint32_t)),
+    .signatures = safeMalloc((automaton->transitionCount == 0 ? 1 : automaton->transitionCount) * sizeof(uint64_t)),
+    .signatureOffsets = safeMalloc((1 + (size_t)stateCount) * sizeof(uint32_t)),
+    .hashes = safeMalloc(stateCount * sizeof(uint64_t)),
+    .slots = safeMalloc(slotCapacity * sizeof(uint32_t)),
+    .slotCapacity = slotCapacity,
+  };
+  // The accepting states and the rejecting ones start apart, the class of state 0 first.
+  const bool first = Automaton_isAccepting(automaton, 0);
+  refinement.classCount = 1;
+  for (uint32_t state = 0; state < stateCount; ++state) {
+    refinement.classes[state] = Automaton_isAccepting(automaton, state) != first;
+    if (refinement.classes[state] != 0) refinement.classCount = 2;
+  }
+  for (;;) {
+    ++*rounds;
+    const uint32_t count = _refineOnce(&refinement);
+    if (count == refinement.classCount) break;
+    refinement.classCount = count;
+  }
+
+  Automaton* quotient = refinement.classCount < stateCount ? _quotient(&refinement) : NULL;
+  free(refinement.classes);
+  free(refinement.next);
+  free(refinement.representatives);
+  free(refinement.signatures);
+  free(refinement.signatureOffsets);
+  free(refinement.hashes);
+  free(refinement.slots);
+  return quotient;
+}
+
+/**
+ * @return The quotient of the automaton by its backward bisimulation, or
+ *         NULL if no two states are bisimilar.
+ */
+static Automaton* _mergeBackward(const Automaton* automaton, uint32_t* rounds) {
+  Automaton* reversed = Automaton_reverse(automaton);
+  Automaton* merged = _mergeForward(reversed, rounds);
+  Automaton_free(reversed);
+  if (merged == NULL) return NULL;
+  Automaton* quotient = Automaton_reverse(merged);
+  Automaton_free(merged);
+  return quotient;
+}
+
+/* PUBLIC FUNCTIONS */
+
+Automaton* reduceByBisimulation(const Automaton* nfa, BisimulationReport* report) {
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  Automaton* reduced = NULL;
+  uint32_t rounds = 0;
+  // A quotient by either bisimulation has no two states bisimilar in the same direction, so it only takes the other.
+  uint32_t idle = 0;
+  for (bool forward = true; idle < 2; forward = !forward) {
+    const Automaton* current = reduced == NULL ? nfa : reduced;
+    Automaton* merged = forward ? _mergeForward(current, &rounds) : _mergeBackward(current, &rounds);
+    if (merged == NULL) {
+      ++idle;
+      continue;
+    }
+    idle = 1;
+    Automaton_free(reduced);
+    reduced = merged;
+  }
+
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  const double milliseconds = 1e3 * (double)(end.tv_sec - start.tv_sec) + 1e-6 * (double)(end.tv_nsec - start.tv_nsec);
+  const uint32_t statesAfter = reduced == NULL ? nfa->stateCount : reduced->stateCount;
+  logDebugging(
+    _logger, "Reduced %u NFA states to %u by bisimulation (%u refinement rounds) in %.3f ms.", nfa->stateCount,
+    statesAfter, rounds, milliseconds
+  );
+  if (report != NULL) {
+    *report = (BisimulationReport){
+      .statesBefore = nfa->stateCount, .statesAfter = statesAfter, .milliseconds = milliseconds
+    };
+  }
+  return reduced;
+}
@@ -0,0 +1,45 @@
+#ifndef BISIMULATION_HEADER
+#define BISIMULATION_HEADER
+
+#include "Automaton.h"
+#include <stdint.h>
+
+/** Initialize module's internal state. */
+void initializeBisimulationModule();
+
+/** Shutdown module's internal state. */
+void shutdownBisimulationModule();
+
+/**
+ * What a reduction achieved.
+ */
+typedef struct {
+  uint32_t statesBefore;
+  uint32_t statesAfter;
+  double milliseconds;
+} BisimulationReport;
+
+/**
+ * Merges the states of an NFA (without epsilon transitions nor accepting
+ * sink) that can't be told apart, so the subset construction starts from a
+ * smaller automaton:
+ *
+ *   - Two states are forward bisimilar when both accept or both reject, and
+ *     for every symbol their transitions reach the same classes of states.
+ *   - Two states are backward bisimilar when both are initial or neither is,
+ *     and for every symbol the transitions that enter them leave the same
+ *     classes of states (forward bisimulation on the reversed automaton).
+ *
+ * Both equivalences are computed by partition refinement, in rounds: the
+ * states are grouped by their signature (their class, and the sorted
+ * symbols and classes of their transitions) until a round doesn't split any
+ * class. The quotient by either one has the same language, so they're
+ * applied in turns until neither merges any state.
+ *
+ * @param report If not NULL, receives the state counts before and after.
+ * @return A heap-allocated automaton, or NULL if no two states are
+ *         bisimilar.
+ */
+Automaton* reduceByBisimulation(const Automaton* nfa, BisimulationReport* report);
+
+#endif
@@ -0,0 +1,844 @@
+#include "Determinization.h"
+#include "../../shared/Bitset.h"
+#include "../../shared/Environment.h"
+#include "../../shared/Logger.h"
+#include "../../shared/utils.h"
+#include "Automaton.h"
+#include "Bisimulation.h"
+#include "EpsilonRemoval.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* MODULE INTERNAL STATE */
+
+#define EMPTY_SLOT UINT32_MAX
+#define MAXIMUM_WORKER_THREADS 64
+// The shared subsets are split among 2^SHARD_BITS independently locked shards, by hash.
+#define SHARD_BITS 6
+#define SHARD_COUNT (1 << SHARD_BITS)
+// Shared subsets are stored in blocks of (at least) this many words, which never move once allocated.
+#define POOL_BLOCK_SIZE (1 << 18)
+
+static Logger* _logger = NULL;
+static size_t _workerThreads = 1;
+static uint32_t _parallelThreshold = 65536;
+
+void initializeDeterminizationModule() {
+  _logger = createLogger("Determinization");
+  long long threads = getIntegerOrDefault("WORKER_THREADS", 0);
+  if (threads <= 0) threads = sysconf(_SC_NPROCESSORS_ONLN);
+  if (threads < 1) threads = 1;
+  _workerThreads = threads < MAXIMUM_WORKER_THREADS ? (size_t)threads : MAXIMUM_WORKER_THREADS;
+  const long long threshold = getIntegerOrDefault("PARALLEL_DETERMINIZATION_THRESHOLD", 65536);
+  if (threshold < 0 || UINT32_MAX < threshold) {
+    logWarning(_logger, "Invalid parallel determinization threshold %lld, using 65536.", threshold);
+    _parallelThreshold = 65536;
+  } else {
+    _parallelThreshold = (uint32_t)threshold;
+  }
+}
+
+void shutdownDeterminizationModule() {
+  if (_logger != NULL) {
+    destroyLogger(_logger);
+  }
+}
+
+/**
+ * Scratch space to expand a subset: the (symbol, target) pairs leaving it,
+ * the elements of one of its successors, and their encoding.
+ */
+typedef struct {
+  uint64_t* pairs;
+  size_t pairCapacity;
+  uint32_t* encoded;
+  size_t encodedCapacity;
+  uint32_t* elements;
+  size_t elementCapacity;
+} Scratch;
+
+/**
+ * A DFA state: a set of NFA states, stored in the pool from `offset` on, as
+ * `length` words. Dense subsets are bitsets of 32-bit words, and sparse ones
+ * are sorted arrays of states, so the encoding only depends on the contents.
+ */
+typedef struct {
+  size_t offset;
+  uint32_t length;
+  uint32_t count;
+  uint32_t hash;
+  bool dense;
+  bool accepting;
+} Subset;
+
+typedef struct {
+  const Automaton* nfa;
+  uint32_t denseLength;
+  // Every subset found, in discovery order (which is also the order they're expanded in).
+  Subset* subsets;
+  uint32_t subsetCount;
+  uint32_t subsetCapacity;
+  uint32_t* pool;
+  size_t poolSize;
+  size_t poolCapacity;
+  // Open-addressing index of the subsets, by hash.
+  uint32_t* slots;
+  uint32_t slotCapacity;
+  // The DFA built so far, in CSR layout.
+  uint32_t* offsets;
+  size_t offsetCapacity;
+  uint32_t* symbols;
+  uint32_t* targets;
+  uint32_t transitionCount;
+  size_t transitionCapacity;
+  Scratch scratch;
+  size_t peakBytes;
+} Determinizer;
+
+/* PRIVATE FUNCTIONS */
+
+static size_t _heldBytes(const Determinizer* determinizer) {
+  const Scratch* scratch = &determinizer->scratch;
+  return determinizer->subsetCapacity * sizeof(Subset) + determinizer->poolCapacity * sizeof(uint32_t) +
+         determinizer->slotCapacity * sizeof(uint32_t) + determinizer->offsetCapacity * sizeof(uint32_t) +
+         2 * determinizer->transitionCapacity * sizeof(uint32_t) + scratch->pairCapacity * sizeof(uint64_t) +
+         (scratch->encodedCapacity + scratch->elementCapacity) * sizeof(uint32_t);
+}
+
+static void _updatePeak(Determinizer* determinizer) {
+  const size_t bytes = _heldBytes(determinizer);
+  if (determinizer->peakBytes < bytes) determinizer->peakBytes = bytes;
+}
+
+/**
+ * The hash of a subset is the sum of the mixes of its elements, so it can be
+ * computed while the elements are gathered, in any order.
+ */
+static inline uint64_t _mix(uint32_t state) {
+  uint64_t x = (uint64_t)state + 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+static inline uint32_t _finish(uint64_t sum, uint32_t count) {
+  const uint64_t hash = _mix((uint32_t)(sum ^ (sum >> 32)) ^ count);
+  return (uint32_t)(hash ^ (hash >> 32));
+}
+
+/**
+ * Encodes the sorted, duplicate-free `elements` into the scratch buffer, as a
+ * bitset of `denseLength` words if that's smaller.
+ *
+ * @return `true` if the encoding is dense.
+ */
+static bool _encode(
+  Scratch* scratch, uint32_t denseLength, const uint32_t* elements, uint32_t count, uint32_t* length
+) {
+  const bool dense = denseLength < count;
+  *length = dense ? denseLength : count;
+  scratch->encoded = safeReserve(scratch->encoded, &scratch->encodedCapacity, *length, sizeof(uint32_t));
+  if (dense) {
+    memset(scratch->encoded, 0, *length * sizeof(uint32_t));
+    for (uint32_t k = 0; k < count; ++k) {
+      scratch->encoded[elements[k] >> 5] |= UINT32_C(1) << (elements[k] & 31);
+    }
+  } else if (0 < count) {
+    memcpy(scratch->encoded, elements, count * sizeof(uint32_t));
+  }
+  return dense;
+}
+
+static void _growSlots(Determinizer* determinizer) {
+  const uint32_t capacity = determinizer->slotCapacity == 0 ? 64 : 2 * determinizer->slotCapacity;
+  uint32_t* slots = safeMalloc(capacity * sizeof(uint32_t));
+  memset(slots, 0xFF, capacity * sizeof(uint32_t));
+  for (uint32_t k = 0; k < determinizer->subsetCount; ++k) {
+    uint32_t slot = determinizer->subsets[k].hash & (capacity - 1);
+    while (slots[slot] != EMPTY_SLOT) slot = (slot + 1) & (capacity - 1);
+    slots[slot] = k;
+  }
+  free(determinizer->slots);
+  determinizer->slots = slots;
+  determinizer->slotCapacity = capacity;
+}
+
+/**
+ * Finds the subset made of the sorted, duplicate-free `elements`, adding it
+ * if it's new.
+ *
+ * @return The index of the subset (its DFA state).
+ */
+static uint32_t _intern(Determinizer* determinizer, const uint32_t* elements, uint32_t count, uint64_t sum) {
+  const uint32_t hash = _finish(sum, count);
+  uint32_t length;
+  const bool dense = _encode(&determinizer->scratch, determinizer->denseLength, elements, count, &length);
+  const uint32_t* encoded = determinizer->scratch.encoded;
+  if (determinizer->slotCapacity < 2 * (determinizer->subsetCount + 1)) _growSlots(determinizer);
+  const uint32_t mask = determinizer->slotCapacity - 1;
+  uint32_t slot = hash & mask;
+  for (; determinizer->slots[slot] != EMPTY_SLOT; slot = (slot + 1) & mask) {
+    const Subset* other = &determinizer->subsets[determinizer->slots[slot]];
+    if (other->hash == hash && other->count == count && other->dense == dense &&
+        memcmp(determinizer->pool + other->offset, encoded, length * sizeof(uint32_t)) == 0) {
+      return determinizer->slots[slot];
+    }
+  }
+
+  const uint32_t id = determinizer->subsetCount++;
+  size_t capacity = determinizer->subsetCapacity;
+  determinizer->subsets = safeReserve(determinizer->subsets, &capacity, determinizer->subsetCount, sizeof(Subset));
+  determinizer->subsetCapacity = (uint32_t)capacity;
+  determinizer->pool =
+    safeReserve(determinizer->pool, &determinizer->poolCapacity, determinizer->poolSize + length, sizeof(uint32_t));
+  if (0 < length) memcpy(determinizer->pool + determinizer->poolSize, encoded, length * sizeof(uint32_t));
+  bool accepting = false;
+  for (uint32_t k = 0; !accepting && k < count; ++k) {
+    accepting = Automaton_isAccepting(determinizer->nfa, elements[k]);
+  }
+  determinizer->subsets[id] = (Subset){
+    .offset = determinizer->poolSize,
+    .length = length,
+    .count = count,
+    .hash = hash,
+    .dense = dense,
+    .accepting = accepting,
+  };
+  determinizer->poolSize += length;
+  determinizer->slots[slot] = id;
+  _updatePeak(determinizer);
+  return id;
+}
+
+static int _comparePairs(const void* left, const void* right) {
+  const uint64_t a = *(const uint64_t*)left;
+  const uint64_t b = *(const uint64_t*)right;
+  return (a > b) - (a < b);
+}
+
+static void _gatherState(Scratch* scratch, const Automaton* nfa, uint32_t state, size_t* count) {
+  const uint32_t begin = nfa->offsets[state];
+  const uint32_t end = nfa->offsets[state + 1];
+  scratch->pairs = safeReserve(scratch->pairs, &scratch->pairCapacity, *count + (end - begin), sizeof(uint64_t));
+  for (uint32_t k = begin; k < end; ++k) {
+    scratch->pairs[(*count)++] = (uint64_t)nfa->symbols[k] << 32 | nfa->targets[k];
+  }
+}
+
+/**
+ * Gathers every transition leaving the NFA states of an encoded subset, as
+ * sorted `symbol << 32 | target` pairs.
+ *
+ * @return The number of pairs.
+ */
+static size_t _gatherPairs(Scratch* scratch, const Automaton* nfa, const uint32_t* words, uint32_t length, bool dense) {
+  size_t count = 0;
+  for (uint32_t k = 0; k < length; ++k) {
+    if (!dense) {
+      _gatherState(scratch, nfa, words[k], &count);
+      continue;
+    }
+    for (uint32_t bits = words[k]; bits != 0; bits &= bits - 1) {
+      _gatherState(scratch, nfa, 32 * k + (uint32_t)__builtin_ctz(bits), &count);
+    }
+  }
+  if (1 < count) qsort(scratch->pairs, count, sizeof(uint64_t), _comparePairs);
+  return count;
+}
+
+/**
+ * Gathers the elements of the successor with the symbol of the pair at
+ * `*next`, leaving `*next` at the first pair with another symbol.
+ *
+ * @return The number of elements, which the scratch buffer receives sorted.
+ */
+static uint32_t _gatherSuccessor(Scratch* scratch, size_t pairCount, size_t* next, uint32_t* symbol, uint64_t* sum) {
+  size_t k = *next;
+  *symbol = (uint32_t)(scratch->pairs[k] >> 32);
+  uint32_t count = 0;
+  *sum = 0;
+  for (; k < pairCount && (uint32_t)(scratch->pairs[k] >> 32) == *symbol; ++k) {
+    const uint32_t target = (uint32_t)scratch->pairs[k];
+    if (0 < count && scratch->elements[count - 1] == target) continue;
+    scratch->elements = safeReserve(scratch->elements, &scratch->elementCapacity, count + 1, sizeof(uint32_t));
+    scratch->elements[count++] = target;
+    *sum += _mix(target);
+  }
+  *next = k;
+  return count;
+}
+
+static void _addTransition(Determinizer* determinizer, uint32_t symbol, uint32_t target) {
+  if (determinizer->transitionCount == determinizer->transitionCapacity) {
+    determinizer->transitionCapacity = determinizer->transitionCount == 0 ? 64 : 2 * determinizer->transitionCount;
+    determinizer->symbols = realloc(determinizer->symbols, determinizer->transitionCapacity * sizeof(uint32_t));
+    determinizer->targets = realloc(determinizer->targets, determinizer->transitionCapacity * sizeof(uint32_t));
+    if (determinizer->symbols == NULL || determinizer->targets == NULL) exitWithPerror(__func__, "realloc error");
+  }
+  determinizer->symbols[determinizer->transitionCount] = symbol;
+  determinizer->targets[determinizer->transitionCount++] = target;
+}
+
+/**
+ * Computes the successors of a subset, one per symbol.
+ */
+static void _expand(Determinizer* determinizer, uint32_t id) {
+  const Subset subset = determinizer->subsets[id];
+  Scratch* scratch = &determinizer->scratch;
+  const size_t pairCount =
+    _gatherPairs(scratch, determinizer->nfa, determinizer->pool + subset.offset, subset.length, subset.dense);
+  determinizer->offsets = safeReserve(determinizer->offsets, &determinizer->offsetCapacity, id + 2, sizeof(uint32_t));
+  determinizer->offsets[id] = determinizer->transitionCount;
+  for (size_t k = 0; k < pairCount;) {
+    uint32_t symbol;
+    uint64_t sum;
+    const uint32_t count = _gatherSuccessor(scratch, pairCount, &k, &symbol, &sum);
+    _addTransition(determinizer, symbol, _intern(determinizer, scratch->elements, count, sum));
+  }
+  _updatePeak(determinizer);
+}
+
+static int _compareStates(const void* left, const void* right) {
+  const uint32_t a = *(const uint32_t*)left;
+  const uint32_t b = *(const uint32_t*)right;
+  return (a > b) - (a < b);
+}
+
+static void _freeScratch(Scratch* scratch) {
+  free(scratch->pairs);
+  free(scratch->encoded);
+  free(scratch->elements);
+}
+
+static void _freeDeterminizer(Determinizer* determinizer) {
+  free(determinizer->subsets);
+  free(determinizer->pool);
+  free(determinizer->slots);
+  free(determinizer->offsets);
+  free(determinizer->symbols);
+  free(determinizer->targets);
+  _freeScratch(&determinizer->scratch);
+}
+
+/**
+ * Gathers the initial subset into the scratch buffer. Unlike the ones built
+ * from transitions, it may have repeated states.
+ *
+ * @return The number of elements.
+ */
+static uint32_t _gatherInitial(Scratch* scratch, const Automaton* nfa, uint64_t* sum) {
+  uint32_t count = 0;
+  *sum = 0;
+  const size_t capacity = (size_t)nfa->initialStateCount + 1;
+  scratch->elements = safeReserve(scratch->elements, &scratch->elementCapacity, capacity, sizeof(uint32_t));
+  memcpy(scratch->elements, nfa->initialStates, nfa->initialStateCount * sizeof(uint32_t));
+  qsort(scratch->elements, nfa->initialStateCount, sizeof(uint32_t), _compareStates);
+  for (uint32_t k = 0; k < nfa->initialStateCount; ++k) {
+    if (0 < count && scratch->elements[count - 1] == scratch->elements[k]) continue;
+    scratch->elements[count++] = scratch->elements[k];
+    *sum += _mix(scratch->elements[k]);
+  }
+  return count;
+}
+
+/**
+ * A subset of the parallel construction. Its words live in a block of its
+ * shard's pool, so they can be read without holding the shard's lock.
+ */
+typedef struct {
+  const uint32_t* words;
+  uint32_t length;
+  uint32_t count;
+  uint32_t hash;
+  bool dense;
+  bool accepting;
+} SharedSubset;
+
+/**
+ * A part of the concurrent index of subsets: the ones whose hash starts with
+ * its number. A subset's id is its index in the shard, followed by the
+ * `SHARD_BITS` of the shard.
+ */
+typedef struct {
+  pthread_mutex_t lock;
+  SharedSubset* subsets;
+  size_t subsetCount;
+  size_t subsetCapacity;
+  uint32_t* slots;
+  uint32_t slotCapacity;
+  uint32_t** blocks;
+  size_t blockCount;
+  size_t blockCapacity;
+  size_t blockSize;
+  size_t blockUsed;
+  size_t poolWords;
+} Shard;
+
+/**
+ * A subset to expand.
+ */
+typedef struct {
+  const uint32_t* words;
+  uint32_t length;
+  uint32_t id;
+  bool dense;
+} Task;
+
+/**
+ * The tasks of a worker. The worker pushes and pops them at the tail, so it
+ * expands the subsets it just found (which keeps them in its cache), while
+ * the idle workers steal them from the head.
+ */
+typedef struct {
+  pthread_mutex_t lock;
+  Task* tasks;
+  size_t head;
+  size_t tail;
+  size_t capacity;
+} Deque;
+
+typedef struct ParallelDeterminizer ParallelDeterminizer;
+
+typedef struct {
+  ParallelDeterminizer* determinizer;
+  size_t index;
+  Deque deque;
+  Scratch scratch;
+  // The subsets expanded by this worker, and where their transitions begin.
+  uint32_t* rowIds;
+  size_t rowIdCapacity;
+  uint32_t* rowOffsets;
+  size_t rowOffsetCapacity;
+  size_t rowCount;
+  uint32_t* symbols;
+  uint32_t* targets;
+  size_t transitionCount;
+  size_t transitionCapacity;
+  uint64_t steals;
+} Worker;
+
+struct ParallelDeterminizer {
+  const Automaton* nfa;
+  uint32_t denseLength;
+  Shard shards[SHARD_COUNT];
+  Worker* workers;
+  size_t workerCount;
+  // The subsets found but not expanded yet, updated atomically.
+  uint64_t pending;
+};
+
+static void _push(Deque* deque, Task task) {
+  pthread_mutex_lock(&deque->lock);
+  if (deque->head == deque->tail) deque->head = deque->tail = 0;
+  deque->tasks = safeReserve(deque->tasks, &deque->capacity, deque->tail + 1, sizeof(Task));
+  deque->tasks[deque->tail++] = task;
+  pthread_mutex_unlock(&deque->lock);
+}
+
+static bool _pop(Deque* deque, Task* task) {
+  pthread_mutex_lock(&deque->lock);
+  const bool found = deque->head < deque->tail;
+  if (found) *task = deque->tasks[--deque->tail];
+  pthread_mutex_unlock(&deque->lock);
+  return found;
+}
+
+static bool _stealFrom(Deque* deque, Task* task) {
+  pthread_mutex_lock(&deque->lock);
+  const bool found = deque->head < deque->tail;
+  if (found) *task = deque->tasks[deque->head++];
+  pthread_mutex_unlock(&deque->lock);
+  return found;
+}
+
+/**
+ * Steals the oldest task of another worker, trying each one in turn.
+ */
+static bool _steal(Worker* worker, Task* task) {
+  const ParallelDeterminizer* determinizer = worker->determinizer;
+  for (size_t k = 1; k < determinizer->workerCount; ++k) {
+    Worker* victim = &determinizer->workers[(worker->index + k) % determinizer->workerCount];
+    if (_stealFrom(&victim->deque, task)) {
+      ++worker->steals;
+      return true;
+    }
+  }
+  return false;
+}
+
+static void _growShardSlots(Shard* shard) {
+  const uint32_t capacity = shard->slotCapacity == 0 ? 64 : 2 * shard->slotCapacity;
+  uint32_t* slots = safeMalloc(capacity * sizeof(uint32_t));
+  memset(slots, 0xFF, capacity * sizeof(uint32_t));
+  for (size_t k = 0; k < shard->subsetCount; ++k) {
+    uint32_t slot = shard->subsets[k].hash & (capacity - 1);
+    while (slots[slot] != EMPTY_SLOT) slot = (slot + 1) & (capacity - 1);
+    slots[slot] = (uint32_t)k;
+  }
+  free(shard->slots);
+  shard->slots = slots;
+  shard->slotCapacity = capacity;
+}
+
+/**
+ * @return Room for `length` words in the pool of a shard.
+ */
+static uint32_t* _allocateWords(Shard* shard, uint32_t length) {
+  if (shard->blockCount == 0 || shard->blockSize < shard->blockUsed + length) {
+    shard->blockSize = length < POOL_BLOCK_SIZE ? POOL_BLOCK_SIZE : length;
+    shard->blocks = safeReserve(shard->blocks, &shard->blockCapacity, shard->blockCount + 1, sizeof(uint32_t*));
+    shard->blocks[shard->blockCount++] = safeMalloc(shard->blockSize * sizeof(uint32_t));
+    shard->poolWords += shard->blockSize;
+    shard->blockUsed = 0;
+  }
+  uint32_t* words = shard->blocks[shard->blockCount - 1] + shard->blockUsed;
+  shard->blockUsed += length;
+  return words;
+}
+
+/**
+ * Finds the subset made of the sorted, duplicate-free elements in the
+ * worker's scratch buffer, adding it (and the task to expand it) if it's new.
+ *
+ * @return The id of the subset.
+ */
+static uint32_t _internShared(Worker* worker, uint32_t count, uint64_t sum) {
+  ParallelDeterminizer* determinizer = worker->determinizer;
+  Scratch* scratch = &worker->scratch;
+  const uint32_t hash = _finish(sum, count);
+  uint32_t length;
+  const bool dense = _encode(scratch, determinizer->denseLength, scratch->elements, count, &length);
+  const uint32_t shardIndex = hash >> (32 - SHARD_BITS);
+  Shard* shard = &determinizer->shards[shardIndex];
+
+  pthread_mutex_lock(&shard->lock);
+  if (shard->slotCapacity < 2 * (shard->subsetCount + 1)) _growShardSlots(shard);
+  const uint32_t mask = shard->slotCapacity - 1;
+  uint32_t slot = hash & mask;
+  for (; shard->slots[slot] != EMPTY_SLOT; slot = (slot + 1) & mask) {
+    const SharedSubset* other = &shard->subsets[shard->slots[slot]];
+    if (other->hash == hash && other->count == count && other->dense == dense &&
+        memcmp(other->words, scratch->encoded, length * sizeof(uint32_t)) == 0) {
+      const uint32_t id = shard->slots[slot] << SHARD_BITS | shardIndex;
+      pthread_mutex_unlock(&shard->lock);
+      return id;
+    }
+  }
+  const size_t local = shard->subsetCount++;
+  if ((UINT32_MAX >> SHARD_BITS) <= local) exitInvalidArgument(__func__, "too many DFA states");
+  uint32_t* words = _allocateWords(shard, length);
+  if (0 < length) memcpy(words, scratch->encoded, length * sizeof(uint32_t));
+  bool accepting = false;
+  for (uint32_t k = 0; !accepting && k < count; ++k) {
+    accepting = Automaton_isAccepting(determinizer->nfa, scratch->elements[k]);
+  }
+  shard->subsets = safeReserve(shard->subsets, &shard->subsetCapacity, shard->subsetCount, sizeof(SharedSubset));
+  shard->subsets[local] = (SharedSubset){
+    .words = words, .length = length, .count = count, .hash = hash, .dense = dense, .accepting = accepting
+  };
+  shard->slots[slot] = (uint32_t)local;
+  pthread_mutex_unlock(&shard->lock);
+
+  const uint32_t id = (uint32_t)local << SHARD_BITS | shardIndex;
+  __atomic_add_fetch(&determinizer->pending, 1, __ATOMIC_RELAXED);
+  _push(&worker->deque, (Task){.words = words, .length = length, .id = id, .dense = dense});
+  return id;
+}
+
+static void _expandShared(Worker* worker, const Task* task) {
+  Scratch* scratch = &worker->scratch;
+  const size_t pairCount = _gatherPairs(scratch, worker->determinizer->nfa, task->words, task->length, task->dense);
+  worker->rowIds = safeReserve(worker->rowIds, &worker->rowIdCapacity, worker->rowCount + 1, sizeof(uint32_t));
+  worker->rowOffsets =
+    safeReserve(worker->rowOffsets, &worker->rowOffsetCapacity, worker->rowCount + 2, sizeof(uint32_t));
+  worker->rowIds[worker->rowCount] = task->id;
+  worker->rowOffsets[worker->rowCount++] = (uint32_t)worker->transitionCount;
+  for (size_t k = 0; k < pairCount;) {
+    uint32_t symbol;
+    uint64_t sum;
+    const uint32_t count = _gatherSuccessor(scratch, pairCount, &k, &symbol, &sum);
+    const uint32_t target = _internShared(worker, count, sum);
+    if (worker->transitionCount == worker->transitionCapacity) {
+      worker->transitionCapacity = worker->transitionCount == 0 ? 64 : 2 * worker->transitionCount;
+      worker->symbols = realloc(worker->symbols, worker->transitionCapacity * sizeof(uint32_t));
+      worker->targets = realloc(worker->targets, worker->transitionCapacity * sizeof(uint32_t));
+      if (worker->symbols == NULL || worker->targets == NULL) exitWithPerror(__func__, "realloc error");
+    }
+    worker->symbols[worker->transitionCount] = symbol;
+    worker->targets[worker->transitionCount++] = target;
+  }
+  if (UINT32_MAX < worker->transitionCount) exitInvalidArgument(__func__, "too many DFA transitions");
+  worker->rowOffsets[worker->rowCount] = (uint32_t)worker->transitionCount;
+}
+
+/**
+ * Expands subsets until every subset found has been expanded, by any worker.
+ */
+static void* _work(void* argument) {
+  Worker* worker = argument;
+  ParallelDeterminizer* determinizer = worker->determinizer;
+  Task task;
+  while (true) {
+    if (_pop(&worker->deque, &task) || _steal(worker, &task)) {
+      _expandShared(worker, &task);
+      __atomic_sub_fetch(&determinizer->pending, 1, __ATOMIC_RELEASE);
+    } else if (__atomic_load_n(&determinizer->pending, __ATOMIC_ACQUIRE) == 0) {
+      return NULL;
+    } else {
+      sched_yield();
+    }
+  }
+}
+
+/**
+ * Numbers the subsets found by the workers in the order the sequential
+ * construction would have found them: breadth-first from the initial one,
+ * with the successors of each subset in the order of their symbols.
+ */
+static Automaton* _assemble(const ParallelDeterminizer* determinizer, uint32_t initial) {
+  // The subsets of each shard come right after the ones of the previous shard.
+  size_t bases[SHARD_COUNT + 1];
+  bases[0] = 0;
+  for (size_t k = 0; k < SHARD_COUNT; ++k) {
+    bases[k + 1] = bases[k] + determinizer->shards[k].subsetCount;
+  }
+  const size_t subsetCount = bases[SHARD_COUNT];
+  size_t transitionCount = 0;
+  for (size_t k = 0; k < determinizer->workerCount; ++k) {
+    transitionCount += determinizer->workers[k].transitionCount;
+  }
+  if (UINT32_MAX <= subsetCount || UINT32_MAX < transitionCount) exitInvalidArgument(__func__, "DFA too large");
+
+  // Where the row of each subset is: the worker that expanded it, and its index there.
+  uint32_t* rowWorkers = safeMalloc(subsetCount * sizeof(uint32_t));
+  uint32_t* rowIndexes = safeMalloc(subsetCount * sizeof(uint32_t));
+  for (size_t k = 0; k < determinizer->workerCount; ++k) {
+    const Worker* worker = &determinizer->workers[k];
+    for (size_t row = 0; row < worker->rowCount; ++row) {
+      const uint32_t id = worker->rowIds[row];
+      const size_t index = bases[id & (SHARD_COUNT - 1)] + (id >> SHARD_BITS);
+      rowWorkers[index] = (uint32_t)k;
+      rowIndexes[index] = (uint32_t)row;
+    }
+  }
+
+  Automaton* dfa = Automaton_new((uint32_t)subsetCount, (uint32_t)transitionCount, 1);
+  dfa->initialStates[0] = 0;
+  uint32_t* states = safeMalloc(subsetCount * sizeof(uint32_t));
+  memset(states, 0xFF, subsetCount * sizeof(uint32_t));
+  uint32_t* order = safeMalloc(subsetCount * sizeof(uint32_t));
+  order[0] = initial;
+  states[bases[initial & (SHARD_COUNT - 1)] + (initial >> SHARD_BITS)] = 0;
+  uint32_t found = 1;
+  uint32_t transition = 0;
+  for (uint32_t state = 0; state < found; ++state) {
+    const uint32_t id = order[state];
+    const size_t index = bases[id & (SHARD_COUNT - 1)] + (id >> SHARD_BITS);
+    const Worker* worker = &determinizer->workers[rowWorkers[index]];
+    const uint32_t row = rowIndexes[index];
+    if (determinizer->shards[id & (SHARD_COUNT - 1)].subsets[id >> SHARD_BITS].accepting) {
+      Bitset_set(dfa->accepting, state);
+    }
+    dfa->offsets[state] = transition;
+    for (uint32_t k = worker->rowOffsets[row]; k < worker->rowOffsets[row + 1]; ++k) {
+      const uint32_t target = worker->targets[k];
+      const size_t targetIndex = bases[target & (SHARD_COUNT - 1)] + (target >> SHARD_BITS);
+      if (states[targetIndex] == EMPTY_SLOT) {
+        states[targetIndex] = found;
+        order[found++] = target;
+      }
+      dfa->symbols[transition] = worker->symbols[k];
+      dfa->targets[transition++] = states[targetIndex];
+    }
+  }
+  dfa->offsets[found] = transition;
+  dfa->deterministic = true;
+  free(rowWorkers);
+  free(rowIndexes);
+  free(states);
+  free(order);
+  return dfa;
+}
+
+static size_t _sharedBytes(const ParallelDeterminizer* determinizer) {
+  size_t bytes = 0;
+  for (size_t k = 0; k < SHARD_COUNT; ++k) {
+    const Shard* shard = &determinizer->shards[k];
+    bytes += shard->subsetCapacity * sizeof(SharedSubset) + shard->slotCapacity * sizeof(uint32_t);
+    bytes += shard->poolWords * sizeof(uint32_t);
+  }
+  for (size_t k = 0; k < determinizer->workerCount; ++k) {
+    const Worker* worker = &determinizer->workers[k];
+    bytes += worker->deque.capacity * sizeof(Task);
+    bytes += (worker->rowIdCapacity + worker->rowOffsetCapacity) * sizeof(uint32_t);
+    bytes += 2 * worker->transitionCapacity * sizeof(uint32_t) + worker->scratch.pairCapacity * sizeof(uint64_t);
+    bytes += (worker->scratch.encodedCapacity + worker->scratch.elementCapacity) * sizeof(uint32_t);
+  }
+  return bytes;
+}
+
+/**
+ * The subset construction, with the subsets expanded by `threadCount`
+ * workers that steal each other's tasks when they run out of them, and share
+ * a sharded index of the subsets.
+ */
+static Automaton* _determinizeInParallel(
+  const Automaton* nfa, size_t threadCount, size_t* peakBytes, uint64_t* steals
+) {
+  ParallelDeterminizer determinizer = {
+    .nfa = nfa,
+    .denseLength = (nfa->stateCount + 31) / 32,
+    .workers = safeCalloc(threadCount, sizeof(Worker)),
+    .workerCount = threadCount,
+  };
+  for (size_t k = 0; k < SHARD_COUNT; ++k) {
+    pthread_mutex_init(&determinizer.shards[k].lock, NULL);
+  }
+  for (size_t k = 0; k < threadCount; ++k) {
+    determinizer.workers[k].determinizer = &determinizer;
+    determinizer.workers[k].index = k;
+    pthread_mutex_init(&determinizer.workers[k].deque.lock, NULL);
+  }
+  uint64_t sum;
+  const uint32_t count = _gatherInitial(&determinizer.workers[0].scratch, nfa, &sum);
+  const uint32_t initial = _internShared(&determinizer.workers[0], count, sum);
+
+  pthread_t* threads = safeMalloc(threadCount * sizeof(pthread_t));
+  bool* started = safeCalloc(threadCount, sizeof(bool));
+  for (size_t k = 1; k < threadCount; ++k) {
+    started[k] = pthread_create(&threads[k], NULL, _work, &determinizer.workers[k]) == 0;
+  }
+  // A worker whose thread couldn't be spawned has no tasks, and the others do its share.
+  _work(&determinizer.workers[0]);
+  for (size_t k = 1; k < threadCount; ++k) {
+    if (started[k]) pthread_join(threads[k], NULL);
+  }
+  free(started);
+  free(threads);
+
+  Automaton* dfa = _assemble(&determinizer, initial);
+  *peakBytes = _sharedBytes(&determinizer);
+  *steals = 0;
+  for (size_t k = 0; k < threadCount; ++k) {
+    Worker* worker = &determinizer.workers[k];
+    *steals += worker->steals;
+    pthread_mutex_destroy(&worker->deque.lock);
+    free(worker->deque.tasks);
+    _freeScratch(&worker->scratch);
+    free(worker->rowIds);
+    free(worker->rowOffsets);
+    free(worker->symbols);
+    free(worker->targets);
+  }
+  for (size_t k = 0; k < SHARD_COUNT; ++k) {
+    Shard* shard = &determinizer.shards[k];
+    pthread_mutex_destroy(&shard->lock);
+    for (size_t block = 0; block < shard->blockCount; ++block) {
+      free(shard->blocks[block]);
+    }
+    free(shard->blocks);
+    free(shard->subsets);
+    free(shard->slots);
+  }
+  free(determinizer.workers);
+  return dfa;
+}
+
+/**
+ * The subset construction itself, for an automaton without epsilon
+ * transitions nor accepting sink.
+ */
+static Automaton* _construct(const Automaton* nfa, DeterminizationReport* report) {
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  Determinizer determinizer = {.nfa = nfa, .denseLength = (nfa->stateCount + 31) / 32};
+  uint64_t sum;
+  const uint32_t count = _gatherInitial(&determinizer.scratch, nfa, &sum);
+  _intern(&determinizer, determinizer.scratch.elements, count, sum);
+
+  // The subsets are a worklist: each one is expanded once, in the order it was found.
+  bool parallel = false;
+  for (uint32_t id = 0; id < determinizer.subsetCount; ++id) {
+    // Once the DFA turns out to be large, the workers build it again: what was found so far is little next to the rest.
+    if (1 < _workerThreads && _parallelThreshold < determinizer.subsetCount) {
+      parallel = true;
+      break;
+    }
+    _expand(&determinizer, id);
+  }
+
+  Automaton* dfa;
+  uint64_t steals = 0;
+  if (parallel) {
+    size_t sequentialBytes = determinizer.peakBytes;
+    _freeDeterminizer(&determinizer);
+    dfa = _determinizeInParallel(nfa, _workerThreads, &determinizer.peakBytes, &steals);
+    if (determinizer.peakBytes < sequentialBytes) determinizer.peakBytes = sequentialBytes;
+  } else {
+    determinizer.offsets[determinizer.subsetCount] = determinizer.transitionCount;
+    dfa = Automaton_new(determinizer.subsetCount, determinizer.transitionCount, 1);
+    dfa->initialStates[0] = 0;
+    memcpy(dfa->offsets, determinizer.offsets, (1 + (size_t)determinizer.subsetCount) * sizeof(uint32_t));
+    if (0 < determinizer.transitionCount) {
+      memcpy(dfa->symbols, determinizer.symbols, determinizer.transitionCount * sizeof(uint32_t));
+      memcpy(dfa->targets, determinizer.targets, determinizer.transitionCount * sizeof(uint32_t));
+    }
+    for (uint32_t id = 0; id < determinizer.subsetCount; ++id) {
+      if (determinizer.subsets[id].accepting) Bitset_set(dfa->accepting, id);
+    }
+    dfa->deterministic = true;
+    _freeDeterminizer(&determinizer);
+  }
+
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  const double milliseconds = 1e3 * (double)(end.tv_sec - start.tv_sec) + 1e-6 * (double)(end.tv_nsec - start.tv_nsec);
+  if (parallel) {
+    logDebugging(
+      _logger,
+      "Determinized %u NFA states into %u DFA states with %zu threads (%llu steals, peak of %zu bytes) in %.3f ms.",
+      nfa->stateCount, dfa->stateCount, _workerThreads, (unsigned long long)steals, determinizer.peakBytes, milliseconds
+    );
+  } else {
+    logDebugging(
+      _logger, "Determinized %u NFA states into %u DFA states (%zu subset words, peak of %zu bytes) in %.3f ms.",
+      nfa->stateCount, dfa->stateCount, determinizer.poolSize, determinizer.peakBytes, milliseconds
+    );
+  }
+  if (report != NULL) {
+    *report = (DeterminizationReport){
+      .stateCount = dfa->stateCount, .peakBytes = determinizer.peakBytes, .milliseconds = milliseconds
+    };
+  }
+  return dfa;
+}
+
+/* PUBLIC FUNCTIONS */
+
+Automaton* determinize(const Automaton* nfa, DeterminizationReport* report) {
+  if (nfa->acceptingSink) {
+    Automaton* complete = Automaton_materializeSink(nfa);
+    Automaton* dfa = determinize(complete, report);
+    Automaton_free(complete);
+    return dfa;
+  }
+  if (Automaton_hasEpsilons(nfa)) {
+    Automaton* withoutEpsilons = removeEpsilons(nfa);
+    Automaton* dfa = determinize(withoutEpsilons, report);
+    Automaton_free(withoutEpsilons);
+    return dfa;
+  }
+  // The subsets of a DFA are all singletons, so merging its states first wouldn't pay off.
+  Automaton* reduced = nfa->deterministic ? NULL : reduceByBisimulation(nfa, NULL);
+  if (reduced == NULL) return _construct(nfa, report);
+  Automaton* dfa = _construct(reduced, report);
+  Automaton_free(reduced);
+  return dfa;
+}
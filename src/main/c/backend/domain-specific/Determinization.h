@@ -0,0 +1,49 @@
+#ifndef DETERMINIZATION_HEADER
+#define DETERMINIZATION_HEADER
+
+#include "Automaton.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/** Initialize module's internal state. */
+void initializeDeterminizationModule();
+
+/** Shutdown module's internal state. */
+void shutdownDeterminizationModule();
+
+/**
+ * What a determinization cost.
+ */
+typedef struct {
+  uint32_t stateCount;
+  // The most memory held at once by the subsets, their index and the transitions built.
+  size_t peakBytes;
+  double milliseconds;
+} DeterminizationReport;
+
+/**
+ * Builds a DFA for the language of `nfa` with the subset construction,
+ * exploring only the subsets reachable from the initial states. The DFA is
+ * partial: a subset is never empty, and missing transitions reject. Epsilon
+ * transitions are removed first, so no closure is computed per subset, and
+ * then the bisimilar states of the NFA are merged (see
+ * `reduceByBisimulation`), so there are fewer states to make subsets of.
+ *
+ * Subsets are hash-consed: each one is stored once, in a shared pool, either
+ * as a bitset over the NFA states or as a sorted array of them (whichever is
+ * smaller), and is found by a hash computed incrementally from its elements.
+ *
+ * Once more than PARALLEL_DETERMINIZATION_THRESHOLD subsets are found, the
+ * DFA is built again by WORKER_THREADS workers: each one expands the subsets
+ * of its own deque, steals the oldest ones of another deque when it runs out,
+ * and adds the subsets it finds to an index split in independently locked
+ * shards. The states are then numbered as the sequential construction
+ * would, so the DFA is the same for any number of threads.
+ *
+ * @param report If not NULL, receives the cost of the construction.
+ * @return A heap-allocated deterministic automaton, whose states are numbered
+ *         in the order they were discovered (the initial state is 0).
+ */
+Automaton* determinize(const Automaton* nfa, DeterminizationReport* report);
+
+#endif
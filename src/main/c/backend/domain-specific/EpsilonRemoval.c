@@ -0,0 +1,271 @@
+#include "EpsilonRemoval.h"
+#include "../../shared/Bitset.h"
+#include "../../shared/Logger.h"
+#include "../../shared/utils.h"
+#include "Automaton.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* MODULE INTERNAL STATE */
+
+#define UNVISITED UINT32_MAX
+
+static Logger* _logger = NULL;
+
+void initializeEpsilonRemovalModule() {
+  _logger = createLogger("EpsilonRemoval");
+}
+
+void shutdownEpsilonRemovalModule() {
+  if (_logger != NULL) {
+    destroyLogger(_logger);
+  }
+}
+
+/**
+ * The strongly connected components of the epsilon transitions of an
+ * automaton, numbered in the order Tarjan's algorithm completes them: the
+ * components a component reaches by epsilon always have smaller numbers.
+ */
+typedef struct {
+  // Where the epsilon transitions of each state begin (they end its row).
+  uint32_t* epsilonBegin;
+  uint32_t* component;
+  uint32_t componentCount;
+  // The states of each component, grouped.
+  uint32_t* memberOffsets;
+  uint32_t* members;
+} Components;
+
+/**
+ * The closed rows of the components, as sorted `symbol << 32 | component`
+ * pairs, laid out in component order.
+ */
+typedef struct {
+  uint64_t* pairs;
+  size_t pairCount;
+  size_t pairCapacity;
+  size_t* offsets;
+  Bitset accepting;
+} ClosedRows;
+
+/* PRIVATE FUNCTIONS */
+
+static int _comparePairs(const void* left, const void* right) {
+  const uint64_t a = *(const uint64_t*)left;
+  const uint64_t b = *(const uint64_t*)right;
+  return (a > b) - (a < b);
+}
+
+/**
+ * Tarjan's algorithm on the epsilon transitions, with an explicit stack of
+ * frames instead of recursion, since epsilon chains can be as long as the
+ * automaton.
+ */
+static Components _findComponents(const Automaton* nfa) {
+  const uint32_t stateCount = nfa->stateCount;
+  const size_t size = stateCount == 0 ? 1 : stateCount;
+  Components components = {
+    .epsilonBegin = safeMalloc(size * sizeof(uint32_t)),
+    .component = safeMalloc(size * sizeof(uint32_t)),
+    .componentCount = 0,
+  };
+  uint32_t* index = safeMalloc(size * sizeof(uint32_t));
+  uint32_t* lowLink = safeMalloc(size * sizeof(uint32_t));
+  uint32_t* stack = safeMalloc(size * sizeof(uint32_t));
+  uint32_t* frameStates = safeMalloc(size * sizeof(uint32_t));
+  uint32_t* frameEdges = safeMalloc(size * sizeof(uint32_t));
+  for (uint32_t state = 0; state < stateCount; ++state) {
+    uint32_t begin = nfa->offsets[state + 1];
+    while (nfa->offsets[state] < begin && nfa->symbols[begin - 1] == EPSILON) --begin;
+    components.epsilonBegin[state] = begin;
+    index[state] = UNVISITED;
+    components.component[state] = UNVISITED;
+  }
+
+  uint32_t counter = 0;
+  uint32_t stackCount = 0;
+  for (uint32_t root = 0; root < stateCount; ++root) {
+    if (index[root] != UNVISITED) continue;
+    uint32_t frameCount = 0;
+    index[root] = lowLink[root] = counter++;
+    stack[stackCount++] = root;
+    frameStates[frameCount] = root;
+    frameEdges[frameCount++] = components.epsilonBegin[root];
+    while (0 < frameCount) {
+      const uint32_t state = frameStates[frameCount - 1];
+      if (frameEdges[frameCount - 1] < nfa->offsets[state + 1]) {
+        const uint32_t target = nfa->targets[frameEdges[frameCount - 1]++];
+        if (index[target] == UNVISITED) {
+          index[target] = lowLink[target] = counter++;
+          stack[stackCount++] = target;
+          frameStates[frameCount] = target;
+          frameEdges[frameCount++] = components.epsilonBegin[target];
+        } else if (components.component[target] == UNVISITED && index[target] < lowLink[state]) {
+          // Visited but not in a component yet: it's still on the stack.
+          lowLink[state] = index[target];
+        }
+        continue;
+      }
+      --frameCount;
+      if (lowLink[state] == index[state]) {
+        uint32_t member;
+        do {
+          member = stack[--stackCount];
+          components.component[member] = components.componentCount;
+        } while (member != state);
+        ++components.componentCount;
+      }
+      if (0 < frameCount && lowLink[state] < lowLink[frameStates[frameCount - 1]]) {
+        lowLink[frameStates[frameCount - 1]] = lowLink[state];
+      }
+    }
+  }
+  free(index);
+  free(lowLink);
+  free(stack);
+  free(frameStates);
+  free(frameEdges);
+
+  components.memberOffsets = safeCalloc((size_t)components.componentCount + 1, sizeof(uint32_t));
+  components.members = safeMalloc(size * sizeof(uint32_t));
+  for (uint32_t state = 0; state < stateCount; ++state) {
+    ++components.memberOffsets[components.component[state] + 1];
+  }
+  for (uint32_t c = 0; c < components.componentCount; ++c) {
+    components.memberOffsets[c + 1] += components.memberOffsets[c];
+  }
+  uint32_t* next = safeMalloc(((size_t)components.componentCount + 1) * sizeof(uint32_t));
+  memcpy(next, components.memberOffsets, ((size_t)components.componentCount + 1) * sizeof(uint32_t));
+  for (uint32_t state = 0; state < stateCount; ++state) {
+    components.members[next[components.component[state]]++] = state;
+  }
+  free(next);
+  return components;
+}
+
+static void _appendPair(ClosedRows* rows, uint64_t pair) {
+  rows->pairs = safeReserve(rows->pairs, &rows->pairCapacity, rows->pairCount + 1, sizeof(uint64_t));
+  rows->pairs[rows->pairCount++] = pair;
+}
+
+/**
+ * Closes the rows of the components in their order, so the closed rows of
+ * the components reached by epsilon are ready when they're merged in.
+ */
+static ClosedRows _closeRows(const Automaton* nfa, const Components* components) {
+  const uint32_t count = components->componentCount;
+  ClosedRows rows = {
+    .offsets = safeMalloc(((size_t)count + 1) * sizeof(size_t)),
+    .accepting = Bitset_new(count),
+  };
+  uint32_t* merged = safeMalloc((count == 0 ? 1 : count) * sizeof(uint32_t));
+  memset(merged, 0xFF, (count == 0 ? 1 : count) * sizeof(uint32_t));
+  for (uint32_t c = 0; c < count; ++c) {
+    const size_t begin = rows.pairCount;
+    rows.offsets[c] = begin;
+    bool accepting = false;
+    for (uint32_t m = components->memberOffsets[c]; m < components->memberOffsets[c + 1]; ++m) {
+      const uint32_t state = components->members[m];
+      accepting = accepting || Automaton_isAccepting(nfa, state);
+      for (uint32_t k = nfa->offsets[state]; k < components->epsilonBegin[state]; ++k) {
+        _appendPair(&rows, (uint64_t)nfa->symbols[k] << 32 | components->component[nfa->targets[k]]);
+      }
+      for (uint32_t k = components->epsilonBegin[state]; k < nfa->offsets[state + 1]; ++k) {
+        const uint32_t successor = components->component[nfa->targets[k]];
+        if (successor == c || merged[successor] == c) continue;
+        merged[successor] = c;
+        accepting = accepting || Bitset_test(rows.accepting, successor);
+        for (size_t j = rows.offsets[successor]; j < rows.offsets[successor + 1]; ++j) {
+          _appendPair(&rows, rows.pairs[j]);
+        }
+      }
+    }
+    if (accepting) Bitset_set(rows.accepting, c);
+    if (1 < rows.pairCount - begin) qsort(rows.pairs + begin, rows.pairCount - begin, sizeof(uint64_t), _comparePairs);
+    size_t end = begin;
+    for (size_t j = begin; j < rows.pairCount; ++j) {
+      if (end == begin || rows.pairs[end - 1] != rows.pairs[j]) rows.pairs[end++] = rows.pairs[j];
+    }
+    rows.pairCount = end;
+    rows.offsets[c + 1] = end;
+  }
+  free(merged);
+  return rows;
+}
+
+/* PUBLIC FUNCTIONS */
+
+Automaton* removeEpsilons(const Automaton* nfa) {
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  Components components = _findComponents(nfa);
+  ClosedRows rows = _closeRows(nfa, &components);
+  const uint32_t count = components.componentCount;
+
+  // Only the components reachable without epsilon transitions are kept, numbered in the order they're found.
+  uint32_t* renumbering = safeMalloc((count == 0 ? 1 : count) * sizeof(uint32_t));
+  memset(renumbering, 0xFF, (count == 0 ? 1 : count) * sizeof(uint32_t));
+  uint32_t* order = safeMalloc((count == 0 ? 1 : count) * sizeof(uint32_t));
+  uint32_t reached = 0;
+  for (uint32_t k = 0; k < nfa->initialStateCount; ++k) {
+    const uint32_t c = components.component[nfa->initialStates[k]];
+    if (renumbering[c] == UNVISITED) {
+      renumbering[c] = reached;
+      order[reached++] = c;
+    }
+  }
+  const uint32_t initialCount = reached;
+  size_t transitionCount = 0;
+  for (uint32_t k = 0; k < reached; ++k) {
+    const uint32_t c = order[k];
+    transitionCount += rows.offsets[c + 1] - rows.offsets[c];
+    for (size_t j = rows.offsets[c]; j < rows.offsets[c + 1]; ++j) {
+      const uint32_t target = (uint32_t)rows.pairs[j];
+      if (renumbering[target] == UNVISITED) {
+        renumbering[target] = reached;
+        order[reached++] = target;
+      }
+    }
+  }
+  if (UINT32_MAX <= transitionCount) exitInvalidArgument(__func__, "too many transitions without epsilons");
+
+  Automaton* automaton = Automaton_new(reached, (uint32_t)transitionCount, initialCount);
+  for (uint32_t k = 0; k < initialCount; ++k) {
+    automaton->initialStates[k] = k;
+  }
+  uint32_t position = 0;
+  for (uint32_t k = 0; k < reached; ++k) {
+    const uint32_t c = order[k];
+    automaton->offsets[k] = position;
+    for (size_t j = rows.offsets[c]; j < rows.offsets[c + 1]; ++j) {
+      automaton->symbols[position] = (uint32_t)(rows.pairs[j] >> 32);
+      automaton->targets[position++] = renumbering[(uint32_t)rows.pairs[j]];
+    }
+    if (Bitset_test(rows.accepting, c)) Bitset_set(automaton->accepting, k);
+  }
+  automaton->offsets[reached] = position;
+  Automaton_normalize(automaton);
+
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  const double milliseconds = 1e3 * (double)(end.tv_sec - start.tv_sec) + 1e-6 * (double)(end.tv_nsec - start.tv_nsec);
+  logDebugging(
+    _logger, "Removed the epsilon transitions of %u states (%u components) into %u states in %.3f ms.",
+    nfa->stateCount, count, automaton->stateCount, milliseconds
+  );
+  free(renumbering);
+  free(order);
+  free(rows.pairs);
+  free(rows.offsets);
+  free(rows.accepting);
+  free(components.epsilonBegin);
+  free(components.component);
+  free(components.memberOffsets);
+  free(components.members);
+  return automaton;
+}
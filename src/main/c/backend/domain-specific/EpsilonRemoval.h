@@ -0,0 +1,28 @@
+#ifndef EPSILON_REMOVAL_HEADER
+#define EPSILON_REMOVAL_HEADER
+
+#include "Automaton.h"
+
+/** Initialize module's internal state. */
+void initializeEpsilonRemovalModule();
+
+/** Shutdown module's internal state. */
+void shutdownEpsilonRemovalModule();
+
+/**
+ * Builds an automaton without epsilon transitions for the language of `nfa`.
+ *
+ * The epsilon closures are computed once, for the whole automaton: the
+ * strongly connected components of the epsilon transitions (found with
+ * Tarjan's algorithm) share their closure, so each one becomes a single
+ * state, and the transitions of a component are its own plus those of the
+ * components it reaches by epsilon, which are built first (Tarjan's order is
+ * a reverse topological one). The determinization never computes a closure
+ * again.
+ *
+ * @return A heap-allocated automaton, trimmed to the states reachable from
+ *         its initial states.
+ */
+Automaton* removeEpsilons(const Automaton* nfa);
+
+#endif
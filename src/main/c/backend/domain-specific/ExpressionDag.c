@@ -0,0 +1,138 @@
+#include "ExpressionDag.h"
+#include "../../shared/Bitset.h"
+#include "../../shared/utils.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* MODULE INTERNAL STATE */
+
+#define EMPTY_SLOT UINT32_MAX
+
+/* PRIVATE FUNCTIONS */
+
+static inline uint64_t _mix(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+static uint64_t _hashNode(const DagNode* node) {
+  return _mix(_mix(_mix((uint64_t)node->type) ^ node->first) ^ node->second);
+}
+
+static uint64_t _hashPath(const char* path) {
+  uint64_t hash = 0;
+  for (const char* character = path; *character != '\0'; ++character) {
+    hash = _mix(hash ^ (unsigned char)*character);
+  }
+  return hash;
+}
+
+/**
+ * Doubles an open-addressing table of indexes, placing them again by the
+ * hash of what they index.
+ */
+static uint32_t* _growSlots(const ExpressionDag* dag, uint32_t* slots, uint32_t* slotCapacity, bool paths) {
+  const uint32_t oldCapacity = *slotCapacity;
+  *slotCapacity = oldCapacity == 0 ? 64 : 2 * oldCapacity;
+  uint32_t* newSlots = safeMalloc(*slotCapacity * sizeof(uint32_t));
+  memset(newSlots, 0xFF, *slotCapacity * sizeof(uint32_t));
+  for (uint32_t k = 0; k < oldCapacity; ++k) {
+    if (slots[k] == EMPTY_SLOT) continue;
+    const uint64_t hash = paths ? _hashPath(dag->paths[slots[k]]) : _hashNode(&dag->nodes[slots[k]]);
+    uint32_t slot = (uint32_t)hash & (*slotCapacity - 1);
+    while (newSlots[slot] != EMPTY_SLOT) slot = (slot + 1) & (*slotCapacity - 1);
+    newSlots[slot] = slots[k];
+  }
+  free(slots);
+  return newSlots;
+}
+
+static uint32_t _internPath(ExpressionDag* dag, const char* path) {
+  if (dag->pathSlotCapacity < 2 * ((size_t)dag->pathCount + 1)) {
+    dag->pathSlots = _growSlots(dag, dag->pathSlots, &dag->pathSlotCapacity, true);
+  }
+  const uint32_t mask = dag->pathSlotCapacity - 1;
+  uint32_t slot = (uint32_t)_hashPath(path) & mask;
+  for (; dag->pathSlots[slot] != EMPTY_SLOT; slot = (slot + 1) & mask) {
+    if (strcmp(dag->paths[dag->pathSlots[slot]], path) == 0) return dag->pathSlots[slot];
+  }
+  // The DAG outlives the leaves, which may be dropped while rewriting, so the path is copied.
+  const size_t length = strlen(path);
+  char* copy = safeMalloc(length + 1);
+  memcpy(copy, path, length + 1);
+  dag->paths = safeReserve(dag->paths, &dag->pathCapacity, (size_t)dag->pathCount + 1, sizeof(char*));
+  dag->paths[dag->pathCount] = copy;
+  dag->pathSlots[slot] = dag->pathCount;
+  return dag->pathCount++;
+}
+
+/* PUBLIC FUNCTIONS */
+
+ExpressionDag* ExpressionDag_new() {
+  return safeCalloc(1, sizeof(ExpressionDag));
+}
+
+void ExpressionDag_free(ExpressionDag* dag) {
+  if (dag == NULL) return;
+  for (uint32_t k = 0; k < dag->pathCount; ++k) {
+    free(dag->paths[k]);
+  }
+  free(dag->nodes);
+  free(dag->paths);
+  free(dag->nodeSlots);
+  free(dag->pathSlots);
+  free(dag);
+}
+
+uint32_t ExpressionDag_intern(ExpressionDag* dag, LanguageExpressionType type, uint32_t first, uint32_t second) {
+  if (dag->nodeSlotCapacity < 2 * ((size_t)dag->nodeCount + 1)) {
+    dag->nodeSlots = _growSlots(dag, dag->nodeSlots, &dag->nodeSlotCapacity, false);
+  }
+  const DagNode node = {.type = type, .first = first, .second = second};
+  const uint32_t mask = dag->nodeSlotCapacity - 1;
+  uint32_t slot = (uint32_t)_hashNode(&node) & mask;
+  for (; dag->nodeSlots[slot] != EMPTY_SLOT; slot = (slot + 1) & mask) {
+    const DagNode* other = &dag->nodes[dag->nodeSlots[slot]];
+    if (other->type == type && other->first == first && other->second == second) return dag->nodeSlots[slot];
+  }
+  dag->nodes = safeReserve(dag->nodes, &dag->nodeCapacity, (size_t)dag->nodeCount + 1, sizeof(DagNode));
+  dag->nodes[dag->nodeCount] = node;
+  dag->nodeSlots[slot] = dag->nodeCount;
+  return dag->nodeCount++;
+}
+
+uint32_t ExpressionDag_internLanguage(ExpressionDag* dag, SymbolTable table, const Language* language) {
+  if (language->type == WORDS_FILE) {
+    return ExpressionDag_intern(dag, LANGUAGE, WORDS_FILE, _internPath(dag, language->path.path));
+  }
+  const int64_t index = SymbolTable_indexOf(table, language->id.id);
+  return ExpressionDag_intern(dag, LANGUAGE, language->type, (uint32_t)index);
+}
+
+void ExpressionDag_countReferences(
+  const ExpressionDag* dag, const uint32_t* roots, size_t rootCount, uint32_t* references
+) {
+  memset(references, 0, dag->nodeCount * sizeof(uint32_t));
+  Bitset reachable = Bitset_new(dag->nodeCount);
+  for (size_t k = 0; k < rootCount; ++k) {
+    Bitset_set(reachable, roots[k]);
+    ++references[roots[k]];
+  }
+  // Operands come before their operators, so each node is reached before its operands are visited.
+  for (uint32_t node = dag->nodeCount; 0 < node--;) {
+    const DagNode* dagNode = &dag->nodes[node];
+    if (!Bitset_test(reachable, node) || dagNode->type == LANGUAGE) continue;
+    Bitset_set(reachable, dagNode->first);
+    ++references[dagNode->first];
+    if (DagNode_isBinary(dagNode)) {
+      Bitset_set(reachable, dagNode->second);
+      ++references[dagNode->second];
+    }
+  }
+  free(reachable);
+}
@@ -0,0 +1,77 @@
+#ifndef EXPRESSION_DAG_HEADER
+#define EXPRESSION_DAG_HEADER
+
+#include "../../frontend/semantic-analysis/SymbolTable.h"
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** The missing operand of a unary node. */
+#define NO_OPERAND UINT32_MAX
+
+/**
+ * A node of an expression DAG. An operator has the nodes of its operands (the
+ * second one is `NO_OPERAND` if it's unary, and the exponent for a power); a
+ * language has its `LanguageIdType` in `first`, and in `second` the index of
+ * the sentence it names or, for a word list, the index of its path.
+ */
+typedef struct {
+  LanguageExpressionType type;
+  uint32_t first;
+  uint32_t second;
+} DagNode;
+
+/**
+ * @return Whether the node is an operator with two operands.
+ */
+static inline bool DagNode_isBinary(const DagNode* node) {
+  return node->type != LANGUAGE && node->type != LANG_POWER && node->second != NO_OPERAND;
+}
+
+/**
+ * The hash-consed nodes of a set of expressions: a node is only added once,
+ * so the expressions (of every binding) share their identical
+ * subexpressions, and two subexpressions are identical exactly when they
+ * have the same node. Nodes are numbered in the order they're added, so
+ * operands always come before their operators.
+ */
+typedef struct {
+  DagNode* nodes;
+  uint32_t nodeCount;
+  size_t nodeCapacity;
+  // The paths of the word lists, by index.
+  char** paths;
+  uint32_t pathCount;
+  size_t pathCapacity;
+  uint32_t* nodeSlots;
+  uint32_t nodeSlotCapacity;
+  uint32_t* pathSlots;
+  uint32_t pathSlotCapacity;
+} ExpressionDag;
+
+ExpressionDag* ExpressionDag_new();
+void ExpressionDag_free(ExpressionDag* dag);
+
+/**
+ * @return The node with the given fields, added if it's new.
+ */
+uint32_t ExpressionDag_intern(ExpressionDag* dag, LanguageExpressionType type, uint32_t first, uint32_t second);
+
+/**
+ * @return The node of a language, added if it's new.
+ */
+uint32_t ExpressionDag_internLanguage(ExpressionDag* dag, SymbolTable table, const Language* language);
+
+/**
+ * Counts how many times each node is used by the nodes reachable from
+ * `roots` (once per operand), plus once per root. Unreachable nodes aren't
+ * used at all.
+ *
+ * @param references Receives the count of each node.
+ */
+void ExpressionDag_countReferences(
+  const ExpressionDag* dag, const uint32_t* roots, size_t rootCount, uint32_t* references
+);
+
+#endif
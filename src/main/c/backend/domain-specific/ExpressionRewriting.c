@@ -0,0 +1,372 @@
+#include "ExpressionRewriting.h"
+#include "../../frontend/syntactic-analysis/ASTUtils.h"
+#include "../../shared/Logger.h"
+#include "../../shared/utils.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* MODULE INTERNAL STATE */
+
+static Logger* _logger = NULL;
+
+void initializeExpressionRewritingModule() {
+  _logger = createLogger("ExpressionRewriting");
+}
+
+void shutdownExpressionRewritingModule() {
+  if (_logger != NULL) {
+    destroyLogger(_logger);
+  }
+}
+
+/**
+ * An operand of a chain, with its structural id.
+ */
+typedef struct {
+  LanguageExpression* expression;
+  uint32_t id;
+} Term;
+
+/**
+ * The state of a rewriting. Every rewritten node gets a structural id: its
+ * node in the DAG, which is the same for two nodes exactly when they're the
+ * same expression (once their chains are sorted).
+ */
+typedef struct {
+  SymbolTable table;
+  ExpressionDag* dag;
+  // The id of each node, by address.
+  const LanguageExpression** nodes;
+  uint32_t* nodeIds;
+  size_t nodeCount;
+  size_t nodeSlotCapacity;
+  // The rewritten operands of the nodes the walk hasn't reached yet.
+  LanguageExpression** stack;
+  size_t stackCount;
+  size_t stackCapacity;
+  // The operands of the chain being rebuilt, and the nodes left to flatten.
+  Term* terms;
+  size_t termCount;
+  size_t termCapacity;
+  LanguageExpression** pending;
+  size_t pendingCapacity;
+  size_t rewrites;
+  bool changed;
+} Rewriter;
+
+/* PRIVATE FUNCTIONS */
+
+static inline uint64_t _mix(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+static void _setId(Rewriter* rewriter, const LanguageExpression* expression, uint32_t id) {
+  if (rewriter->nodeSlotCapacity < 2 * (rewriter->nodeCount + 1)) {
+    const size_t oldCapacity = rewriter->nodeSlotCapacity;
+    const LanguageExpression** oldNodes = rewriter->nodes;
+    uint32_t* oldIds = rewriter->nodeIds;
+    rewriter->nodeSlotCapacity = oldCapacity == 0 ? 64 : 2 * oldCapacity;
+    rewriter->nodes = safeCalloc(rewriter->nodeSlotCapacity, sizeof(LanguageExpression*));
+    rewriter->nodeIds = safeMalloc(rewriter->nodeSlotCapacity * sizeof(uint32_t));
+    rewriter->nodeCount = 0;
+    for (size_t k = 0; k < oldCapacity; ++k) {
+      if (oldNodes[k] != NULL) _setId(rewriter, oldNodes[k], oldIds[k]);
+    }
+    free(oldNodes);
+    free(oldIds);
+  }
+  const size_t mask = rewriter->nodeSlotCapacity - 1;
+  size_t slot = (size_t)_mix((uintptr_t)expression) & mask;
+  while (rewriter->nodes[slot] != NULL && rewriter->nodes[slot] != expression) slot = (slot + 1) & mask;
+  // A freed node may share its address with a new one, whose id replaces the old one.
+  if (rewriter->nodes[slot] == NULL) ++rewriter->nodeCount;
+  rewriter->nodes[slot] = expression;
+  rewriter->nodeIds[slot] = id;
+}
+
+static uint32_t _idOf(const Rewriter* rewriter, const LanguageExpression* expression) {
+  const size_t mask = rewriter->nodeSlotCapacity - 1;
+  size_t slot = (size_t)_mix((uintptr_t)expression) & mask;
+  while (rewriter->nodes[slot] != expression) slot = (slot + 1) & mask;
+  return rewriter->nodeIds[slot];
+}
+
+static LanguageExpression* _unary(Rewriter* rewriter, LanguageExpression* expression, LanguageExpression* operand) {
+  expression->unaryLanguageExpression = operand;
+  const uint32_t id = ExpressionDag_intern(rewriter->dag, expression->type, _idOf(rewriter, operand), NO_OPERAND);
+  _setId(rewriter, expression, id);
+  return expression;
+}
+
+static LanguageExpression* _newUnary(Rewriter* rewriter, LanguageExpressionType type, LanguageExpression* operand) {
+  LanguageExpression* expression = safeMalloc(sizeof(LanguageExpression));
+  expression->type = type;
+  return _unary(rewriter, expression, operand);
+}
+
+static void _addTerm(Rewriter* rewriter, LanguageExpression* expression) {
+  rewriter->terms = safeReserve(rewriter->terms, &rewriter->termCapacity, rewriter->termCount + 1, sizeof(Term));
+  rewriter->terms[rewriter->termCount++] = (Term){.expression = expression, .id = _idOf(rewriter, expression)};
+}
+
+static int _compareTerms(const void* left, const void* right) {
+  const uint32_t a = ((const Term*)left)->id;
+  const uint32_t b = ((const Term*)right)->id;
+  return (a > b) - (a < b);
+}
+
+/**
+ * Builds a left-deep chain of the collected terms, sorted by id and without
+ * repetitions, and empties the list.
+ */
+static LanguageExpression* _buildChain(Rewriter* rewriter, LanguageExpressionType type) {
+  Term* terms = rewriter->terms;
+  if (1 < rewriter->termCount) qsort(terms, rewriter->termCount, sizeof(Term), _compareTerms);
+  LanguageExpression* chain = terms[0].expression;
+  for (size_t k = 1; k < rewriter->termCount; ++k) {
+    if (terms[k].id == terms[k - 1].id) {
+      LanguageExpression_free(terms[k].expression);
+      ++rewriter->rewrites;
+      continue;
+    }
+    LanguageExpression* expression = safeMalloc(sizeof(LanguageExpression));
+    expression->type = type;
+    expression->leftLanguageExpression = chain;
+    expression->rightLanguageExpression = terms[k].expression;
+    _setId(rewriter, expression, ExpressionDag_intern(rewriter->dag, type, _idOf(rewriter, chain), terms[k].id));
+    chain = expression;
+  }
+  rewriter->termCount = 0;
+  return chain;
+}
+
+/**
+ * Flattens the chain of `u` (or `n`) rooted at an expression, if it is one,
+ * into a canonical one. The operands were already rewritten.
+ */
+static LanguageExpression* _finishChain(Rewriter* rewriter, LanguageExpression* expression) {
+  const LanguageExpressionType type = expression->type;
+  if (type != LANG_UNION && type != LANG_INTERSEC) return expression;
+  size_t pendingCount = 0;
+  rewriter->pending = safeReserve(rewriter->pending, &rewriter->pendingCapacity, 1, sizeof(LanguageExpression*));
+  rewriter->pending[pendingCount++] = expression;
+  bool canonical = true;
+  while (0 < pendingCount) {
+    LanguageExpression* node = rewriter->pending[--pendingCount];
+    if (node->type != type) {
+      if (0 < rewriter->termCount && _idOf(rewriter, node) <= rewriter->terms[rewriter->termCount - 1].id) {
+        canonical = false;
+      }
+      _addTerm(rewriter, node);
+      continue;
+    }
+    // Operands are taken in order, left first.
+    rewriter->pending =
+      safeReserve(rewriter->pending, &rewriter->pendingCapacity, pendingCount + 2, sizeof(LanguageExpression*));
+    rewriter->pending[pendingCount++] = node->rightLanguageExpression;
+    rewriter->pending[pendingCount++] = node->leftLanguageExpression;
+    if (node->rightLanguageExpression->type == type) canonical = false;
+    free(node);
+  }
+  if (!canonical) rewriter->changed = true;
+  return _buildChain(rewriter, type);
+}
+
+static void _collectLanguage(LanguageExpression* languageExpression, void* context) {
+  if (languageExpression->type == LANGUAGE) {
+    _addTerm(context, languageExpression);
+  } else {
+    free(languageExpression);
+  }
+}
+
+/**
+ * @return The empty language over the alphabet of an expression: the union
+ *         of `E(L)` for each of its languages.
+ */
+static LanguageExpression* _emptyOver(Rewriter* rewriter, LanguageExpression* expression) {
+  LanguageExpression_walk(expression, _collectLanguage, rewriter);
+  for (size_t k = 0; k < rewriter->termCount; ++k) {
+    Term* term = &rewriter->terms[k];
+    term->expression = _newUnary(rewriter, LANG_EMPTY, term->expression);
+    term->id = _idOf(rewriter, term->expression);
+  }
+  return _buildChain(rewriter, LANG_UNION);
+}
+
+static LanguageExpression* _complement(
+  Rewriter* rewriter, LanguageExpression* expression, LanguageExpression* operand
+) {
+  if (operand->type != LANG_COMPLEMENT) return _unary(rewriter, expression, operand);
+  LanguageExpression* result = operand->unaryLanguageExpression;
+  free(operand);
+  free(expression);
+  ++rewriter->rewrites;
+  return result;
+}
+
+static LanguageExpression* _reverse(Rewriter* rewriter, LanguageExpression* expression, LanguageExpression* operand) {
+  LanguageExpression* result;
+  switch (operand->type) {
+  case LANG_REVERSE:
+    result = operand->unaryLanguageExpression;
+    free(operand);
+    free(expression);
+    break;
+  case LANG_EMPTY:
+    result = operand;
+    free(expression);
+    break;
+  case LANG_COMPLEMENT:
+    // The operand of a complement is never another one, so this goes one level deep at most.
+    result = _unary(rewriter, operand, _reverse(rewriter, expression, operand->unaryLanguageExpression));
+    break;
+  default:
+    return _unary(rewriter, expression, operand);
+  }
+  ++rewriter->rewrites;
+  return result;
+}
+
+static LanguageExpression* _closure(Rewriter* rewriter, LanguageExpression* expression, LanguageExpression* operand) {
+  if (operand->type != LANG_STAR && operand->type != LANG_PLUS) return _unary(rewriter, expression, operand);
+  ++rewriter->rewrites;
+  if (expression->type == LANG_PLUS || operand->type == LANG_STAR) {
+    free(expression);
+    return operand;
+  }
+  // The star of a plus.
+  LanguageExpression* result = _unary(rewriter, expression, operand->unaryLanguageExpression);
+  free(operand);
+  return result;
+}
+
+static LanguageExpression* _power(Rewriter* rewriter, LanguageExpression* expression, LanguageExpression* operand) {
+  if (expression->exponent == 1) {
+    free(expression);
+    ++rewriter->rewrites;
+    return operand;
+  }
+  expression->unaryLanguageExpression = operand;
+  const uint32_t id = ExpressionDag_intern(rewriter->dag, LANG_POWER, _idOf(rewriter, operand), expression->exponent);
+  _setId(rewriter, expression, id);
+  return expression;
+}
+
+static void _push(Rewriter* rewriter, LanguageExpression* expression) {
+  rewriter->stack =
+    safeReserve(rewriter->stack, &rewriter->stackCapacity, rewriter->stackCount + 1, sizeof(LanguageExpression*));
+  rewriter->stack[rewriter->stackCount++] = expression;
+}
+
+static LanguageExpression* _pop(Rewriter* rewriter) {
+  return rewriter->stack[--rewriter->stackCount];
+}
+
+/**
+ * Rewrites a node whose operands were already rewritten (and pushed). The
+ * nodes of a chain are left unfinished until its root is reached.
+ */
+static void _rewriteNode(LanguageExpression* languageExpression, void* context) {
+  Rewriter* rewriter = context;
+  const LanguageExpressionType type = languageExpression->type;
+  switch (type) {
+  case LANGUAGE:
+    _setId(
+      rewriter, languageExpression,
+      ExpressionDag_internLanguage(rewriter->dag, rewriter->table, languageExpression->language)
+    );
+    _push(rewriter, languageExpression);
+    break;
+  case LANG_REVERSE:
+    _push(rewriter, _reverse(rewriter, languageExpression, _finishChain(rewriter, _pop(rewriter))));
+    break;
+  case LANG_COMPLEMENT:
+    _push(rewriter, _complement(rewriter, languageExpression, _finishChain(rewriter, _pop(rewriter))));
+    break;
+  case LANG_STAR:
+  case LANG_PLUS:
+    _push(rewriter, _closure(rewriter, languageExpression, _finishChain(rewriter, _pop(rewriter))));
+    break;
+  case LANG_POWER:
+    _push(rewriter, _power(rewriter, languageExpression, _finishChain(rewriter, _pop(rewriter))));
+    break;
+  case LANG_EMPTY:
+    _push(rewriter, _unary(rewriter, languageExpression, _pop(rewriter)));
+    break;
+  default: {
+    LanguageExpression* right = _pop(rewriter);
+    LanguageExpression* left = _pop(rewriter);
+    if (left->type != type) left = _finishChain(rewriter, left);
+    if (right->type != type) right = _finishChain(rewriter, right);
+    languageExpression->leftLanguageExpression = left;
+    languageExpression->rightLanguageExpression = right;
+    if (type == LANG_MINUS && _idOf(rewriter, left) == _idOf(rewriter, right)) {
+      LanguageExpression_free(right);
+      free(languageExpression);
+      ++rewriter->rewrites;
+      _push(rewriter, _emptyOver(rewriter, left));
+    } else if (type == LANG_UNION || type == LANG_INTERSEC) {
+      _push(rewriter, languageExpression);
+    } else {
+      const uint32_t id = ExpressionDag_intern(rewriter->dag, type, _idOf(rewriter, left), _idOf(rewriter, right));
+      _setId(rewriter, languageExpression, id);
+      _push(rewriter, languageExpression);
+    }
+    break;
+  }
+  }
+}
+
+static size_t _countNodes(LanguageExpression** expressions[], size_t count) {
+  size_t nodeCount = 0;
+  for (size_t k = 0; k < count; ++k) {
+    nodeCount += LanguageExpression_walk(*expressions[k], NULL, NULL);
+  }
+  return nodeCount;
+}
+
+/* PUBLIC FUNCTIONS */
+
+void rewriteLanguageExpressions(
+  SymbolTable table, ExpressionDag* dag, LanguageExpression** expressions[], uint32_t* roots, size_t count
+) {
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  const size_t nodeCount = _countNodes(expressions, count);
+  Rewriter rewriter = {.table = table, .dag = dag};
+  unsigned passes = 0;
+  do {
+    rewriter.changed = false;
+    const size_t rewrites = rewriter.rewrites;
+    for (size_t k = 0; k < count; ++k) {
+      LanguageExpression_walk(*expressions[k], _rewriteNode, &rewriter);
+      *expressions[k] = _finishChain(&rewriter, _pop(&rewriter));
+    }
+    rewriter.changed = rewriter.changed || rewriter.rewrites != rewrites;
+    ++passes;
+  } while (rewriter.changed);
+  for (size_t k = 0; k < count; ++k) {
+    roots[k] = _idOf(&rewriter, *expressions[k]);
+  }
+  const size_t remaining = _countNodes(expressions, count);
+
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  const double milliseconds = 1e3 * (double)(end.tv_sec - start.tv_sec) + 1e-6 * (double)(end.tv_nsec - start.tv_nsec);
+  logDebugging(
+    _logger, "Removed %zu of %zu expression nodes with %zu rewrites (%u passes) in %.3f ms.", nodeCount - remaining,
+    nodeCount, rewriter.rewrites, passes, milliseconds
+  );
+  free(rewriter.nodes);
+  free(rewriter.nodeIds);
+  free(rewriter.stack);
+  free(rewriter.terms);
+  free(rewriter.pending);
+}
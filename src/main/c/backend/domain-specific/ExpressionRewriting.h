@@ -0,0 +1,39 @@
+#ifndef EXPRESSION_REWRITING_HEADER
+#define EXPRESSION_REWRITING_HEADER
+
+#include "../../frontend/semantic-analysis/SymbolTable.h"
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "ExpressionDag.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/** Initialize module's internal state. */
+void initializeExpressionRewritingModule();
+
+/** Shutdown module's internal state. */
+void shutdownExpressionRewritingModule();
+
+/**
+ * Rewrites language expressions in place into equivalent ones that are
+ * cheaper to evaluate, until no rule applies:
+ *
+ *   - `¬¬X` and `LR(LR(X))` become `X`.
+ *   - `LR(¬X)` becomes `¬LR(X)`, so reversals reach the grammars (which are
+ *     built reversed for free) and meet the other reversals.
+ *   - A `*` or `+` of a `*` or `+` becomes a single one (a `+` only if both
+ *     are), and `X^1` becomes `X`.
+ *   - `X - X` becomes the empty language. Its alphabet still matters to the
+ *     complements above it, so it's kept as the union of `E(L)` (the empty
+ *     language over the alphabet of `L`) for every language `L` of `X`.
+ *   - Chains of `u` (or of `n`) are flattened, their operands sorted by
+ *     their node in `dag` and the repeated ones dropped, so `X u Y u X` and
+ *     `Y u X` end up as the same expression.
+ *
+ * Each slot of `expressions` receives its rewritten expression, and the
+ * same position of `roots` its node in `dag`.
+ */
+void rewriteLanguageExpressions(
+  SymbolTable table, ExpressionDag* dag, LanguageExpression** expressions[], uint32_t* roots, size_t count
+);
+
+#endif
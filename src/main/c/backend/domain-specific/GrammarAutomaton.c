@@ -0,0 +1,531 @@
+#include "GrammarAutomaton.h"
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Bitset.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Set.h"
+#include "../../shared/SetElement.h"
+#include "../../shared/hashUtils.h"
+#include "../../shared/utils.h"
+#include "Alphabet.h"
+#include "Automaton.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* MODULE INTERNAL STATE */
+
+#define EMPTY_SLOT UINT32_MAX
+
+static Logger* _logger = NULL;
+
+void initializeGrammarAutomatonModule() {
+  _logger = createLogger("GrammarAutomaton");
+}
+
+void shutdownGrammarAutomatonModule() {
+  if (_logger != NULL) {
+    destroyLogger(_logger);
+  }
+}
+
+typedef struct {
+  const char* symbol;
+  uint32_t hash;
+  uint32_t state;
+} Slot;
+
+/**
+ * Open-addressing table from nonterminals to their states.
+ */
+typedef struct {
+  Slot* slots;
+  uint32_t capacity;
+  uint32_t count;
+} NonTerminalTable;
+
+typedef struct {
+  uint32_t from;
+  uint32_t symbol;
+  uint32_t to;
+} Edge;
+
+typedef struct {
+  Edge* edges;
+  size_t count;
+  size_t capacity;
+} EdgeList;
+
+/* PRIVATE FUNCTIONS */
+
+static Slot* _findSlot(const NonTerminalTable* table, const char* symbol, uint32_t hash) {
+  const uint32_t mask = table->capacity - 1;
+  for (uint32_t k = hash & mask;; k = (k + 1) & mask) {
+    Slot* slot = &table->slots[k];
+    if (slot->state == EMPTY_SLOT) return slot;
+    if (slot->hash == hash && strcmp(slot->symbol, symbol) == 0) return slot;
+  }
+}
+
+static void _addNonTerminal(NonTerminalTable* table, Symbol symbol) {
+  if (table->capacity < 2 * (table->count + 1)) {
+    NonTerminalTable grown = {.capacity = table->capacity == 0 ? 16 : 2 * table->capacity, .count = table->count};
+    grown.slots = safeMalloc(grown.capacity * sizeof(Slot));
+    for (uint32_t k = 0; k < grown.capacity; ++k) grown.slots[k].state = EMPTY_SLOT;
+    for (uint32_t k = 0; k < table->capacity; ++k) {
+      const Slot* slot = &table->slots[k];
+      if (slot->state != EMPTY_SLOT) *_findSlot(&grown, slot->symbol, slot->hash) = *slot;
+    }
+    free(table->slots);
+    *table = grown;
+  }
+  const uint32_t hash = murmurHash3(1, symbol.symbol, (size_t)symbol.length);
+  Slot* slot = _findSlot(table, symbol.symbol, hash);
+  if (slot->state == EMPTY_SLOT) {
+    *slot = (Slot){.symbol = symbol.symbol, .hash = hash, .state = table->count++};
+  }
+}
+
+/**
+ * @return The state of a nonterminal, or -1 if it isn't one.
+ */
+static int64_t _stateOf(const NonTerminalTable* table, const char* symbol, size_t length) {
+  if (table->count == 0) return -1;
+  const Slot* slot = _findSlot(table, symbol, murmurHash3(1, symbol, length));
+  return slot->state == EMPTY_SLOT ? -1 : (int64_t)slot->state;
+}
+
+static bool _isTerminal(SymbolSet terminals, Symbol symbol) {
+  SetElement element = {.symbol = symbol};
+  return Set_Has(terminals, element);
+}
+
+static void _addEdge(EdgeList* list, uint32_t from, uint32_t symbol, uint32_t to) {
+  if (list->count == list->capacity) {
+    list->capacity = list->capacity == 0 ? 64 : 2 * list->capacity;
+    list->edges = realloc(list->edges, list->capacity * sizeof(Edge));
+    if (list->edges == NULL) exitWithPerror(__func__, "realloc error");
+  }
+  list->edges[list->count++] = (Edge){.from = from, .symbol = symbol, .to = to};
+}
+
+/**
+ * Checks that a symbol of a production is declared, and on one side only.
+ *
+ * @return `false` (after logging the details) if it isn't.
+ */
+static bool _validateSymbol(const char* grammarId, Symbol symbol, bool terminal, bool nonTerminal) {
+  if (!terminal && !nonTerminal) {
+    logWarning(_logger, "The symbol \"%s\" of the grammar \"%s\" is not declared.", symbol.symbol, grammarId);
+    return false;
+  }
+  if (terminal && nonTerminal) {
+    logWarning(
+      _logger, "The symbol \"%s\" of the grammar \"%s\" is both a terminal and a nonterminal.", symbol.symbol,
+      grammarId
+    );
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Lays the edges out in CSR with a counting sort by source state. Edges are
+ * read as `from -symbol-> to`, or as `to -symbol-> from` when `inward`.
+ */
+static Automaton* _toAutomaton(const EdgeList* list, uint32_t stateCount, bool inward) {
+  Automaton* automaton = Automaton_new(stateCount, (uint32_t)list->count, 0);
+  memset(automaton->offsets, 0, (1 + (size_t)stateCount) * sizeof(uint32_t));
+  for (size_t k = 0; k < list->count; ++k) {
+    ++automaton->offsets[(inward ? list->edges[k].to : list->edges[k].from) + 1];
+  }
+  for (uint32_t state = 0; state < stateCount; ++state) {
+    automaton->offsets[state + 1] += automaton->offsets[state];
+  }
+  uint32_t* next = safeMalloc((stateCount == 0 ? 1 : stateCount) * sizeof(uint32_t));
+  memcpy(next, automaton->offsets, stateCount * sizeof(uint32_t));
+  for (size_t k = 0; k < list->count; ++k) {
+    const Edge* edge = &list->edges[k];
+    const uint32_t position = next[inward ? edge->to : edge->from]++;
+    automaton->symbols[position] = edge->symbol;
+    automaton->targets[position] = inward ? edge->from : edge->to;
+  }
+  free(next);
+  return automaton;
+}
+
+/**
+ * Sets the initial states to the ones in `initial`.
+ */
+static void _setInitialStates(Automaton* automaton, Bitset initial) {
+  const uint32_t count = (uint32_t)Bitset_count(initial, automaton->stateCount);
+  free(automaton->initialStates);
+  automaton->initialStates = safeMalloc((count == 0 ? 1 : count) * sizeof(uint32_t));
+  automaton->initialStateCount = 0;
+  for (uint32_t state = 0; state < automaton->stateCount; ++state) {
+    if (Bitset_test(initial, state)) automaton->initialStates[automaton->initialStateCount++] = state;
+  }
+}
+
+/**
+ * Lists the edges by their source (or by their target, when `inward`) in CSR,
+ * as indexes into the list.
+ */
+static void _indexEdges(const EdgeList* list, uint32_t stateCount, bool inward, uint32_t* offsets, uint32_t* indexes) {
+  memset(offsets, 0, (1 + (size_t)stateCount) * sizeof(uint32_t));
+  for (size_t k = 0; k < list->count; ++k) {
+    ++offsets[inward ? list->edges[k].to : list->edges[k].from];
+  }
+  for (uint32_t state = 0; state < stateCount; ++state) {
+    offsets[state + 1] += offsets[state];
+  }
+  for (size_t k = list->count; 0 < k--;) {
+    indexes[--offsets[inward ? list->edges[k].to : list->edges[k].from]] = (uint32_t)k;
+  }
+}
+
+/**
+ * Drops the unproductive nonterminals (the ones that can't derive a word:
+ * edges lead from the left-hand side of a production to the nonterminal of
+ * its right-hand side, so they're the ones that reach no end) and then the
+ * unreachable ones (from the initial symbol), with their productions. Each is
+ * a worklist search, linear in the number of productions. The remaining
+ * states are numbered in the same order, the extra state still last.
+ *
+ * @param stateCount The number of states, updated.
+ * @param initialState The state of the initial symbol, which is always kept.
+ * @param ends The states that end a derivation, renumbered.
+ */
+static void _prune(EdgeList* list, uint32_t* stateCount, uint32_t* initialState, Bitset* ends, const char* grammarId) {
+  const uint32_t count = *stateCount;
+  const uint32_t extraState = count - 1;
+  uint32_t* offsets = safeMalloc((1 + (size_t)count) * sizeof(uint32_t));
+  uint32_t* indexes = safeMalloc((list->count == 0 ? 1 : list->count) * sizeof(uint32_t));
+  uint32_t* pending = safeMalloc(count * sizeof(uint32_t));
+  Bitset productive = Bitset_new(count);
+  Bitset useful = Bitset_new(count);
+
+  _indexEdges(list, count, true, offsets, indexes);
+  uint32_t pendingCount = 0;
+  for (uint32_t state = 0; state < count; ++state) {
+    if (!Bitset_test(*ends, state)) continue;
+    Bitset_set(productive, state);
+    pending[pendingCount++] = state;
+  }
+  while (0 < pendingCount) {
+    const uint32_t state = pending[--pendingCount];
+    for (uint32_t k = offsets[state]; k < offsets[state + 1]; ++k) {
+      const uint32_t from = list->edges[indexes[k]].from;
+      if (Bitset_test(productive, from)) continue;
+      Bitset_set(productive, from);
+      pending[pendingCount++] = from;
+    }
+  }
+
+  _indexEdges(list, count, false, offsets, indexes);
+  Bitset_set(useful, *initialState);
+  Bitset_set(useful, extraState);
+  pending[pendingCount++] = *initialState;
+  while (0 < pendingCount) {
+    const uint32_t state = pending[--pendingCount];
+    if (!Bitset_test(productive, state)) continue;
+    for (uint32_t k = offsets[state]; k < offsets[state + 1]; ++k) {
+      const uint32_t to = list->edges[indexes[k]].to;
+      if (!Bitset_test(productive, to) || Bitset_test(useful, to)) continue;
+      Bitset_set(useful, to);
+      pending[pendingCount++] = to;
+    }
+  }
+
+  // The numbers of the useful states, in `offsets` (which is no longer needed).
+  uint32_t* numbers = offsets;
+  uint32_t usefulCount = 0;
+  uint32_t unproductiveCount = 0;
+  uint32_t unreachableCount = 0;
+  Bitset renumberedEnds = Bitset_new(count);
+  for (uint32_t state = 0; state < count; ++state) {
+    if (state != *initialState && !Bitset_test(productive, state)) ++unproductiveCount;
+    if (Bitset_test(productive, state) && !Bitset_test(useful, state)) ++unreachableCount;
+    if (!Bitset_test(useful, state)) continue;
+    if (Bitset_test(*ends, state)) Bitset_set(renumberedEnds, usefulCount);
+    numbers[state] = usefulCount++;
+  }
+  const size_t ruleCount = list->count;
+  size_t kept = 0;
+  for (size_t k = 0; k < ruleCount; ++k) {
+    const Edge edge = list->edges[k];
+    // The initial symbol is kept even if it's unproductive, but not its productions.
+    const bool from = Bitset_test(useful, edge.from) && Bitset_test(productive, edge.from);
+    if (!from || !Bitset_test(useful, edge.to) || !Bitset_test(productive, edge.to)) continue;
+    list->edges[kept++] = (Edge){.from = numbers[edge.from], .symbol = edge.symbol, .to = numbers[edge.to]};
+  }
+  list->count = kept;
+  logDebugging(
+    _logger, "Pruned %u unproductive and %u unreachable nonterminals (%zu of %zu rules) from the grammar \"%s\".",
+    unproductiveCount, unreachableCount, ruleCount - kept, ruleCount, grammarId
+  );
+
+  *initialState = numbers[*initialState];
+  *stateCount = usefulCount;
+  free(*ends);
+  *ends = renumberedEnds;
+  free(offsets);
+  free(indexes);
+  free(pending);
+  free(productive);
+  free(useful);
+}
+
+/* PUBLIC FUNCTIONS */
+
+Automaton* buildGrammarAutomaton(
+  const GrammarDefinition* grammar, SymbolSet terminals, SymbolSet nonTerminals, ProductionSet productions,
+  bool reversed, const char** reason
+) {
+  const char* grammarId = grammar->id.id;
+  NonTerminalTable table = {0};
+  SetIterator iterator = SetIterator_new(nonTerminals);
+  while (SetIterator_hasNext(iterator)) {
+    _addNonTerminal(&table, SetIterator_next(iterator)->symbol);
+  }
+  SetIterator_free(iterator);
+
+  // States are the nonterminals, followed by the state that ends (or begins) every derivation.
+  const uint32_t extraState = table.count;
+  const uint32_t stateCount = table.count + 1;
+  Bitset ends = Bitset_new(stateCount);
+  Bitset_set(ends, extraState);
+  EdgeList edges = {0};
+  bool rightLinear = false;
+  bool leftLinear = false;
+  *reason = NULL;
+
+  const int64_t initialSymbol =
+    _stateOf(&table, grammar->initialSymbolId.id, (size_t)grammar->initialSymbolId.length);
+  if (initialSymbol < 0) {
+    logWarning(
+      _logger, "The initial symbol \"%s\" of the grammar \"%s\" is not a nonterminal.", grammar->initialSymbolId.id,
+      grammarId
+    );
+    *reason = "the initial symbol of its grammar is not a nonterminal";
+  }
+
+  // Every production is recorded as an edge from its left-hand side to the nonterminal of its right-hand side.
+  iterator = SetIterator_new(productions);
+  while (*reason == NULL && SetIterator_hasNext(iterator)) {
+    const Production* production = SetIterator_next(iterator)->production;
+    const int64_t from = _stateOf(&table, production->lhs.symbol, (size_t)production->lhs.length);
+    if (from < 0) {
+      logWarning(
+        _logger, "The left-hand side \"%s\" of a production of \"%s\" is not a nonterminal.", production->lhs.symbol,
+        grammarId
+      );
+      *reason = "its grammar uses undeclared symbols";
+      break;
+    }
+    SetIterator rules = SetIterator_new(production->rhs);
+    while (*reason == NULL && SetIterator_hasNext(rules)) {
+      const ProductionRhsRule* rule = SetIterator_next(rules)->productionRhsRule;
+      switch (rule->type) {
+      case LAMBDA_T:
+        Bitset_set(ends, (size_t)from);
+        break;
+      case SYMBOL_T: {
+        const bool terminal = _isTerminal(terminals, rule->symbol);
+        const bool nonTerminal = 0 <= _stateOf(&table, rule->symbol.symbol, (size_t)rule->symbol.length);
+        if (!_validateSymbol(grammarId, rule->symbol, terminal, nonTerminal)) {
+          *reason = "its grammar uses undeclared or ambiguous symbols";
+        } else if (nonTerminal) {
+          logWarning(
+            _logger, "The grammar \"%s\" has a unit production (%s -> %s).", grammarId, production->lhs.symbol,
+            rule->symbol.symbol
+          );
+          *reason = "its grammar is not regular";
+        } else {
+          const uint32_t symbol = Alphabet_intern(rule->symbol.symbol, (size_t)rule->symbol.length);
+          _addEdge(&edges, (uint32_t)from, symbol, extraState);
+        }
+        break;
+      }
+      case SYMBOL_SYMBOL_T:
+      default: {
+        const bool leftTerminal = _isTerminal(terminals, rule->leftSymbol);
+        const int64_t left = _stateOf(&table, rule->leftSymbol.symbol, (size_t)rule->leftSymbol.length);
+        const bool rightTerminal = _isTerminal(terminals, rule->rightSymbol);
+        const int64_t right = _stateOf(&table, rule->rightSymbol.symbol, (size_t)rule->rightSymbol.length);
+        if (!_validateSymbol(grammarId, rule->leftSymbol, leftTerminal, 0 <= left) ||
+            !_validateSymbol(grammarId, rule->rightSymbol, rightTerminal, 0 <= right)) {
+          *reason = "its grammar uses undeclared or ambiguous symbols";
+        } else if (leftTerminal && 0 <= right) {
+          const uint32_t symbol = Alphabet_intern(rule->leftSymbol.symbol, (size_t)rule->leftSymbol.length);
+          _addEdge(&edges, (uint32_t)from, symbol, (uint32_t)right);
+          rightLinear = true;
+        } else if (0 <= left && rightTerminal) {
+          const uint32_t symbol = Alphabet_intern(rule->rightSymbol.symbol, (size_t)rule->rightSymbol.length);
+          _addEdge(&edges, (uint32_t)from, symbol, (uint32_t)left);
+          leftLinear = true;
+        } else {
+          logWarning(
+            _logger, "The grammar \"%s\" is not regular (%s -> %s %s).", grammarId, production->lhs.symbol,
+            rule->leftSymbol.symbol, rule->rightSymbol.symbol
+          );
+          *reason = "its grammar is not regular";
+        }
+        break;
+      }
+      }
+    }
+    SetIterator_free(rules);
+  }
+  SetIterator_free(iterator);
+  if (*reason == NULL && rightLinear && leftLinear) {
+    logWarning(_logger, "The grammar \"%s\" mixes right-linear and left-linear productions.", grammarId);
+    *reason = "its grammar is not regular";
+  }
+
+  Automaton* automaton = NULL;
+  if (*reason == NULL) {
+    uint32_t initialState = (uint32_t)initialSymbol;
+    uint32_t usefulCount = stateCount;
+    _prune(&edges, &usefulCount, &initialState, &ends, grammarId);
+    // Right-linear derivations read their word from the initial symbol outwards, and left-linear ones from the
+    // ends inwards, so the reversed language is the same edges read the other way.
+    const bool inward = leftLinear != reversed;
+    automaton = _toAutomaton(&edges, usefulCount, inward);
+    Bitset start = Bitset_new(usefulCount);
+    Bitset_set(start, initialState);
+    _setInitialStates(automaton, inward ? ends : start);
+    memcpy(automaton->accepting, inward ? start : ends, Bitset_words(usefulCount) * sizeof(uint64_t));
+    free(start);
+    Automaton_normalize(automaton);
+    logDebugging(
+      _logger, "Compiled the %s%s-linear grammar \"%s\": %u states, %u transitions.", reversed ? "reversed " : "",
+      leftLinear ? "left" : "right", grammarId, automaton->stateCount, automaton->transitionCount
+    );
+  }
+  free(edges.edges);
+  free(ends);
+  free(table.slots);
+  return automaton;
+}
+
+Automaton* uniteGrammarAutomata(const Automaton* left, const Automaton* right) {
+  if (left->acceptingSink || right->acceptingSink || Automaton_hasEpsilons(left) || Automaton_hasEpsilons(right)) {
+    exitInvalidArgument(__func__, "grammar automata have no epsilon transitions nor accepting sink");
+  }
+  // The states of `left`, then the ones of `right`, then the fresh initial state.
+  const uint32_t shift = left->stateCount;
+  const size_t start = (size_t)left->stateCount + right->stateCount;
+  size_t transitionCount = (size_t)left->transitionCount + right->transitionCount;
+  for (uint32_t k = 0; k < left->initialStateCount; ++k) {
+    transitionCount += left->offsets[left->initialStates[k] + 1] - left->offsets[left->initialStates[k]];
+  }
+  for (uint32_t k = 0; k < right->initialStateCount; ++k) {
+    transitionCount += right->offsets[right->initialStates[k] + 1] - right->offsets[right->initialStates[k]];
+  }
+  if (UINT32_MAX <= transitionCount || UINT32_MAX - 1 <= start) exitInvalidArgument(__func__, "the union is too large");
+
+  Automaton* automaton = Automaton_new((uint32_t)start + 1, (uint32_t)transitionCount, 1);
+  automaton->initialStates[0] = (uint32_t)start;
+  uint32_t position = 0;
+  for (uint32_t state = 0; state < left->stateCount; ++state) {
+    automaton->offsets[state] = position;
+    for (uint32_t k = left->offsets[state]; k < left->offsets[state + 1]; ++k) {
+      automaton->symbols[position] = left->symbols[k];
+      automaton->targets[position++] = left->targets[k];
+    }
+    if (Automaton_isAccepting(left, state)) Bitset_set(automaton->accepting, state);
+  }
+  for (uint32_t state = 0; state < right->stateCount; ++state) {
+    automaton->offsets[shift + state] = position;
+    for (uint32_t k = right->offsets[state]; k < right->offsets[state + 1]; ++k) {
+      automaton->symbols[position] = right->symbols[k];
+      automaton->targets[position++] = shift + right->targets[k];
+    }
+    if (Automaton_isAccepting(right, state)) Bitset_set(automaton->accepting, shift + state);
+  }
+  automaton->offsets[start] = position;
+  bool accepting = false;
+  for (uint32_t k = 0; k < left->initialStateCount; ++k) {
+    const uint32_t initial = left->initialStates[k];
+    for (uint32_t t = left->offsets[initial]; t < left->offsets[initial + 1]; ++t) {
+      automaton->symbols[position] = left->symbols[t];
+      automaton->targets[position++] = left->targets[t];
+    }
+    accepting = accepting || Automaton_isAccepting(left, initial);
+  }
+  for (uint32_t k = 0; k < right->initialStateCount; ++k) {
+    const uint32_t initial = right->initialStates[k];
+    for (uint32_t t = right->offsets[initial]; t < right->offsets[initial + 1]; ++t) {
+      automaton->symbols[position] = right->symbols[t];
+      automaton->targets[position++] = shift + right->targets[t];
+    }
+    accepting = accepting || Automaton_isAccepting(right, initial);
+  }
+  automaton->offsets[start + 1] = position;
+  if (accepting) Bitset_set(automaton->accepting, start);
+  Automaton_normalize(automaton);
+  logDebugging(
+    _logger, "United grammars of %u and %u states: %u transitions.", left->stateCount, right->stateCount,
+    automaton->transitionCount
+  );
+  return automaton;
+}
+
+Automaton* concatenateGrammarAutomata(const Automaton* left, const Automaton* right) {
+  if (left->acceptingSink || right->acceptingSink || Automaton_hasEpsilons(left) || Automaton_hasEpsilons(right)) {
+    exitInvalidArgument(__func__, "grammar automata have no epsilon transitions nor accepting sink");
+  }
+  // The states of `left`, then the ones of `right`.
+  const uint32_t shift = left->stateCount;
+  const size_t stateCount = (size_t)left->stateCount + right->stateCount;
+  size_t startCount = 0;
+  bool startAccepts = false;
+  for (uint32_t k = 0; k < right->initialStateCount; ++k) {
+    const uint32_t initial = right->initialStates[k];
+    startCount += right->offsets[initial + 1] - right->offsets[initial];
+    startAccepts = startAccepts || Automaton_isAccepting(right, initial);
+  }
+  const size_t transitionCount =
+    (size_t)left->transitionCount + right->transitionCount + (size_t)Automaton_acceptingCount(left) * startCount;
+  if (UINT32_MAX <= transitionCount || UINT32_MAX <= stateCount) {
+    exitInvalidArgument(__func__, "the concatenation is too large");
+  }
+
+  Automaton* automaton = Automaton_new((uint32_t)stateCount, (uint32_t)transitionCount, left->initialStateCount);
+  memcpy(automaton->initialStates, left->initialStates, left->initialStateCount * sizeof(uint32_t));
+  uint32_t position = 0;
+  for (uint32_t state = 0; state < left->stateCount; ++state) {
+    automaton->offsets[state] = position;
+    for (uint32_t k = left->offsets[state]; k < left->offsets[state + 1]; ++k) {
+      automaton->symbols[position] = left->symbols[k];
+      automaton->targets[position++] = left->targets[k];
+    }
+    if (!Automaton_isAccepting(left, state)) continue;
+    // Where a word of `left` may end, one of `right` may start.
+    for (uint32_t k = 0; k < right->initialStateCount; ++k) {
+      const uint32_t initial = right->initialStates[k];
+      for (uint32_t t = right->offsets[initial]; t < right->offsets[initial + 1]; ++t) {
+        automaton->symbols[position] = right->symbols[t];
+        automaton->targets[position++] = shift + right->targets[t];
+      }
+    }
+    if (startAccepts) Bitset_set(automaton->accepting, state);
+  }
+  for (uint32_t state = 0; state < right->stateCount; ++state) {
+    automaton->offsets[shift + state] = position;
+    for (uint32_t k = right->offsets[state]; k < right->offsets[state + 1]; ++k) {
+      automaton->symbols[position] = right->symbols[k];
+      automaton->targets[position++] = shift + right->targets[k];
+    }
+    if (Automaton_isAccepting(right, state)) Bitset_set(automaton->accepting, shift + state);
+  }
+  automaton->offsets[stateCount] = position;
+  Automaton_normalize(automaton);
+  logDebugging(
+    _logger, "Concatenated grammars of %u and %u states: %u transitions.", left->stateCount, right->stateCount,
+    automaton->transitionCount
+  );
+  return automaton;
+}
@@ -0,0 +1,72 @@
+#ifndef GRAMMAR_AUTOMATON_HEADER
+#define GRAMMAR_AUTOMATON_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "Automaton.h"
+#include <stdbool.h>
+
+/** Initialize module's internal state. */
+void initializeGrammarAutomatonModule();
+
+/** Shutdown module's internal state. */
+void shutdownGrammarAutomatonModule();
+
+/**
+ * Compiles a regular grammar into an NFA, for `L(G)` (or for `LR(L(G))` when
+ * `reversed`). There is one state per nonterminal plus an extra state, and
+ * each production becomes a single transition:
+ *
+ * - In a right-linear grammar, `A -> a B` becomes `A -a-> B`, `A -> a`
+ *   becomes `A -a-> extra`, and `A -> lambda` makes `A` accepting. The initial
+ *   symbol is the initial state.
+ * - In a left-linear grammar, `A -> B a` becomes `B -a-> A`, `A -> a` becomes
+ *   `extra -a-> A`, and `A -> lambda` makes `A` initial (as the extra state
+ *   is). The initial symbol is the accepting state.
+ *
+ * Reversing the language just reverses the direction of every transition and
+ * swaps the initial and accepting states, so both orientations are built
+ * directly, in a single pass over the productions, and no language is ever
+ * reversed twice. Terminals are interned in the global alphabet.
+ *
+ * Before building the automaton, the nonterminals that can't end a word
+ * (unproductive) or can't be reached from the initial symbol (unreachable)
+ * are dropped along with their productions, as they can't change the
+ * language but would make every later operation larger.
+ *
+ * @return A heap-allocated automaton, or NULL (after logging the details) if
+ *         the grammar isn't regular or uses undeclared symbols, with `reason`
+ *         describing why.
+ */
+Automaton* buildGrammarAutomaton(
+  const GrammarDefinition* grammar, SymbolSet terminals, SymbolSet nonTerminals, ProductionSet productions,
+  bool reversed, const char** reason
+);
+
+/**
+ * Builds the automaton of the union of two compiled grammars, as the grammar
+ * with a fresh initial symbol `S -> α` for every `S1 -> α` and `S2 -> α` of
+ * their initial symbols would compile: a new initial state with the
+ * transitions of the initial states of both. The nonterminals keep their
+ * states, those of `right` after the ones of `left`, so nothing is renamed
+ * but by an offset, and no epsilon transition is added.
+ *
+ * Both automata must have no epsilon transitions nor accepting sink (which
+ * holds for compiled grammars and for the results of these constructions).
+ *
+ * @return A heap-allocated automaton, in O(|P|) for the productions of both.
+ */
+Automaton* uniteGrammarAutomata(const Automaton* left, const Automaton* right);
+
+/**
+ * Builds the automaton of the concatenation of two compiled grammars, as the
+ * grammar where each rule `A -> a` of `left` becomes `A -> a S2` (and each
+ * `A -> lambda` takes the rules of `S2`) would compile: the accepting states
+ * of `left` get the transitions of the initial states of `right`, and stay
+ * accepting only if one of them is. States are numbered as in
+ * `uniteGrammarAutomata`, and no epsilon transition is added.
+ *
+ * @return A heap-allocated automaton.
+ */
+Automaton* concatenateGrammarAutomata(const Automaton* left, const Automaton* right);
+
+#endif
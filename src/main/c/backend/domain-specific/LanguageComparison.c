@@ -0,0 +1,449 @@
+#include "LanguageComparison.h"
+#include "../../shared/Logger.h"
+#include "../../shared/utils.h"
+#include "Automaton.h"
+#include "Determinization.h"
+#include "EpsilonRemoval.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* MODULE INTERNAL STATE */
+
+#define NO_NODE UINT32_MAX
+
+static Logger* _logger = NULL;
+
+void initializeLanguageComparisonModule() {
+  _logger = createLogger("LanguageComparison");
+}
+
+void shutdownLanguageComparisonModule() {
+  if (_logger != NULL) {
+    destroyLogger(_logger);
+  }
+}
+
+/**
+ * The nodes of a breadth-first search, each one with the node it was found
+ * from and the symbol read, so the word that reaches it can be rebuilt.
+ */
+typedef struct {
+  uint32_t* parents;
+  uint32_t* symbols;
+  size_t count;
+  size_t capacity;
+} Trace;
+
+/**
+ * A node of the inclusion search: a state of the left automaton, and the set
+ * of states of the right one (a sorted slice of the pool). The pairs with the
+ * same state are linked in its antichain.
+ */
+typedef struct {
+  uint32_t state;
+  uint32_t setBegin;
+  uint32_t setSize;
+  uint32_t next;
+  bool alive;
+} Pair;
+
+typedef struct {
+  const Automaton* left;
+  const Automaton* right;
+  Trace trace;
+  // The pairs found, indexed as the nodes of the trace.
+  Pair* pairs;
+  size_t pairCapacity;
+  uint32_t* pool;
+  size_t poolCount;
+  size_t poolCapacity;
+  // The first pair of the antichain of each left state.
+  uint32_t* heads;
+  uint32_t subsumed;
+  uint32_t found;
+} InclusionSearch;
+
+/* PRIVATE FUNCTIONS */
+
+static int _compareStates(const void* left, const void* right) {
+  const uint32_t a = *(const uint32_t*)left;
+  const uint32_t b = *(const uint32_t*)right;
+  return (a > b) - (a < b);
+}
+
+static double _millisecondsSince(const struct timespec* start) {
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  return 1e3 * (double)(end.tv_sec - start->tv_sec) + 1e-6 * (double)(end.tv_nsec - start->tv_nsec);
+}
+
+/**
+ * @return The index of the new node.
+ */
+static uint32_t _addNode(Trace* trace, uint32_t parent, uint32_t symbol) {
+  if (trace->count == trace->capacity) {
+    trace->capacity = trace->capacity == 0 ? 64 : 2 * trace->capacity;
+    trace->parents = realloc(trace->parents, trace->capacity * sizeof(uint32_t));
+    trace->symbols = realloc(trace->symbols, trace->capacity * sizeof(uint32_t));
+    if (trace->parents == NULL || trace->symbols == NULL) exitWithPerror(__func__, "realloc error");
+  }
+  trace->parents[trace->count] = parent;
+  trace->symbols[trace->count] = symbol;
+  return (uint32_t)trace->count++;
+}
+
+static Word _traceWord(const Trace* trace, uint32_t node) {
+  uint32_t length = 0;
+  for (uint32_t n = node; trace->parents[n] != NO_NODE; n = trace->parents[n]) ++length;
+  Word word = {.symbols = length == 0 ? NULL : safeMalloc(length * sizeof(uint32_t)), .length = length};
+  uint32_t position = length;
+  for (uint32_t n = node; trace->parents[n] != NO_NODE; n = trace->parents[n]) {
+    word.symbols[--position] = trace->symbols[n];
+  }
+  return word;
+}
+
+static void _freeTrace(Trace* trace) {
+  free(trace->parents);
+  free(trace->symbols);
+}
+
+/**
+ * @return An equivalent automaton without epsilon transitions nor an implicit
+ *         sink: the same one, or one stored in `owned` (else NULL).
+ */
+static const Automaton* _withoutEpsilons(const Automaton* automaton, Automaton** owned) {
+  *owned = NULL;
+  if (automaton->acceptingSink) {
+    *owned = Automaton_materializeSink(automaton);
+    automaton = *owned;
+  }
+  if (Automaton_hasEpsilons(automaton)) {
+    Automaton* epsilonFree = removeEpsilons(automaton);
+    Automaton_free(*owned);
+    *owned = epsilonFree;
+    automaton = epsilonFree;
+  }
+  return automaton;
+}
+
+/**
+ * @return An equivalent DFA without an implicit sink: the same automaton, or
+ *         one stored in `owned` (else NULL).
+ */
+static const Automaton* _deterministic(const Automaton* automaton, Automaton** owned) {
+  automaton = _withoutEpsilons(automaton, owned);
+  if (automaton->deterministic) return automaton;
+  Automaton* dfa = determinize(automaton, NULL);
+  Automaton_free(*owned);
+  *owned = dfa;
+  return dfa;
+}
+
+static bool _isSubset(const uint32_t* small, uint32_t smallSize, const uint32_t* large, uint32_t largeSize) {
+  if (largeSize < smallSize) return false;
+  uint32_t j = 0;
+  for (uint32_t k = 0; k < smallSize; ++k) {
+    while (j < largeSize && large[j] < small[k]) ++j;
+    if (j == largeSize || large[j] != small[k]) return false;
+    ++j;
+  }
+  return true;
+}
+
+static bool _hasAccepting(const Automaton* automaton, const uint32_t* states, uint32_t size) {
+  for (uint32_t k = 0; k < size; ++k) {
+    if (Automaton_isAccepting(automaton, states[k])) return true;
+  }
+  return false;
+}
+
+/**
+ * Sorts a list of states and drops the repeated ones.
+ *
+ * @return The number of distinct states.
+ */
+static uint32_t _sortStates(uint32_t* states, uint32_t count) {
+  if (1 < count) qsort(states, count, sizeof(uint32_t), _compareStates);
+  uint32_t size = 0;
+  for (uint32_t k = 0; k < count; ++k) {
+    if (size == 0 || states[size - 1] != states[k]) states[size++] = states[k];
+  }
+  return size;
+}
+
+/**
+ * Computes the states an automaton can reach from a set of states reading a
+ * symbol, into `buffer`.
+ *
+ * @return The number of states reached.
+ */
+static uint32_t _post(
+  const Automaton* automaton, const uint32_t* states, uint32_t size, uint32_t symbol, uint32_t** buffer,
+  size_t* capacity
+) {
+  size_t count = 0;
+  for (uint32_t s = 0; s < size; ++s) {
+    // Rows are sorted by symbol, so the transitions on `symbol` are found by binary search.
+    uint32_t low = automaton->offsets[states[s]];
+    uint32_t high = automaton->offsets[states[s] + 1];
+    const uint32_t end = high;
+    while (low < high) {
+      const uint32_t middle = low + (high - low) / 2;
+      if (automaton->symbols[middle] < symbol) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    for (; low < end && automaton->symbols[low] == symbol; ++low) {
+      *buffer = safeReserve(*buffer, capacity, count + 1, sizeof(uint32_t));
+      (*buffer)[count++] = automaton->targets[low];
+    }
+  }
+  return _sortStates(*buffer, (uint32_t)count);
+}
+
+/**
+ * Adds a pair to the search, unless a pair of its antichain has a subset of
+ * its states, and drops the pairs of the antichain that have a superset.
+ * Finding a pair that accepts a word of the left automaton only ends the
+ * search.
+ */
+static void _addPair(
+  InclusionSearch* search, uint32_t state, const uint32_t* set, uint32_t size, uint32_t parent, uint32_t symbol
+) {
+  uint32_t previous = NO_NODE;
+  for (uint32_t id = search->heads[state]; id != NO_NODE;) {
+    Pair* pair = &search->pairs[id];
+    const uint32_t next = pair->next;
+    const uint32_t* other = search->pool + pair->setBegin;
+    if (_isSubset(other, pair->setSize, set, size)) {
+      ++search->subsumed;
+      return;
+    }
+    if (_isSubset(set, size, other, pair->setSize)) {
+      ++search->subsumed;
+      pair->alive = false;
+      if (previous == NO_NODE) {
+        search->heads[state] = next;
+      } else {
+        search->pairs[previous].next = next;
+      }
+    } else {
+      previous = id;
+    }
+    id = next;
+  }
+  search->pool = safeReserve(search->pool, &search->poolCapacity, search->poolCount + size, sizeof(uint32_t));
+  if (0 < size) memcpy(search->pool + search->poolCount, set, size * sizeof(uint32_t));
+  const uint32_t id = _addNode(&search->trace, parent, symbol);
+  search->pairs = safeReserve(search->pairs, &search->pairCapacity, (size_t)id + 1, sizeof(Pair));
+  search->pairs[id] = (Pair){
+    .state = state,
+    .setBegin = (uint32_t)search->poolCount,
+    .setSize = size,
+    .next = search->heads[state],
+    .alive = true,
+  };
+  search->heads[state] = id;
+  search->poolCount += size;
+  if (Automaton_isAccepting(search->left, state) && !_hasAccepting(search->right, set, size)) search->found = id;
+}
+
+/**
+ * Adds the successors of a pair, computing the set of the right automaton
+ * once per symbol the left state reads.
+ */
+static void _expandPair(InclusionSearch* search, uint32_t id, uint32_t** buffer, size_t* bufferCapacity) {
+  const Automaton* left = search->left;
+  const Pair pair = search->pairs[id];
+  // The pool moves as pairs are added, so the set is read from a copy.
+  uint32_t* set = safeMalloc((pair.setSize == 0 ? 1 : pair.setSize) * sizeof(uint32_t));
+  if (0 < pair.setSize) memcpy(set, search->pool + pair.setBegin, pair.setSize * sizeof(uint32_t));
+  const uint32_t end = left->offsets[pair.state + 1];
+  for (uint32_t k = left->offsets[pair.state]; k < end && search->found == NO_NODE;) {
+    const uint32_t symbol = left->symbols[k];
+    const uint32_t size = _post(search->right, set, pair.setSize, symbol, buffer, bufferCapacity);
+    for (; k < end && left->symbols[k] == symbol && search->found == NO_NODE; ++k) {
+      _addPair(search, left->targets[k], *buffer, size, id, symbol);
+    }
+  }
+  free(set);
+}
+
+static inline uint32_t _find(uint32_t* parents, uint32_t element) {
+  while (parents[element] != element) {
+    parents[element] = parents[parents[element]];
+    element = parents[element];
+  }
+  return element;
+}
+
+/* PUBLIC FUNCTIONS */
+
+bool findAcceptedWord(const Automaton* automaton, Word* word) {
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  Automaton* owned;
+  const Automaton* nfa = _withoutEpsilons(automaton, &owned);
+  const size_t size = nfa->stateCount == 0 ? 1 : nfa->stateCount;
+  uint32_t* nodes = safeMalloc(size * sizeof(uint32_t));
+  memset(nodes, 0xFF, size * sizeof(uint32_t));
+  uint32_t* states = safeMalloc(size * sizeof(uint32_t));
+  Trace trace = {0};
+  for (uint32_t k = 0; k < nfa->initialStateCount; ++k) {
+    const uint32_t state = nfa->initialStates[k];
+    if (nodes[state] != NO_NODE) continue;
+    nodes[state] = _addNode(&trace, NO_NODE, 0);
+    states[nodes[state]] = state;
+  }
+  uint32_t found = NO_NODE;
+  for (uint32_t id = 0; id < trace.count; ++id) {
+    const uint32_t state = states[id];
+    if (Automaton_isAccepting(nfa, state)) {
+      found = id;
+      break;
+    }
+    for (uint32_t k = nfa->offsets[state]; k < nfa->offsets[state + 1]; ++k) {
+      const uint32_t target = nfa->targets[k];
+      if (nodes[target] != NO_NODE) continue;
+      nodes[target] = _addNode(&trace, id, nfa->symbols[k]);
+      states[nodes[target]] = target;
+    }
+  }
+  if (found != NO_NODE) *word = _traceWord(&trace, found);
+  logDebugging(
+    _logger, "Searched an accepted word through %zu of %u states in %.3f ms.", trace.count, nfa->stateCount,
+    _millisecondsSince(&start)
+  );
+  _freeTrace(&trace);
+  free(nodes);
+  free(states);
+  Automaton_free(owned);
+  return found != NO_NODE;
+}
+
+bool findUnincludedWord(const Automaton* left, const Automaton* right, Word* word) {
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  Automaton* ownedLeft;
+  Automaton* ownedRight;
+  InclusionSearch search = {
+    .left = _withoutEpsilons(left, &ownedLeft),
+    .right = _withoutEpsilons(right, &ownedRight),
+    .found = NO_NODE,
+  };
+  const size_t size = search.left->stateCount == 0 ? 1 : search.left->stateCount;
+  search.heads = safeMalloc(size * sizeof(uint32_t));
+  search.pool = safeReserve(NULL, &search.poolCapacity, 1, sizeof(uint32_t));
+  memset(search.heads, 0xFF, size * sizeof(uint32_t));
+
+  size_t bufferCapacity = 0;
+  uint32_t* buffer = safeReserve(NULL, &bufferCapacity, search.right->initialStateCount + 1, sizeof(uint32_t));
+  if (0 < search.right->initialStateCount) {
+    memcpy(buffer, search.right->initialStates, search.right->initialStateCount * sizeof(uint32_t));
+  }
+  const uint32_t initialSize = _sortStates(buffer, search.right->initialStateCount);
+  for (uint32_t k = 0; k < search.left->initialStateCount && search.found == NO_NODE; ++k) {
+    _addPair(&search, search.left->initialStates[k], buffer, initialSize, NO_NODE, 0);
+  }
+  // The pairs are a worklist: each one is expanded once, in the order it was found, unless it was subsumed.
+  for (uint32_t id = 0; id < search.trace.count && search.found == NO_NODE; ++id) {
+    if (search.pairs[id].alive) _expandPair(&search, id, &buffer, &bufferCapacity);
+  }
+  const bool found = search.found != NO_NODE;
+  if (found) *word = _traceWord(&search.trace, search.found);
+
+  logDebugging(
+    _logger, "Searched a word of %u states rejected by %u states through %zu pairs (%u subsumed) in %.3f ms.",
+    search.left->stateCount, search.right->stateCount, search.trace.count, search.subsumed,
+    _millisecondsSince(&start)
+  );
+  free(buffer);
+  free(search.heads);
+  free(search.pool);
+  free(search.pairs);
+  _freeTrace(&search.trace);
+  Automaton_free(ownedLeft);
+  Automaton_free(ownedRight);
+  return found;
+}
+
+bool findDistinguishingWord(const Automaton* left, const Automaton* right, Word* word, bool* inLeft) {
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  Automaton* ownedLeft;
+  Automaton* ownedRight;
+  const Automaton* leftDfa = _deterministic(left, &ownedLeft);
+  const Automaton* rightDfa = _deterministic(right, &ownedRight);
+
+  // The states of both DFAs are numbered together, followed by the rejecting state of both (a partial DFA's).
+  const uint32_t offset = leftDfa->stateCount;
+  const uint32_t rejecting = offset + rightDfa->stateCount;
+  uint32_t* classes = safeMalloc(((size_t)rejecting + 1) * sizeof(uint32_t));
+  for (uint32_t k = 0; k <= rejecting; ++k) {
+    classes[k] = k;
+  }
+  uint64_t* pairs = NULL;
+  size_t pairCapacity = 0;
+  Trace trace = {0};
+  const uint32_t leftInitial = leftDfa->initialStateCount == 0 ? rejecting : leftDfa->initialStates[0];
+  const uint32_t rightInitial = rightDfa->initialStateCount == 0 ? rejecting : offset + rightDfa->initialStates[0];
+  pairs = safeReserve(pairs, &pairCapacity, 1, sizeof(uint64_t));
+  pairs[_addNode(&trace, NO_NODE, 0)] = (uint64_t)leftInitial << 32 | rightInitial;
+  classes[_find(classes, leftInitial)] = _find(classes, rightInitial);
+
+  uint32_t found = NO_NODE;
+  for (uint32_t id = 0; id < trace.count; ++id) {
+    const uint32_t p = (uint32_t)(pairs[id] >> 32);
+    const uint32_t q = (uint32_t)pairs[id];
+    const bool leftAccepts = p != rejecting && Automaton_isAccepting(leftDfa, p);
+    const bool rightAccepts = q != rejecting && Automaton_isAccepting(rightDfa, q - offset);
+    if (leftAccepts != rightAccepts) {
+      found = id;
+      *inLeft = leftAccepts;
+      break;
+    }
+    // Both rows are sorted, so they're merged; a symbol missing from a row leads to the rejecting state.
+    uint32_t i = p == rejecting ? 0 : leftDfa->offsets[p];
+    const uint32_t leftEnd = p == rejecting ? 0 : leftDfa->offsets[p + 1];
+    uint32_t j = q == rejecting ? 0 : rightDfa->offsets[q - offset];
+    const uint32_t rightEnd = q == rejecting ? 0 : rightDfa->offsets[q - offset + 1];
+    while (i < leftEnd || j < rightEnd) {
+      uint32_t symbol;
+      uint32_t nextLeft = rejecting;
+      uint32_t nextRight = rejecting;
+      if (j == rightEnd || (i < leftEnd && leftDfa->symbols[i] <= rightDfa->symbols[j])) {
+        symbol = leftDfa->symbols[i];
+      } else {
+        symbol = rightDfa->symbols[j];
+      }
+      if (i < leftEnd && leftDfa->symbols[i] == symbol) nextLeft = leftDfa->targets[i++];
+      if (j < rightEnd && rightDfa->symbols[j] == symbol) nextRight = offset + rightDfa->targets[j++];
+      const uint32_t leftClass = _find(classes, nextLeft);
+      const uint32_t rightClass = _find(classes, nextRight);
+      if (leftClass == rightClass) continue;
+      classes[leftClass] = rightClass;
+      const uint32_t node = _addNode(&trace, id, symbol);
+      pairs = safeReserve(pairs, &pairCapacity, (size_t)node + 1, sizeof(uint64_t));
+      pairs[node] = (uint64_t)nextLeft << 32 | nextRight;
+    }
+  }
+  if (found != NO_NODE) *word = _traceWord(&trace, found);
+
+  logDebugging(
+    _logger, "Compared DFAs of %u and %u states through %zu pairs in %.3f ms.", leftDfa->stateCount,
+    rightDfa->stateCount, trace.count, _millisecondsSince(&start)
+  );
+  free(classes);
+  free(pairs);
+  _freeTrace(&trace);
+  Automaton_free(ownedLeft);
+  Automaton_free(ownedRight);
+  return found != NO_NODE;
+}
@@ -0,0 +1,60 @@
+#ifndef LANGUAGE_COMPARISON_HEADER
+#define LANGUAGE_COMPARISON_HEADER
+
+#include "Automaton.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Initialize module's internal state. */
+void initializeLanguageComparisonModule();
+
+/** Shutdown module's internal state. */
+void shutdownLanguageComparisonModule();
+
+/**
+ * A word over the symbols the automata are labeled with. Its symbols are
+ * heap-allocated (or NULL, for the empty word).
+ */
+typedef struct {
+  uint32_t* symbols;
+  uint32_t length;
+} Word;
+
+/**
+ * Searches a word accepted by an automaton, breadth-first from its initial
+ * states, so the first accepting state found gives a shortest one.
+ *
+ * @return Whether the language isn't empty. If so, `word` receives a
+ *         shortest word in it.
+ */
+bool findAcceptedWord(const Automaton* automaton, Word* word);
+
+/**
+ * Searches a word of `left` that `right` rejects, without determinizing
+ * either automaton: the search runs over pairs of a state of `left` and the
+ * set of states `right` can be in after the same word. A pair whose set
+ * contains the set of another pair with the same state can only reach
+ * accepting pairs the smaller one reaches too, so only the minimal pairs are
+ * kept (an antichain), and the search stops at the first accepting state of
+ * `left` paired with no accepting state of `right`.
+ *
+ * @return Whether L(left) isn't included in L(right). If so, `word` receives
+ *         a word in the difference.
+ */
+bool findUnincludedWord(const Automaton* left, const Automaton* right, Word* word);
+
+/**
+ * Searches a word in exactly one of two languages with Hopcroft and Karp's
+ * algorithm: their DFAs are walked in parallel from the pair of initial
+ * states, and each pair found is merged into a union-find of states assumed
+ * equivalent, so no pair of classes is explored twice. The search stops at
+ * the first pair where one state accepts and the other doesn't.
+ *
+ * @param inLeft If a word is found, receives whether it's the left language
+ *        the one that has it.
+ * @return Whether the languages are different. If so, `word` receives a word
+ *         in only one of them.
+ */
+bool findDistinguishingWord(const Automaton* left, const Automaton* right, Word* word, bool* inLeft);
+
+#endif
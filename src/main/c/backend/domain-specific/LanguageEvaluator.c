@@ -0,0 +1,1443 @@
+#include "LanguageEvaluator.h"
+#include "../../frontend/semantic-analysis/SymbolTable.h"
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Array.h"
+#include "../../shared/Bitset.h"
+#include "../../shared/Environment.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Set.h"
+#include "../../shared/SetElement.h"
+#include "../../shared/String.h"
+#include "../../shared/utils.h"
+#include "Alphabet.h"
+#include "Automaton.h"
+#include "Determinization.h"
+#include "ExpressionDag.h"
+#include "ExpressionRewriting.h"
+#include "GrammarAutomaton.h"
+#include "LanguageComparison.h"
+#include "LazyDfa.h"
+#include "Minimization.h"
+#include "Product.h"
+#include "SymbolClasses.h"
+#include "WordListAutomaton.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Which intermediate automata are minimized. The result of each binding is
+ * always minimized, since it's memoized and emitted.
+ */
+typedef enum {
+  // After every operator.
+  MINIMIZE_ALWAYS,
+  // Only the result of each binding.
+  MINIMIZE_ROOT,
+  // After the operators whose result has more states than the threshold.
+  MINIMIZE_THRESHOLD
+} MinimizationPolicy;
+
+/**
+ * Which operands of a union or an intersection are determinized first, so
+ * they're combined by a DFA product. When either one is still an NFA, the
+ * union just puts them side by side and the intersection is a product of
+ * NFAs. The complement and the difference always determinize their operands.
+ */
+typedef enum {
+  // Every operand.
+  DETERMINIZE_EAGERLY,
+  // None.
+  DETERMINIZE_LAZILY,
+  // The operands with at most as many states as the threshold, which are cheap to determinize.
+  DETERMINIZE_BY_COST
+} DeterminizationPolicy;
+
+/* MODULE INTERNAL STATE */
+
+static Logger* _logger = NULL;
+static MinimizationPolicy _minimizationPolicy = MINIMIZE_THRESHOLD;
+static uint32_t _minimizationThreshold = 1000;
+static DeterminizationPolicy _determinizationPolicy = DETERMINIZE_BY_COST;
+static uint32_t _determinizationThreshold = 64;
+
+void initializeLanguageEvaluatorModule() {
+  _logger = createLogger("LanguageEvaluator");
+  const char* policy = getStringOrDefault("MINIMIZATION_POLICY", "threshold");
+  if (strcmp(policy, "always") == 0) {
+    _minimizationPolicy = MINIMIZE_ALWAYS;
+  } else if (strcmp(policy, "root") == 0) {
+    _minimizationPolicy = MINIMIZE_ROOT;
+  } else if (strcmp(policy, "threshold") == 0) {
+    _minimizationPolicy = MINIMIZE_THRESHOLD;
+  } else {
+    logWarning(_logger, "Unknown minimization policy \"%s\", using \"threshold\".", policy);
+    _minimizationPolicy = MINIMIZE_THRESHOLD;
+  }
+  const long long threshold = getIntegerOrDefault("MINIMIZATION_THRESHOLD", 1000);
+  if (threshold < 0 || UINT32_MAX < threshold) {
+    logWarning(_logger, "Invalid minimization threshold %lld, using 1000.", threshold);
+    _minimizationThreshold = 1000;
+  } else {
+    _minimizationThreshold = (uint32_t)threshold;
+  }
+  const char* determinization = getStringOrDefault("DETERMINIZATION_POLICY", "cost");
+  if (strcmp(determinization, "eager") == 0) {
+    _determinizationPolicy = DETERMINIZE_EAGERLY;
+  } else if (strcmp(determinization, "lazy") == 0) {
+    _determinizationPolicy = DETERMINIZE_LAZILY;
+  } else if (strcmp(determinization, "cost") == 0) {
+    _determinizationPolicy = DETERMINIZE_BY_COST;
+  } else {
+    logWarning(_logger, "Unknown determinization policy \"%s\", using \"cost\".", determinization);
+    _determinizationPolicy = DETERMINIZE_BY_COST;
+  }
+  const long long determinizationThreshold = getIntegerOrDefault("DETERMINIZATION_THRESHOLD", 64);
+  if (determinizationThreshold < 0 || UINT32_MAX < determinizationThreshold) {
+    logWarning(_logger, "Invalid determinization threshold %lld, using 64.", determinizationThreshold);
+    _determinizationThreshold = 64;
+  } else {
+    _determinizationThreshold = (uint32_t)determinizationThreshold;
+  }
+}
+
+void shutdownLanguageEvaluatorModule() {
+  if (_logger != NULL) {
+    destroyLogger(_logger);
+  }
+}
+
+/**
+ * A sorted list of distinct symbol ids.
+ */
+typedef struct {
+  uint32_t* symbols;
+  uint32_t size;
+} SymbolList;
+
+/**
+ * A value of the expression being walked. `L(G)` leaves are kept unbuilt
+ * until an operator needs them, so that `LR(L(G))` is built reversed from the
+ * grammar instead of being reversed afterwards. Unions and concatenations of
+ * grammars (and of their results) are built at the level of the grammars,
+ * without epsilon transitions, and remember it in `fromGrammars`.
+ *
+ * Each value also carries the alphabet its expression ranges over, which is
+ * what a complement is taken with respect to: the terminals of the grammars
+ * it mentions, and the symbols of the word lists.
+ */
+typedef struct {
+  Automaton* automaton;
+  // The sentence index of a grammar that isn't built yet, or -1.
+  int64_t grammar;
+  bool reversed;
+  bool fromGrammars;
+  SymbolList alphabet;
+} Operand;
+
+/**
+ * The cached operand of a node of the expression DAG. It's computed once,
+ * and every use shares its automaton, so it's released as soon as the last
+ * operator (or binding) that needs it is done with it.
+ */
+typedef struct {
+  Operand operand;
+  // The operators and roots that haven't taken it yet.
+  uint32_t references;
+  bool evaluated;
+  bool collected;
+  // Estimates of the states of its automaton, and of the most states held at once while evaluating it.
+  uint64_t states;
+  uint64_t need;
+  bool estimated;
+  // Why it can't be evaluated, if it can't.
+  const char* reason;
+} CachedOperand;
+
+/**
+ * The state of an evaluation. Each grammar and language binding evaluates to
+ * an automaton, or to NULL if it can't be evaluated (with the reason).
+ * Grammars are built on demand, once per orientation.
+ *
+ * The expressions of every binding are hash-consed into a single DAG, so a
+ * subexpression is evaluated once no matter how many bindings repeat it.
+ *
+ * The leaves of every expression are built before evaluating any of them, to
+ * partition the alphabet into the classes of symbols they don't distinguish.
+ * From then on, every automaton and alphabet is labeled with classes.
+ */
+typedef struct {
+  SymbolTable table;
+  Program* program;
+  Automaton** automata;
+  Automaton** reversedAutomata;
+  const char** reasons;
+  // The alphabet of each grammar and language binding, once inferred.
+  SymbolList* alphabets;
+  SymbolClasses* classes;
+  ExpressionDag* dag;
+  // The nodes of the expressions of each sentence (two for an inclusion or an equivalence).
+  uint32_t* roots;
+  CachedOperand* cache;
+  size_t reuseCount;
+  // The word list of each path of the DAG, until its node is evaluated.
+  Automaton** wordLists;
+  // The reason of the first unsupported construct found in the node.
+  const char* reason;
+  bool failed;
+} Evaluation;
+
+/* PRIVATE FUNCTIONS */
+
+static Operand _automatonOperand(Automaton* automaton, SymbolList alphabet) {
+  return (Operand){.automaton = automaton, .grammar = -1, .reversed = false, .alphabet = alphabet};
+}
+
+static void _unsupported(Evaluation* evaluation, const char* reason) {
+  if (evaluation->reason == NULL) evaluation->reason = reason;
+}
+
+static ProductOperation _productOperation(LanguageExpressionType type) {
+  switch (type) {
+  case LANG_UNION:
+    return PRODUCT_UNION;
+  case LANG_INTERSEC:
+    return PRODUCT_INTERSECTION;
+  default:
+    return PRODUCT_DIFFERENCE;
+  }
+}
+
+static int _compareSymbols(const void* left, const void* right) {
+  const uint32_t a = *(const uint32_t*)left;
+  const uint32_t b = *(const uint32_t*)right;
+  return (a > b) - (a < b);
+}
+
+/**
+ * Sorts a list of symbols and drops the repeated ones.
+ */
+static SymbolList _toSymbolList(uint32_t* symbols, uint32_t count) {
+  qsort(symbols, count, sizeof(uint32_t), _compareSymbols);
+  uint32_t size = 0;
+  for (uint32_t k = 0; k < count; ++k) {
+    if (size == 0 || symbols[size - 1] != symbols[k]) symbols[size++] = symbols[k];
+  }
+  return (SymbolList){.symbols = symbols, .size = size};
+}
+
+static SymbolList _copySymbolList(SymbolList list) {
+  uint32_t* symbols = safeMalloc((list.size == 0 ? 1 : list.size) * sizeof(uint32_t));
+  if (0 < list.size) memcpy(symbols, list.symbols, list.size * sizeof(uint32_t));
+  return (SymbolList){.symbols = symbols, .size = list.size};
+}
+
+static SymbolList _mergeSymbolLists(SymbolList left, SymbolList right) {
+  uint32_t* symbols = safeMalloc((left.size + right.size == 0 ? 1 : left.size + right.size) * sizeof(uint32_t));
+  uint32_t size = 0;
+  uint32_t i = 0;
+  uint32_t j = 0;
+  while (i < left.size || j < right.size) {
+    if (j == right.size || (i < left.size && left.symbols[i] < right.symbols[j])) {
+      symbols[size++] = left.symbols[i++];
+    } else if (i == left.size || right.symbols[j] < left.symbols[i]) {
+      symbols[size++] = right.symbols[j++];
+    } else {
+      symbols[size++] = left.symbols[i++];
+      ++j;
+    }
+  }
+  return (SymbolList){.symbols = symbols, .size = size};
+}
+
+/**
+ * @return The terminals of a grammar (inferred once), as interned symbols.
+ */
+static SymbolList _grammarAlphabet(Evaluation* evaluation, size_t index) {
+  SymbolList* alphabet = &evaluation->alphabets[index];
+  if (alphabet->symbols != NULL) return *alphabet;
+  GrammarDefinition* grammar = Array_get(evaluation->program->sentences, index).sentence->grammarDefinition;
+  SymbolSet terminals = SymbolTable_find(evaluation->table, grammar->terminalSetId.id)->symbolSetBinding->symbols;
+  uint32_t* symbols = NULL;
+  size_t count = 0;
+  size_t capacity = 0;
+  SetIterator iterator = SetIterator_new(terminals);
+  while (SetIterator_hasNext(iterator)) {
+    const Symbol symbol = SetIterator_next(iterator)->symbol;
+    if (count == capacity) {
+      capacity = capacity == 0 ? 16 : 2 * capacity;
+      symbols = realloc(symbols, capacity * sizeof(uint32_t));
+      if (symbols == NULL) exitWithPerror(__func__, "realloc error");
+    }
+    symbols[count++] = Alphabet_intern(symbol.symbol, (size_t)symbol.length);
+  }
+  SetIterator_free(iterator);
+  if (symbols == NULL) symbols = safeMalloc(sizeof(uint32_t));
+  *alphabet = _toSymbolList(symbols, (uint32_t)count);
+  return *alphabet;
+}
+
+/**
+ * @return The symbols an automaton reads.
+ */
+static SymbolList _automatonAlphabet(const Automaton* automaton) {
+  uint32_t* symbols = safeMalloc((automaton->transitionCount == 0 ? 1 : automaton->transitionCount) * sizeof(uint32_t));
+  memcpy(symbols, automaton->symbols, automaton->transitionCount * sizeof(uint32_t));
+  return _toSymbolList(symbols, automaton->transitionCount);
+}
+
+/**
+ * Compiles a grammar definition in the given orientation (once), resolving
+ * the sets it references.
+ *
+ * @return The memoized automaton, or NULL if the grammar can't be compiled.
+ */
+static Automaton* _grammarAutomaton(Evaluation* evaluation, size_t index, bool reversed) {
+  Automaton** automata = reversed ? evaluation->reversedAutomata : evaluation->automata;
+  if (automata[index] != NULL || evaluation->reasons[index] != NULL) return automata[index];
+  GrammarDefinition* grammar = Array_get(evaluation->program->sentences, index).sentence->grammarDefinition;
+  SymbolSet terminals = SymbolTable_find(evaluation->table, grammar->terminalSetId.id)->symbolSetBinding->symbols;
+  SymbolSet nonTerminals = SymbolTable_find(evaluation->table, grammar->nonTerminalSetId.id)->symbolSetBinding->symbols;
+  ProductionSet productions =
+    SymbolTable_find(evaluation->table, grammar->productionSetId.id)->productionSetBinding->productions;
+  automata[index] =
+    buildGrammarAutomaton(grammar, terminals, nonTerminals, productions, reversed, &evaluation->reasons[index]);
+  if (automata[index] != NULL && evaluation->classes != NULL) {
+    SymbolClasses_relabelAutomaton(evaluation->classes, automata[index]);
+  }
+  return automata[index];
+}
+
+/**
+ * @return The automaton of an operand, building it if it's a grammar (which
+ *         is shared with its memoized one), or NULL if it can't be evaluated.
+ */
+static Automaton* _materialize(Evaluation* evaluation, Operand operand) {
+  if (operand.grammar < 0) return operand.automaton;
+  Automaton* automaton = _grammarAutomaton(evaluation, (size_t)operand.grammar, operand.reversed);
+  if (automaton == NULL) {
+    _unsupported(evaluation, evaluation->reasons[operand.grammar]);
+    return NULL;
+  }
+  return Automaton_retain(automaton);
+}
+
+/**
+ * Replaces an automaton by an equivalent DFA.
+ */
+static Automaton* _determinize(Automaton* automaton) {
+  if (automaton->deterministic) return automaton;
+  Automaton* dfa = determinize(automaton, NULL);
+  Automaton_free(automaton);
+  return dfa;
+}
+
+/**
+ * Applies the determinization policy to an operand of a union or an
+ * intersection.
+ */
+static Automaton* _determinizeEarly(Automaton* automaton) {
+  switch (_determinizationPolicy) {
+  case DETERMINIZE_EAGERLY:
+    return _determinize(automaton);
+  case DETERMINIZE_BY_COST:
+    return automaton->stateCount <= _determinizationThreshold ? _determinize(automaton) : automaton;
+  default:
+    return automaton;
+  }
+}
+
+/**
+ * Replaces an automaton by its minimal DFA.
+ */
+static Automaton* _minimize(Automaton* automaton) {
+  if (automaton == NULL) return NULL;
+  automaton = _determinize(automaton);
+  Automaton* minimal = minimize(automaton, NULL);
+  Automaton_free(automaton);
+  return minimal;
+}
+
+/**
+ * Applies the minimization policy to the result of an operator.
+ */
+static Automaton* _simplify(Automaton* automaton) {
+  if (automaton == NULL) return NULL;
+  switch (_minimizationPolicy) {
+  case MINIMIZE_ALWAYS:
+    return _minimize(automaton);
+  case MINIMIZE_THRESHOLD:
+    return _minimizationThreshold < automaton->stateCount ? _minimize(automaton) : automaton;
+  default:
+    return automaton;
+  }
+}
+
+/**
+ * Takes the cached operand of a node: its automaton shared (and a copy of
+ * its alphabet), or the operand itself if it's the last use.
+ */
+static Operand _take(Evaluation* evaluation, uint32_t node) {
+  CachedOperand* cached = &evaluation->cache[node];
+  if (cached->reason != NULL) _unsupported(evaluation, cached->reason);
+  if (--cached->references == 0) {
+    const Operand operand = cached->operand;
+    cached->operand = (Operand){.automaton = NULL, .grammar = -1, .reversed = false, .alphabet = {NULL, 0}};
+    return operand;
+  }
+  ++evaluation->reuseCount;
+  Operand operand = cached->operand;
+  operand.automaton = Automaton_retain(operand.automaton);
+  operand.alphabet = _copySymbolList(operand.alphabet);
+  return operand;
+}
+
+static Operand _evaluateLanguage(Evaluation* evaluation, const DagNode* language) {
+  Operand operand = {.automaton = NULL, .grammar = -1, .reversed = false, .alphabet = {.symbols = NULL, .size = 0}};
+  switch (language->first) {
+  case WORDS_FILE:
+    operand.automaton = evaluation->wordLists[language->second];
+    evaluation->wordLists[language->second] = NULL;
+    operand.alphabet = _automatonAlphabet(operand.automaton);
+    break;
+  case GRAMMAR_ID:
+    operand.grammar = language->second;
+    operand.alphabet = _copySymbolList(_grammarAlphabet(evaluation, (size_t)operand.grammar));
+    break;
+  case LANGUAGE_ID: {
+    const uint32_t index = language->second;
+    operand.alphabet = _copySymbolList(evaluation->alphabets[index]);
+    if (evaluation->automata[index] == NULL) {
+      _unsupported(evaluation, evaluation->reasons[index]);
+    } else {
+      operand.automaton = Automaton_retain(evaluation->automata[index]);
+    }
+    break;
+  }
+  default:
+    break;
+  }
+  return operand;
+}
+
+static Operand _evaluateReverse(Operand operand) {
+  if (0 <= operand.grammar) {
+    operand.reversed = !operand.reversed;
+    return operand;
+  }
+  if (operand.automaton == NULL) return operand;
+  Automaton* reversed = Automaton_reverse(operand.automaton);
+  Automaton_free(operand.automaton);
+  operand.automaton = _simplify(reversed);
+  return operand;
+}
+
+/**
+ * Complements an automaton with respect to the alphabet of its expression.
+ * The result has an accepting sink, so it only costs a pass over its states.
+ */
+static Automaton* _evaluateComplement(Automaton* operand, SymbolList alphabet) {
+  if (operand == NULL) return NULL;
+  operand = _determinize(operand);
+  Automaton* complement = Automaton_complement(operand, alphabet.symbols, alphabet.size);
+  Automaton_free(operand);
+  return _simplify(complement);
+}
+
+/**
+ * Builds the `*` or `+` of an automaton, with epsilon transitions as a
+ * concatenation.
+ */
+static Automaton* _evaluateClosure(LanguageExpressionType type, Automaton* operand) {
+  if (operand == NULL) return NULL;
+  Automaton* closure = type == LANG_STAR ? Automaton_star(operand) : Automaton_plus(operand);
+  Automaton_free(operand);
+  return _simplify(closure);
+}
+
+/**
+ * Raises an automaton to a power by repeated squaring: `X^n` is the
+ * concatenation of the squares `X^(2^k)` of the bits of `n`, so it takes
+ * O(log n) concatenations instead of n - 1. Every square and partial result
+ * is minimized before it's concatenated again, so they never grow beyond the
+ * minimal DFAs of their languages.
+ */
+static Automaton* _evaluatePower(Automaton* operand, uint32_t exponent) {
+  if (operand == NULL) return NULL;
+  Automaton* result = NULL;
+  Automaton* square = operand;
+  uint32_t concatenations = 0;
+  for (uint32_t remaining = exponent; 0 < remaining; remaining >>= 1) {
+    if (remaining & 1) {
+      if (result == NULL) {
+        result = Automaton_retain(square);
+      } else {
+        Automaton* product = Automaton_concatenate(result, square);
+        Automaton_free(result);
+        result = _minimize(product);
+        ++concatenations;
+      }
+    }
+    if (1 < remaining) {
+      Automaton* next = Automaton_concatenate(square, square);
+      Automaton_free(square);
+      square = _minimize(next);
+      ++concatenations;
+    }
+  }
+  Automaton_free(square);
+  if (result == NULL) {
+    // `X^0` only has the empty word.
+    result = Automaton_empty();
+    Bitset_set(result->accepting, 0);
+  }
+  logDebugging(_logger, "Raised a language to the power %u with %u concatenations.", exponent, concatenations);
+  return _simplify(result);
+}
+
+/**
+ * Concatenations are built with epsilon transitions, which are only removed
+ * (once, for the whole automaton) when it's determinized. A difference is a
+ * product of DFAs.
+ */
+static Automaton* _evaluateBinary(LanguageExpressionType type, Automaton* left, Automaton* right) {
+  if (left == NULL || right == NULL) {
+    Automaton_free(left);
+    Automaton_free(right);
+    return NULL;
+  }
+  Automaton* result;
+  if (type == LANG_CONCAT) {
+    result = Automaton_concatenate(left, right);
+  } else {
+    left = _determinize(left);
+    right = _determinize(right);
+    result = buildProduct(left, right, PRODUCT_DIFFERENCE);
+  }
+  Automaton_free(left);
+  Automaton_free(right);
+  return _simplify(result);
+}
+
+/**
+ * @return Whether a node is an inner node of the `u` or `n` chain of the
+ *         given type that uses it, and no other operator or binding does.
+ */
+static bool _isInnerLink(const Evaluation* evaluation, LanguageExpressionType type, uint32_t node) {
+  const CachedOperand* cached = &evaluation->cache[node];
+  return evaluation->dag->nodes[node].type == type && cached->references == 1 && !cached->evaluated;
+}
+
+/**
+ * Flattens the `u` or `n` chain of a node into its operands: the operands of
+ * its nodes of the same type, through the ones only the chain uses (which
+ * are never evaluated on their own, and keep their single reference).
+ *
+ * @return The heap-allocated nodes of the operands.
+ */
+static uint32_t* _chainTerms(const Evaluation* evaluation, uint32_t node, size_t* count) {
+  const DagNode* dagNode = &evaluation->dag->nodes[node];
+  size_t capacity = 16;
+  uint32_t* terms = safeMalloc(capacity * sizeof(uint32_t));
+  terms[0] = dagNode->first;
+  terms[1] = dagNode->second;
+  *count = 2;
+  for (size_t k = 0; k < *count;) {
+    if (!_isInnerLink(evaluation, dagNode->type, terms[k])) {
+      ++k;
+      continue;
+    }
+    const DagNode* link = &evaluation->dag->nodes[terms[k]];
+    if (*count == capacity) {
+      capacity *= 2;
+      terms = realloc(terms, capacity * sizeof(uint32_t));
+      if (terms == NULL) exitWithPerror(__func__, "realloc error");
+    }
+    terms[k] = link->first;
+    terms[(*count)++] = link->second;
+  }
+  return terms;
+}
+
+/**
+ * An operand of a chain, with the estimate it's ordered by.
+ */
+typedef struct {
+  Automaton* automaton;
+  uint64_t cost;
+  size_t position;
+} ChainOperand;
+
+static int _compareChainOperands(const void* left, const void* right) {
+  const ChainOperand* a = left;
+  const ChainOperand* b = right;
+  if (a->cost != b->cost) return a->cost < b->cost ? -1 : 1;
+  return (a->position > b->position) - (a->position < b->position);
+}
+
+/**
+ * Evaluates a flattened chain of unions or intersections at once, instead of
+ * pairwise in the order it was written.
+ *
+ * The operands are sorted by an estimate of their size (their states times
+ * the symbols of their expression), so the smallest, most restrictive ones
+ * come first. If the determinization policy leaves all of them
+ * deterministic, they're combined by a single multi-way product. Otherwise
+ * they're combined pairwise in that order, on NFAs, and an intersection
+ * stops as soon as its partial result is empty. Unions of grammatical
+ * operands are built on their grammars.
+ */
+static Automaton* _evaluateChain(LanguageExpressionType type, Operand* operands, size_t count, bool grammatical) {
+  ChainOperand* chain = safeMalloc(count * sizeof(ChainOperand));
+  bool supported = true;
+  for (size_t k = 0; k < count; ++k) {
+    Automaton* automaton = operands[k].automaton;
+    supported = supported && automaton != NULL;
+    const uint64_t states = automaton == NULL ? 0 : automaton->stateCount;
+    chain[k] = (ChainOperand){.automaton = automaton, .cost = states * (1 + operands[k].alphabet.size), .position = k};
+  }
+  if (!supported) {
+    for (size_t k = 0; k < count; ++k) {
+      Automaton_free(chain[k].automaton);
+    }
+    free(chain);
+    return NULL;
+  }
+  qsort(chain, count, sizeof(ChainOperand), _compareChainOperands);
+
+  Automaton* result = NULL;
+  size_t used = count;
+  if (grammatical) {
+    result = chain[0].automaton;
+    for (size_t k = 1; k < count; ++k) {
+      Automaton* united = uniteGrammarAutomata(result, chain[k].automaton);
+      Automaton_free(result);
+      Automaton_free(chain[k].automaton);
+      result = united;
+    }
+    free(chain);
+    return _simplify(result);
+  }
+
+  bool deterministic = true;
+  bool empty = false;
+  for (size_t k = 0; k < count; ++k) {
+    chain[k].automaton = _determinizeEarly(chain[k].automaton);
+    deterministic = deterministic && chain[k].automaton->deterministic;
+    empty = empty || (!chain[k].automaton->acceptingSink && Automaton_acceptingCount(chain[k].automaton) == 0);
+  }
+  if (type == LANG_INTERSEC && empty) {
+    // Sorted first, an empty operand makes the whole intersection empty.
+    result = Automaton_empty();
+    used = 1;
+  } else if (deterministic) {
+    const Automaton** automata = safeMalloc(count * sizeof(Automaton*));
+    for (size_t k = 0; k < count; ++k) {
+      automata[k] = chain[k].automaton;
+    }
+    result = buildMultiProduct(automata, count, _productOperation(type));
+    free(automata);
+  } else {
+    result = Automaton_retain(chain[0].automaton);
+    for (size_t k = 1; k < count; ++k) {
+      Automaton* next;
+      if (result->deterministic && chain[k].automaton->deterministic) {
+        next = buildProduct(result, chain[k].automaton, _productOperation(type));
+      } else if (type == LANG_UNION) {
+        next = Automaton_union(result, chain[k].automaton);
+      } else {
+        next = buildNondeterministicIntersection(result, chain[k].automaton);
+      }
+      Automaton_free(result);
+      result = next;
+      if (type == LANG_INTERSEC && !result->acceptingSink && Automaton_acceptingCount(result) == 0) {
+        used = k + 1;
+        break;
+      }
+      if (k + 1 < count) result = _simplify(result);
+    }
+  }
+  if (type == LANG_INTERSEC && used < count) {
+    logDebugging(_logger, "The intersection of %zu languages is empty after %zu of them.", count, used);
+  }
+  for (size_t k = 0; k < count; ++k) {
+    Automaton_free(chain[k].automaton);
+  }
+  free(chain);
+  return _simplify(result);
+}
+
+/**
+ * @return Whether an operand is a grammar, or was built from grammars by
+ *         grammar-level constructions only.
+ */
+static bool _isGrammatical(Operand operand) {
+  return 0 <= operand.grammar || operand.fromGrammars;
+}
+
+/**
+ * Unites or concatenates two grammatical operands directly, in time linear
+ * in their productions, without the epsilon transitions the automaton
+ * constructions need.
+ */
+static Automaton* _evaluateGrammatical(LanguageExpressionType type, Automaton* left, Automaton* right) {
+  Automaton* result = NULL;
+  if (left != NULL && right != NULL) {
+    result = type == LANG_UNION ? uniteGrammarAutomata(left, right) : concatenateGrammarAutomata(left, right);
+  }
+  Automaton_free(left);
+  Automaton_free(right);
+  return _simplify(result);
+}
+
+/**
+ * Takes the operands of the chain of a `u` or `n` node and evaluates it.
+ */
+static Operand _evaluateChainNode(Evaluation* evaluation, uint32_t node) {
+  const LanguageExpressionType type = evaluation->dag->nodes[node].type;
+  size_t count;
+  uint32_t* terms = _chainTerms(evaluation, node, &count);
+  Operand* operands = safeMalloc(count * sizeof(Operand));
+  SymbolList alphabet = {.symbols = NULL, .size = 0};
+  bool grammatical = type == LANG_UNION;
+  for (size_t k = 0; k < count; ++k) {
+    const Operand operand = _take(evaluation, terms[k]);
+    grammatical = grammatical && _isGrammatical(operand);
+    const SymbolList merged = _mergeSymbolLists(alphabet, operand.alphabet);
+    free(alphabet.symbols);
+    alphabet = merged;
+    operands[k] = operand;
+  }
+  for (size_t k = 0; k < count; ++k) {
+    operands[k].automaton = _materialize(evaluation, operands[k]);
+  }
+  Operand result = _automatonOperand(_evaluateChain(type, operands, count, grammatical), alphabet);
+  result.fromGrammars = grammatical;
+  for (size_t k = 0; k < count; ++k) {
+    free(operands[k].alphabet.symbols);
+  }
+  free(operands);
+  free(terms);
+  return result;
+}
+
+/**
+ * Evaluates a node of the DAG whose operands were already evaluated.
+ */
+static void _evaluateNode(Evaluation* evaluation, uint32_t node) {
+  const DagNode* dagNode = &evaluation->dag->nodes[node];
+  const char* reason = evaluation->reason;
+  evaluation->reason = NULL;
+  Operand result;
+  switch (dagNode->type) {
+  case LANGUAGE:
+    result = _evaluateLanguage(evaluation, dagNode);
+    break;
+  case LANG_REVERSE:
+    result = _evaluateReverse(_take(evaluation, dagNode->first));
+    break;
+  case LANG_COMPLEMENT: {
+    const Operand operand = _take(evaluation, dagNode->first);
+    Automaton* complement = _evaluateComplement(_materialize(evaluation, operand), operand.alphabet);
+    result = _automatonOperand(complement, operand.alphabet);
+    break;
+  }
+  case LANG_STAR:
+  case LANG_PLUS: {
+    const Operand operand = _take(evaluation, dagNode->first);
+    result = _automatonOperand(_evaluateClosure(dagNode->type, _materialize(evaluation, operand)), operand.alphabet);
+    break;
+  }
+  case LANG_POWER: {
+    const Operand operand = _take(evaluation, dagNode->first);
+    result = _automatonOperand(_evaluatePower(_materialize(evaluation, operand), dagNode->second), operand.alphabet);
+    break;
+  }
+  case LANG_EMPTY: {
+    // Only the alphabet of the operand is used, but it's still unsupported if it can't be evaluated.
+    const Operand operand = _take(evaluation, dagNode->first);
+    const Automaton* automaton = 0 <= operand.grammar ? evaluation->automata[operand.grammar] : operand.automaton;
+    if (automaton == NULL && 0 <= operand.grammar) _unsupported(evaluation, evaluation->reasons[operand.grammar]);
+    result = _automatonOperand(automaton == NULL ? NULL : Automaton_empty(), operand.alphabet);
+    Automaton_free(operand.automaton);
+    break;
+  }
+  default: {
+    if (dagNode->type == LANG_UNION || dagNode->type == LANG_INTERSEC) {
+      result = _evaluateChainNode(evaluation, node);
+      break;
+    }
+    const Operand left = _take(evaluation, dagNode->first);
+    const Operand right = _take(evaluation, dagNode->second);
+    const bool grammatical = dagNode->type == LANG_CONCAT && _isGrammatical(left) && _isGrammatical(right);
+    Automaton* automaton =
+      grammatical
+        ? _evaluateGrammatical(dagNode->type, _materialize(evaluation, left), _materialize(evaluation, right))
+        : _evaluateBinary(dagNode->type, _materialize(evaluation, left), _materialize(evaluation, right));
+    result = _automatonOperand(automaton, _mergeSymbolLists(left.alphabet, right.alphabet));
+    result.fromGrammars = grammatical;
+    free(left.alphabet.symbols);
+    free(right.alphabet.symbols);
+    break;
+  }
+  }
+  CachedOperand* cached = &evaluation->cache[node];
+  cached->operand = result;
+  cached->reason = evaluation->reason;
+  cached->evaluated = true;
+  evaluation->reason = reason;
+}
+
+/**
+ * Builds the leaves of an expression that weren't built yet: the grammars
+ * (in their orientation of definition, with their alphabets) and the word
+ * lists.
+ */
+static void _collectExpression(Evaluation* evaluation, uint32_t root) {
+  size_t capacity = 16;
+  size_t count = 0;
+  uint32_t* pending = safeMalloc(capacity * sizeof(uint32_t));
+  pending[count++] = root;
+  while (0 < count && !evaluation->failed) {
+    const uint32_t node = pending[--count];
+    if (evaluation->cache[node].collected) continue;
+    evaluation->cache[node].collected = true;
+    const DagNode* dagNode = &evaluation->dag->nodes[node];
+    if (dagNode->type != LANGUAGE) {
+      if (capacity < count + 2) {
+        capacity *= 2;
+        pending = realloc(pending, capacity * sizeof(uint32_t));
+        if (pending == NULL) exitWithPerror(__func__, "realloc error");
+      }
+      // The first operand goes on top, so the leaves are built (and their symbols interned) from left to right.
+      if (DagNode_isBinary(dagNode)) pending[count++] = dagNode->second;
+      pending[count++] = dagNode->first;
+    } else if (dagNode->first == GRAMMAR_ID) {
+      _grammarAutomaton(evaluation, dagNode->second, false);
+      _grammarAlphabet(evaluation, dagNode->second);
+    } else if (dagNode->first == WORDS_FILE) {
+      evaluation->wordLists[dagNode->second] = buildWordListAutomaton(evaluation->dag->paths[dagNode->second]);
+      evaluation->failed = evaluation->wordLists[dagNode->second] == NULL;
+    }
+  }
+  free(pending);
+}
+
+/**
+ * Builds the leaves of the expressions of a language or query binding.
+ */
+static void _collectSentence(Evaluation* evaluation, Sentence* sentence, size_t index) {
+  if (sentence->type == LANGUAGE_SENTENCE) {
+    _collectExpression(evaluation, evaluation->roots[2 * index]);
+    if (evaluation->failed) {
+      logError(_logger, "The language \"%s\" can't be evaluated.", sentence->languageBinding->id.id);
+    }
+  } else if (sentence->type == QUERY_SENTENCE) {
+    QueryBinding* query = sentence->queryBinding;
+    // The word list of a membership query is streamed while answering it.
+    if (query->type != QUERY_MEMBERSHIP) _collectExpression(evaluation, evaluation->roots[2 * index]);
+    if (query->rightLanguageExpression != NULL) _collectExpression(evaluation, evaluation->roots[2 * index + 1]);
+    if (evaluation->failed) logError(_logger, "The query \"%s\" can't be answered.", query->id.id);
+  }
+}
+
+/**
+ * Partitions the alphabet by the leaves built so far, and relabels them (and
+ * the alphabets of the grammars) with the classes.
+ */
+static void _compressAlphabet(Evaluation* evaluation, size_t sentenceCount) {
+  const size_t automatonCapacity = sentenceCount + evaluation->dag->pathCount;
+  const Automaton** automata = safeMalloc((automatonCapacity == 0 ? 1 : automatonCapacity) * sizeof(Automaton*));
+  const uint32_t** alphabets = safeMalloc((sentenceCount == 0 ? 1 : sentenceCount) * sizeof(uint32_t*));
+  uint32_t* alphabetSizes = safeMalloc((sentenceCount == 0 ? 1 : sentenceCount) * sizeof(uint32_t));
+  size_t automatonCount = 0;
+  size_t alphabetCount = 0;
+  for (size_t k = 0; k < sentenceCount; ++k) {
+    if (evaluation->automata[k] != NULL) automata[automatonCount++] = evaluation->automata[k];
+    if (evaluation->alphabets[k].symbols != NULL) {
+      alphabets[alphabetCount] = evaluation->alphabets[k].symbols;
+      alphabetSizes[alphabetCount++] = evaluation->alphabets[k].size;
+    }
+  }
+  for (uint32_t k = 0; k < evaluation->dag->pathCount; ++k) {
+    if (evaluation->wordLists[k] != NULL) automata[automatonCount++] = evaluation->wordLists[k];
+  }
+  evaluation->classes = computeSymbolClasses(automata, automatonCount, alphabets, alphabetSizes, alphabetCount);
+  for (size_t k = 0; k < automatonCount; ++k) {
+    SymbolClasses_relabelAutomaton(evaluation->classes, (Automaton*)automata[k]);
+  }
+  for (size_t k = 0; k < sentenceCount; ++k) {
+    SymbolList* alphabet = &evaluation->alphabets[k];
+    if (alphabet->symbols != NULL) {
+      alphabet->size = SymbolClasses_relabelAlphabet(evaluation->classes, alphabet->symbols, alphabet->size);
+    }
+  }
+  free(automata);
+  free(alphabets);
+  free(alphabetSizes);
+}
+
+/**
+ * Rewrites the expressions of the required bindings (before any of them is
+ * built) into the DAG, and counts how many times each node will be used.
+ */
+static void _buildDag(Evaluation* evaluation, const uint32_t* order, size_t sentenceCount) {
+  const size_t capacity = 2 * sentenceCount == 0 ? 1 : 2 * sentenceCount;
+  LanguageExpression*** expressions = safeMalloc(capacity * sizeof(LanguageExpression**));
+  size_t* positions = safeMalloc(capacity * sizeof(size_t));
+  uint32_t* roots = safeMalloc(capacity * sizeof(uint32_t));
+  size_t count = 0;
+  for (size_t k = 0; k < sentenceCount; ++k) {
+    if (!SymbolTable_isRequired(evaluation->table, order[k])) continue;
+    Sentence* sentence = Array_get(evaluation->program->sentences, order[k]).sentence;
+    if (sentence->type == LANGUAGE_SENTENCE) {
+      positions[count] = 2 * (size_t)order[k];
+      expressions[count++] = &sentence->languageBinding->LanguageExpression;
+    } else if (sentence->type == QUERY_SENTENCE) {
+      if (sentence->queryBinding->type != QUERY_MEMBERSHIP) {
+        positions[count] = 2 * (size_t)order[k];
+        expressions[count++] = &sentence->queryBinding->leftLanguageExpression;
+      }
+      if (sentence->queryBinding->rightLanguageExpression != NULL) {
+        positions[count] = 2 * (size_t)order[k] + 1;
+        expressions[count++] = &sentence->queryBinding->rightLanguageExpression;
+      }
+    }
+  }
+  evaluation->dag = ExpressionDag_new();
+  rewriteLanguageExpressions(evaluation->table, evaluation->dag, expressions, roots, count);
+  evaluation->roots = safeMalloc(capacity * sizeof(uint32_t));
+  for (size_t k = 0; k < count; ++k) {
+    evaluation->roots[positions[k]] = roots[k];
+  }
+
+  const uint32_t nodeCount = evaluation->dag->nodeCount;
+  uint32_t* references = safeMalloc((nodeCount == 0 ? 1 : nodeCount) * sizeof(uint32_t));
+  ExpressionDag_countReferences(evaluation->dag, roots, count, references);
+  evaluation->cache = safeCalloc(nodeCount == 0 ? 1 : nodeCount, sizeof(CachedOperand));
+  uint32_t used = 0;
+  for (uint32_t node = 0; node < nodeCount; ++node) {
+    evaluation->cache[node].references = references[node];
+    if (0 < references[node]) ++used;
+  }
+  const uint32_t pathCount = evaluation->dag->pathCount;
+  evaluation->wordLists = safeCalloc(pathCount == 0 ? 1 : pathCount, sizeof(Automaton*));
+  logDebugging(_logger, "The %zu expressions share %u distinct subexpressions.", count, used);
+  free(references);
+  free(expressions);
+  free(positions);
+  free(roots);
+}
+
+/**
+ * Logs the automaton of a requested binding, or why it was skipped.
+ */
+static void _report(Evaluation* evaluation, size_t index, LanguageBinding* languageBinding) {
+  if (evaluation->automata[index] == NULL) {
+    logWarning(_logger, "Skipping the language \"%s\": %s.", languageBinding->id.id, evaluation->reasons[index]);
+    return;
+  }
+  char* automaton = Automaton_toString(evaluation->automata[index]);
+  logInformation(_logger, "Language %s: %s", languageBinding->id.id, automaton);
+  free(automaton);
+}
+
+/**
+ * @return The operands of an operator: the flattened chain of a `u` or `n`
+ *         node, or its one or two operands, heap-allocated.
+ */
+static uint32_t* _operandsOf(const Evaluation* evaluation, uint32_t node, size_t* count) {
+  const DagNode* dagNode = &evaluation->dag->nodes[node];
+  if (dagNode->type == LANG_UNION || dagNode->type == LANG_INTERSEC) return _chainTerms(evaluation, node, count);
+  uint32_t* operands = safeMalloc(2 * sizeof(uint32_t));
+  operands[0] = dagNode->first;
+  operands[1] = dagNode->second;
+  *count = DagNode_isBinary(dagNode) ? 2 : 1;
+  return operands;
+}
+
+/**
+ * Pushes nodes on the stack of a traversal, so they're popped in order.
+ */
+static void _pushNodes(
+  uint32_t** stack, bool** expanded, size_t* capacity, size_t* count, const uint32_t* nodes, size_t nodeCount
+) {
+  while (*capacity < *count + nodeCount) {
+    *capacity *= 2;
+    *stack = realloc(*stack, *capacity * sizeof(uint32_t));
+    *expanded = realloc(*expanded, *capacity * sizeof(bool));
+    if (*stack == NULL || *expanded == NULL) exitWithPerror(__func__, "realloc error");
+  }
+  for (size_t k = nodeCount; 0 < k--;) {
+    (*stack)[*count] = nodes[k];
+    (*expanded)[(*count)++] = false;
+  }
+}
+
+/**
+ * @return Whether a node is already held in memory: a leaf (which is built
+ *         before evaluating), or an operator evaluated for a previous use.
+ */
+static bool _isHeld(const Evaluation* evaluation, uint32_t node) {
+  return evaluation->cache[node].evaluated || evaluation->dag->nodes[node].type == LANGUAGE;
+}
+
+/**
+ * @return The states of the automaton of a node, or their estimate if it
+ *         isn't evaluated yet.
+ */
+static uint64_t _states(const Evaluation* evaluation, uint32_t node) {
+  const CachedOperand* cached = &evaluation->cache[node];
+  if (!_isHeld(evaluation, node)) return cached->states;
+  const DagNode* dagNode = &evaluation->dag->nodes[node];
+  const Automaton* automaton;
+  if (cached->evaluated) {
+    const Operand* operand = &cached->operand;
+    automaton = 0 <= operand->grammar ? evaluation->automata[operand->grammar] : operand->automaton;
+  } else if (dagNode->first == WORDS_FILE) {
+    automaton = evaluation->wordLists[dagNode->second];
+  } else {
+    automaton = evaluation->automata[dagNode->second];
+  }
+  return automaton == NULL ? 1 : automaton->stateCount;
+}
+
+/**
+ * An operand in the order of evaluation, with the memory (in states) it
+ * needs while it's evaluated and holds afterwards.
+ */
+typedef struct {
+  uint32_t node;
+  uint64_t need;
+  uint64_t held;
+  size_t position;
+} ScheduledOperand;
+
+static int _compareScheduledOperands(const void* left, const void* right) {
+  const ScheduledOperand* a = left;
+  const ScheduledOperand* b = right;
+  // The operands that release the most of what they need go first; `need` is never below `held`.
+  const uint64_t aFreed = a->need - a->held;
+  const uint64_t bFreed = b->need - b->held;
+  if (aFreed != bFreed) return aFreed > bFreed ? -1 : 1;
+  return (a->position > b->position) - (a->position < b->position);
+}
+
+/**
+ * Sorts the operands of an operator (all of them estimated) in the order
+ * that needs the fewest states at once to evaluate them, as Sethi and
+ * Ullman order registers: by what each one needs while it's evaluated
+ * minus what it holds afterwards, from highest to lowest.
+ *
+ * @return The most states held at once while evaluating them, and receives
+ *         the states they hold afterwards.
+ */
+static uint64_t _scheduleOperands(const Evaluation* evaluation, uint32_t* operands, size_t count, uint64_t* held) {
+  ScheduledOperand* schedule = safeMalloc(count * sizeof(ScheduledOperand));
+  for (size_t k = 0; k < count; ++k) {
+    const bool isHeld = _isHeld(evaluation, operands[k]);
+    const CachedOperand* cached = &evaluation->cache[operands[k]];
+    schedule[k] = (ScheduledOperand){
+      .node = operands[k], .need = isHeld ? 0 : cached->need, .held = isHeld ? 0 : cached->states, .position = k
+    };
+  }
+  qsort(schedule, count, sizeof(ScheduledOperand), _compareScheduledOperands);
+  uint64_t peak = 0;
+  *held = 0;
+  for (size_t k = 0; k < count; ++k) {
+    operands[k] = schedule[k].node;
+    if (peak < *held + schedule[k].need) peak = *held + schedule[k].need;
+    *held += schedule[k].held;
+  }
+  free(schedule);
+  return peak;
+}
+
+/**
+ * Estimates the states of an operator from the ones of its operands.
+ */
+static uint64_t _estimateStates(
+  const Evaluation* evaluation, const DagNode* dagNode, const uint32_t* operands, size_t count
+) {
+  const LanguageExpressionType type = dagNode->type;
+  uint64_t states = _states(evaluation, operands[0]);
+  for (size_t k = 1; k < count; ++k) {
+    const uint64_t other = _states(evaluation, operands[k]);
+    if (type == LANG_INTERSEC) {
+      states = other < states ? other : states;
+    } else if (type != LANG_MINUS) {
+      states += other;
+    }
+  }
+  switch (type) {
+  case LANG_COMPLEMENT:
+  case LANG_STAR:
+  case LANG_PLUS:
+    return states + 1;
+  case LANG_POWER:
+    // Saturates instead of overflowing.
+    return dagNode->second == 0 ? 1 : (UINT64_MAX / dagNode->second < states ? UINT64_MAX : states * dagNode->second);
+  case LANG_EMPTY:
+    return 1;
+  default:
+    return states;
+  }
+}
+
+/**
+ * Estimates the states of the operators of an expression that aren't
+ * evaluated yet, and the most states held at once to evaluate each one, in
+ * post-order.
+ */
+static void _estimateExpression(Evaluation* evaluation, uint32_t root) {
+  size_t capacity = 16;
+  size_t count = 0;
+  uint32_t* stack = safeMalloc(capacity * sizeof(uint32_t));
+  bool* expanded = safeMalloc(capacity * sizeof(bool));
+  _pushNodes(&stack, &expanded, &capacity, &count, &root, 1);
+  while (0 < count) {
+    const uint32_t node = stack[count - 1];
+    CachedOperand* cached = &evaluation->cache[node];
+    if (cached->estimated || _isHeld(evaluation, node)) {
+      --count;
+      continue;
+    }
+    size_t operandCount;
+    uint32_t* operands = _operandsOf(evaluation, node, &operandCount);
+    if (expanded[count - 1]) {
+      --count;
+      uint64_t held;
+      const uint64_t peak = _scheduleOperands(evaluation, operands, operandCount, &held);
+      cached->states = _estimateStates(evaluation, &evaluation->dag->nodes[node], operands, operandCount);
+      // The operands are released only once the result is built.
+      cached->need = peak < held + cached->states ? held + cached->states : peak;
+      cached->estimated = true;
+    } else {
+      expanded[count - 1] = true;
+      _pushNodes(&stack, &expanded, &capacity, &count, operands, operandCount);
+    }
+    free(operands);
+  }
+  free(stack);
+  free(expanded);
+}
+
+/**
+ * Evaluates the node of an expression into its automaton (NULL if it can't
+ * be evaluated) and its alphabet.
+ *
+ * The operands of each operator are evaluated in the order that keeps the
+ * fewest states of intermediate automata alive at once (as estimated by
+ * `_estimateExpression`), and each automaton is released as soon as its
+ * last use is done with it.
+ */
+static Operand _evaluateExpression(Evaluation* evaluation, uint32_t root) {
+  _estimateExpression(evaluation, root);
+  // The nodes not evaluated yet, in post-order (operands before their operator), with an explicit stack.
+  size_t capacity = 16;
+  size_t count = 0;
+  uint32_t* stack = safeMalloc(capacity * sizeof(uint32_t));
+  bool* expanded = safeMalloc(capacity * sizeof(bool));
+  _pushNodes(&stack, &expanded, &capacity, &count, &root, 1);
+  while (0 < count) {
+    const uint32_t node = stack[count - 1];
+    if (evaluation->cache[node].evaluated) {
+      // An operand repeated in the same operator, or shared with another one.
+      --count;
+      continue;
+    }
+    if (expanded[count - 1] || evaluation->dag->nodes[node].type == LANGUAGE) {
+      --count;
+      _evaluateNode(evaluation, node);
+      continue;
+    }
+    expanded[count - 1] = true;
+    size_t operandCount;
+    uint64_t held;
+    uint32_t* operands = _operandsOf(evaluation, node, &operandCount);
+    _scheduleOperands(evaluation, operands, operandCount, &held);
+    _pushNodes(&stack, &expanded, &capacity, &count, operands, operandCount);
+    free(operands);
+  }
+  free(stack);
+  free(expanded);
+  Operand operand = _take(evaluation, root);
+  operand.automaton = _materialize(evaluation, operand);
+  operand.grammar = -1;
+  return operand;
+}
+
+/**
+ * Spells a word with the symbols of the alphabet.
+ *
+ * @param representatives The symbol of each class if the word is labeled with
+ *        classes, or NULL if it has the symbols themselves.
+ */
+static char* _spell(const uint32_t* symbols, size_t wordLength, const uint32_t* representatives) {
+  if (wordLength == 0) return safeAsprintf("lambda");
+  size_t length = 0;
+  for (size_t k = 0; k < wordLength; ++k) {
+    const uint32_t id = representatives == NULL ? symbols[k] : representatives[symbols[k]];
+    length += strlen(Alphabet_symbol(id)) + 1;
+  }
+  char* string = safeMalloc(length);
+  char* end = string;
+  for (size_t k = 0; k < wordLength; ++k) {
+    const char* symbol = Alphabet_symbol(representatives == NULL ? symbols[k] : representatives[symbols[k]]);
+    if (0 < k) *end++ = ' ';
+    const size_t symbolLength = strlen(symbol);
+    memcpy(end, symbol, symbolLength);
+    end += symbolLength;
+  }
+  *end = '\0';
+  return string;
+}
+
+/**
+ * Spells a word of an automaton. Automata are labeled with classes of
+ * symbols, so each class is spelled as its representative (any other symbol
+ * of the class would do just as well).
+ */
+static char* _wordToString(const Evaluation* evaluation, const Word* word) {
+  return _spell(word->symbols, word->length, evaluation->classes->representatives);
+}
+
+/**
+ * The words of a membership query tested so far, as the context of
+ * `readWordList`.
+ */
+typedef struct {
+  const SymbolClasses* classes;
+  LazyDfa* dfa;
+  // The word being tested, labeled with classes.
+  uint32_t* word;
+  size_t wordCapacity;
+  size_t wordCount;
+  size_t acceptedCount;
+  // The first word that isn't in the language, with its symbols and its line.
+  uint32_t* rejected;
+  size_t rejectedLength;
+  size_t rejectedLine;
+} Membership;
+
+static bool _testWord(const uint32_t* word, size_t length, size_t lineNumber, void* context) {
+  Membership* membership = context;
+  if (membership->wordCapacity < length) {
+    membership->wordCapacity = 2 * length;
+    membership->word = realloc(membership->word, membership->wordCapacity * sizeof(uint32_t));
+    if (membership->word == NULL) exitWithPerror(__func__, "realloc error");
+  }
+  // A symbol interned after the classes were computed is in no automaton, so no word with it is in the language.
+  const SymbolClasses* classes = membership->classes;
+  for (size_t k = 0; k < length; ++k) {
+    membership->word[k] = word[k] < classes->symbolCount ? classes->classOf[word[k]] : UINT32_MAX;
+  }
+  ++membership->wordCount;
+  if (LazyDfa_accepts(membership->dfa, membership->word, length)) {
+    ++membership->acceptedCount;
+  } else if (membership->rejected == NULL) {
+    membership->rejected = safeMalloc((length == 0 ? 1 : length) * sizeof(uint32_t));
+    if (0 < length) memcpy(membership->rejected, word, length * sizeof(uint32_t));
+    membership->rejectedLength = length;
+    membership->rejectedLine = lineNumber;
+  }
+  return true;
+}
+
+/**
+ * Answers a membership query by testing each listed word against a lazy DFA
+ * of the language, without building the automaton of the list.
+ */
+static void _answerMembership(Evaluation* evaluation, QueryBinding* query, const Automaton* automaton) {
+  const char* path = query->leftLanguageExpression->language->path.path;
+  Membership membership = {.classes = evaluation->classes, .dfa = LazyDfa_new(automaton)};
+  if (!readWordList(path, _testWord, &membership)) {
+    logError(_logger, "The query \"%s\" can't be answered.", query->id.id);
+    evaluation->failed = true;
+  } else if (membership.acceptedCount == membership.wordCount) {
+    logInformation(_logger, "Query %s: all %zu words are in the language.", query->id.id, membership.wordCount);
+  } else {
+    char* rejected = _spell(membership.rejected, membership.rejectedLength, NULL);
+    logInformation(
+      _logger, "Query %s: %zu of %zu words are in the language, \"%s\" (on line %zu) isn't.", query->id.id,
+      membership.acceptedCount, membership.wordCount, rejected, membership.rejectedLine
+    );
+    free(rejected);
+  }
+  const LazyDfa* dfa = membership.dfa;
+  logDebugging(
+    _logger, "The lazy DFA of query %s had %llu cache hits and %llu misses, %u flushes and a peak of %u states%s.",
+    query->id.id, (unsigned long long)dfa->hits, (unsigned long long)dfa->misses, dfa->flushes, dfa->peakStates,
+    dfa->fallback ? ", and fell back to simulating the NFA" : ""
+  );
+  LazyDfa_free(membership.dfa);
+  free(membership.word);
+  free(membership.rejected);
+}
+
+/**
+ * Answers a query, logging a word that proves it wrong if there's one.
+ */
+static void _answerQuery(
+  const Evaluation* evaluation, QueryBinding* query, const Automaton* left, const Automaton* right
+) {
+  Word word = {.symbols = NULL, .length = 0};
+  bool inLeft = true;
+  const char* id = query->id.id;
+  switch (query->type) {
+  case QUERY_EMPTINESS:
+    if (!findAcceptedWord(left, &word)) {
+      logInformation(_logger, "Query %s: the language is empty.", id);
+      return;
+    }
+    break;
+  case QUERY_INCLUSION:
+    if (!findUnincludedWord(left, right, &word)) {
+      logInformation(_logger, "Query %s: the left language is included in the right one.", id);
+      return;
+    }
+    break;
+  default:
+    if (!findDistinguishingWord(left, right, &word, &inLeft)) {
+      logInformation(_logger, "Query %s: the languages are equal.", id);
+      return;
+    }
+    break;
+  }
+  char* counterexample = _wordToString(evaluation, &word);
+  switch (query->type) {
+  case QUERY_EMPTINESS:
+    logInformation(_logger, "Query %s: the language isn't empty, it has \"%s\".", id, counterexample);
+    break;
+  case QUERY_INCLUSION:
+    logInformation(
+      _logger, "Query %s: the left language isn't included in the right one, only the left one has \"%s\".", id,
+      counterexample
+    );
+    break;
+  default:
+    logInformation(
+      _logger, "Query %s: the languages are different, only the %s one has \"%s\".", id, inLeft ? "left" : "right",
+      counterexample
+    );
+    break;
+  }
+  free(counterexample);
+  free(word.symbols);
+}
+
+static void _evaluateQuery(Evaluation* evaluation, QueryBinding* query, size_t index) {
+  evaluation->reason = NULL;
+  if (query->type == QUERY_MEMBERSHIP) {
+    Operand operand = _evaluateExpression(evaluation, evaluation->roots[2 * index + 1]);
+    if (operand.automaton == NULL) {
+      logWarning(_logger, "Skipping the query \"%s\": %s.", query->id.id, evaluation->reason);
+    } else {
+      _answerMembership(evaluation, query, operand.automaton);
+    }
+    Automaton_free(operand.automaton);
+    free(operand.alphabet.symbols);
+    return;
+  }
+  Operand left = _evaluateExpression(evaluation, evaluation->roots[2 * index]);
+  Operand right = {.automaton = NULL, .grammar = -1, .reversed = false, .alphabet = {.symbols = NULL, .size = 0}};
+  if (query->rightLanguageExpression != NULL) right = _evaluateExpression(evaluation, evaluation->roots[2 * index + 1]);
+  if (left.automaton == NULL || (query->rightLanguageExpression != NULL && right.automaton == NULL)) {
+    logWarning(_logger, "Skipping the query \"%s\": %s.", query->id.id, evaluation->reason);
+  } else {
+    _answerQuery(evaluation, query, left.automaton, right.automaton);
+  }
+  Automaton_free(left.automaton);
+  Automaton_free(right.automaton);
+  free(left.alphabet.symbols);
+  free(right.alphabet.symbols);
+}
+
+/* PUBLIC FUNCTIONS */
+
+bool evaluateLanguages(CompilerState* compilerState) {
+  Program* program = compilerState->abstractSyntaxtTree;
+  SymbolTable table = compilerState->symbolTable;
+  const size_t sentenceCount = SymbolTable_sentenceCount(table);
+  const uint32_t* order = SymbolTable_evaluationOrder(table);
+  Evaluation evaluation = {
+    .table = table,
+    .program = program,
+    .automata = safeCalloc(sentenceCount == 0 ? 1 : sentenceCount, sizeof(Automaton*)),
+    .reversedAutomata = safeCalloc(sentenceCount == 0 ? 1 : sentenceCount, sizeof(Automaton*)),
+    .reasons = safeCalloc(sentenceCount == 0 ? 1 : sentenceCount, sizeof(const char*)),
+    .alphabets = safeCalloc(sentenceCount == 0 ? 1 : sentenceCount, sizeof(SymbolList)),
+  };
+
+  _buildDag(&evaluation, order, sentenceCount);
+  for (size_t k = 0; k < sentenceCount && !evaluation.failed; ++k) {
+    const uint32_t index = order[k];
+    Sentence* sentence = Array_get(program->sentences, index).sentence;
+    if (SymbolTable_isRequired(table, index)) _collectSentence(&evaluation, sentence, index);
+  }
+  if (!evaluation.failed) _compressAlphabet(&evaluation, sentenceCount);
+
+  // The most bytes of automata alive at once (counting the leaves), and the binding that reached it.
+  size_t peakBytes = Automaton_liveBytes();
+  const char* peakBinding = NULL;
+  for (size_t k = 0; k < sentenceCount && !evaluation.failed; ++k) {
+    const uint32_t index = order[k];
+    Sentence* sentence = Array_get(program->sentences, index).sentence;
+    if (!SymbolTable_isRequired(table, index)) continue;
+    Automaton_resetPeakBytes();
+    if (sentence->type == QUERY_SENTENCE) {
+      _evaluateQuery(&evaluation, sentence->queryBinding, index);
+    } else if (sentence->type == LANGUAGE_SENTENCE) {
+      LanguageBinding* languageBinding = sentence->languageBinding;
+      evaluation.reason = NULL;
+      const Operand operand = _evaluateExpression(&evaluation, evaluation.roots[2 * (size_t)index]);
+      evaluation.alphabets[index] = operand.alphabet;
+      evaluation.automata[index] = _minimize(operand.automaton);
+      evaluation.reasons[index] = evaluation.reason;
+      if (SymbolTable_isRequested(table, index)) _report(&evaluation, index, languageBinding);
+    } else {
+      continue;
+    }
+    if (peakBytes < Automaton_peakBytes()) {
+      peakBytes = Automaton_peakBytes();
+      peakBinding = sentence->type == QUERY_SENTENCE ? sentence->queryBinding->id.id : sentence->languageBinding->id.id;
+    }
+  }
+
+  if (!evaluation.failed) {
+    logDebugging(_logger, "Reused the automaton of a subexpression %zu times.", evaluation.reuseCount);
+    if (peakBinding != NULL) {
+      logInformation(
+        _logger, "The automata peaked at %.1f KiB alive at once, while evaluating \"%s\".", (double)peakBytes / 1024,
+        peakBinding
+      );
+    }
+  }
+
+  const bool succeed = !evaluation.failed;
+  for (size_t k = 0; k < sentenceCount; ++k) {
+    Automaton_free(evaluation.automata[k]);
+    Automaton_free(evaluation.reversedAutomata[k]);
+    free(evaluation.alphabets[k].symbols);
+  }
+  // Only an evaluation that stopped early leaves cached operands behind.
+  for (uint32_t node = 0; node < evaluation.dag->nodeCount; ++node) {
+    Automaton_free(evaluation.cache[node].operand.automaton);
+    free(evaluation.cache[node].operand.alphabet.symbols);
+  }
+  for (uint32_t k = 0; k < evaluation.dag->pathCount; ++k) {
+    Automaton_free(evaluation.wordLists[k]);
+  }
+  SymbolClasses_free(evaluation.classes);
+  ExpressionDag_free(evaluation.dag);
+  free(evaluation.roots);
+  free(evaluation.cache);
+  free(evaluation.wordLists);
+  free(evaluation.automata);
+  free(evaluation.reversedAutomata);
+  free(evaluation.reasons);
+  free(evaluation.alphabets);
+  return succeed;
+}
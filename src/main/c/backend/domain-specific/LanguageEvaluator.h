@@ -0,0 +1,28 @@
+#ifndef LANGUAGE_EVALUATOR_HEADER
+#define LANGUAGE_EVALUATOR_HEADER
+
+#include "../../shared/CompilerState.h"
+#include <stdbool.h>
+
+/** Initialize module's internal state. */
+void initializeLanguageEvaluatorModule();
+
+/** Shutdown module's internal state. */
+void shutdownLanguageEvaluatorModule();
+
+/**
+ * Evaluates every required language binding of the program into an
+ * automaton, following the evaluation order of the symbol table (so each
+ * binding is evaluated once, after everything it depends on), and logs the
+ * automata of the requested ones. Required queries are answered the same way,
+ * logging a counterexample word when they don't hold.
+ *
+ * Bindings that use a construct the evaluator doesn't support yet are skipped
+ * with a warning.
+ *
+ * @return `false` if some binding can't be evaluated (e.g., a missing or
+ *         unsorted word list).
+ */
+bool evaluateLanguages(CompilerState* compilerState);
+
+#endif
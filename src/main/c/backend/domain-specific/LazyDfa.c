@@ -0,0 +1,302 @@
+#include "LazyDfa.h"
+#include "../../shared/Environment.h"
+#include "../../shared/Logger.h"
+#include "../../shared/utils.h"
+#include "Automaton.h"
+#include "EpsilonRemoval.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* MODULE INTERNAL STATE */
+
+#define EMPTY_SLOT UINT32_MAX
+#define UNKNOWN UINT32_MAX
+#define DEFAULT_CACHE_SIZE (8LL << 20)
+// A cache that's flushed before reading this many symbols per state it built isn't worth keeping.
+#define SYMBOLS_PER_STATE 10
+
+static Logger* _logger = NULL;
+static size_t _cacheSize = DEFAULT_CACHE_SIZE;
+
+void initializeLazyDfaModule() {
+  _logger = createLogger("LazyDfa");
+  const long long cacheSize = getIntegerOrDefault("LAZY_DFA_CACHE_SIZE", DEFAULT_CACHE_SIZE);
+  if (cacheSize <= 0 || SIZE_MAX < (unsigned long long)cacheSize) {
+    logWarning(_logger, "Invalid lazy DFA cache size %lld, using %lld.", cacheSize, DEFAULT_CACHE_SIZE);
+    _cacheSize = DEFAULT_CACHE_SIZE;
+  } else {
+    _cacheSize = (size_t)cacheSize;
+  }
+}
+
+void shutdownLazyDfaModule() {
+  if (_logger != NULL) {
+    destroyLogger(_logger);
+  }
+}
+
+/* PRIVATE FUNCTIONS */
+
+static inline uint64_t _mix(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+static uint64_t _hashSet(const uint32_t* set, uint32_t size) {
+  uint64_t hash = _mix(size);
+  for (uint32_t k = 0; k < size; ++k) {
+    hash = _mix(hash ^ set[k]);
+  }
+  return hash;
+}
+
+static int _compareStates(const void* left, const void* right) {
+  const uint32_t a = *(const uint32_t*)left;
+  const uint32_t b = *(const uint32_t*)right;
+  return (a > b) - (a < b);
+}
+
+/**
+ * @return The capacity of the table of slots for the given number of states.
+ */
+static uint32_t _slotCapacityFor(uint32_t stateCount) {
+  uint32_t capacity = 64;
+  while (capacity < 2 * (size_t)stateCount) capacity *= 2;
+  return capacity;
+}
+
+/**
+ * @return The bytes the cache would take with the given number of states,
+ *         and of NFA states in their sets.
+ */
+static size_t _usage(const LazyDfa* dfa, uint32_t stateCount, size_t setSize) {
+  const size_t perState = sizeof(uint32_t) + sizeof(bool) + (size_t)dfa->symbolCount * sizeof(uint32_t);
+  return stateCount * perState + setSize * sizeof(uint32_t) + _slotCapacityFor(stateCount) * sizeof(uint32_t);
+}
+
+static void _flush(LazyDfa* dfa) {
+  dfa->stateCount = 0;
+  dfa->setOffsets[0] = 0;
+  if (dfa->slots != NULL) memset(dfa->slots, 0xFF, dfa->slotCapacity * sizeof(uint32_t));
+  dfa->start = UNKNOWN;
+  dfa->symbolsSinceFlush = 0;
+  ++dfa->flushes;
+}
+
+static void _growSlots(LazyDfa* dfa, uint32_t slotCapacity) {
+  free(dfa->slots);
+  dfa->slotCapacity = slotCapacity;
+  dfa->slots = safeMalloc(slotCapacity * sizeof(uint32_t));
+  memset(dfa->slots, 0xFF, slotCapacity * sizeof(uint32_t));
+  for (uint32_t state = 0; state < dfa->stateCount; ++state) {
+    const uint32_t* set = dfa->sets + dfa->setOffsets[state];
+    uint32_t slot = (uint32_t)_hashSet(set, dfa->setOffsets[state + 1] - dfa->setOffsets[state]) & (slotCapacity - 1);
+    while (dfa->slots[slot] != EMPTY_SLOT) slot = (slot + 1) & (slotCapacity - 1);
+    dfa->slots[slot] = state;
+  }
+}
+
+/**
+ * @return The cached state of a sorted set of NFA states, added if it's new
+ *         (flushing the cache if it's full), or UNKNOWN if the DFA gave up
+ *         on caching.
+ */
+static uint32_t _addState(LazyDfa* dfa, const uint32_t* set, uint32_t size) {
+  const uint64_t hash = _hashSet(set, size);
+  if (dfa->slots != NULL) {
+    const uint32_t mask = dfa->slotCapacity - 1;
+    for (uint32_t slot = (uint32_t)hash & mask; dfa->slots[slot] != EMPTY_SLOT; slot = (slot + 1) & mask) {
+      const uint32_t state = dfa->slots[slot];
+      const uint32_t begin = dfa->setOffsets[state];
+      if (dfa->setOffsets[state + 1] - begin == size && memcmp(dfa->sets + begin, set, size * sizeof(uint32_t)) == 0) {
+        return state;
+      }
+    }
+  }
+  if (dfa->cacheSize < _usage(dfa, dfa->stateCount + 1, (size_t)dfa->setOffsets[dfa->stateCount] + size)) {
+    // The first fill is mostly misses anyway, so it's only judged after a flush.
+    const bool slow = 0 < dfa->flushes && dfa->symbolsSinceFlush < SYMBOLS_PER_STATE * (uint64_t)dfa->stateCount;
+    if (slow || dfa->stateCount == 0) {
+      dfa->fallback = true;
+      return UNKNOWN;
+    }
+    _flush(dfa);
+    if (dfa->cacheSize < _usage(dfa, 1, size)) {
+      dfa->fallback = true;
+      return UNKNOWN;
+    }
+  }
+
+  const uint32_t state = dfa->stateCount;
+  const size_t begin = dfa->setOffsets[state];
+  if (UINT32_MAX <= begin + size) exitInvalidArgument(__func__, "too many states in the cache");
+  dfa->sets = safeReserve(dfa->sets, &dfa->setCapacity, begin + size, sizeof(uint32_t));
+  if (0 < size) memcpy(dfa->sets + begin, set, size * sizeof(uint32_t));
+  dfa->setOffsets = safeReserve(dfa->setOffsets, &dfa->setOffsetCapacity, (size_t)state + 2, sizeof(uint32_t));
+  dfa->setOffsets[state + 1] = (uint32_t)(begin + size);
+  dfa->accepting = safeReserve(dfa->accepting, &dfa->acceptingCapacity, (size_t)state + 1, sizeof(bool));
+  dfa->accepting[state] = false;
+  for (uint32_t k = 0; k < size && !dfa->accepting[state]; ++k) {
+    dfa->accepting[state] = Automaton_isAccepting(dfa->nfa, set[k]);
+  }
+  const size_t rowEnd = ((size_t)state + 1) * dfa->symbolCount;
+  dfa->next = safeReserve(dfa->next, &dfa->nextCapacity, rowEnd == 0 ? 1 : rowEnd, sizeof(uint32_t));
+  memset(dfa->next + rowEnd - dfa->symbolCount, 0xFF, dfa->symbolCount * sizeof(uint32_t));
+  dfa->stateCount = state + 1;
+  if (dfa->peakStates < dfa->stateCount) dfa->peakStates = dfa->stateCount;
+
+  if (dfa->slotCapacity < _slotCapacityFor(dfa->stateCount)) {
+    _growSlots(dfa, _slotCapacityFor(dfa->stateCount));
+  } else {
+    const uint32_t mask = dfa->slotCapacity - 1;
+    uint32_t slot = (uint32_t)hash & mask;
+    while (dfa->slots[slot] != EMPTY_SLOT) slot = (slot + 1) & mask;
+    dfa->slots[slot] = state;
+  }
+  return state;
+}
+
+/**
+ * Computes the NFA states a set of them goes to with a symbol.
+ *
+ * @param sorted Whether to sort them, which only the cached sets need.
+ * @return How many they are.
+ */
+static uint32_t _stepSet(
+  LazyDfa* dfa, const uint32_t* set, uint32_t size, uint32_t symbol, uint32_t* out, bool sorted
+) {
+  const Automaton* nfa = dfa->nfa;
+  if (++dfa->epoch == 0) {
+    memset(dfa->marks, 0, nfa->stateCount * sizeof(uint32_t));
+    dfa->epoch = 1;
+  }
+  uint32_t count = 0;
+  for (uint32_t j = 0; j < size; ++j) {
+    // The row is sorted by symbol, so its transitions with the symbol are found by binary search.
+    uint32_t low = nfa->offsets[set[j]];
+    uint32_t high = nfa->offsets[set[j] + 1];
+    const uint32_t end = high;
+    while (low < high) {
+      const uint32_t middle = low + (high - low) / 2;
+      if (nfa->symbols[middle] < symbol) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    for (uint32_t k = low; k < end && nfa->symbols[k] == symbol; ++k) {
+      const uint32_t target = nfa->targets[k];
+      if (dfa->marks[target] == dfa->epoch) continue;
+      dfa->marks[target] = dfa->epoch;
+      out[count++] = target;
+    }
+  }
+  if (sorted && 1 < count) qsort(out, count, sizeof(uint32_t), _compareStates);
+  return count;
+}
+
+/* PUBLIC FUNCTIONS */
+
+LazyDfa* LazyDfa_new(const Automaton* automaton) {
+  LazyDfa* dfa = safeCalloc(1, sizeof(LazyDfa));
+  Automaton* nfa = automaton->acceptingSink ? Automaton_materializeSink(automaton) : Automaton_copy(automaton);
+  if (Automaton_hasEpsilons(nfa)) {
+    Automaton* withoutEpsilons = removeEpsilons(nfa);
+    Automaton_free(nfa);
+    nfa = withoutEpsilons;
+  }
+  // The initial states are the first cached set, so they're sorted too.
+  if (1 < nfa->initialStateCount) {
+    qsort(nfa->initialStates, nfa->initialStateCount, sizeof(uint32_t), _compareStates);
+    uint32_t unique = 1;
+    for (uint32_t k = 1; k < nfa->initialStateCount; ++k) {
+      if (nfa->initialStates[unique - 1] != nfa->initialStates[k]) nfa->initialStates[unique++] = nfa->initialStates[k];
+    }
+    nfa->initialStateCount = unique;
+  }
+  for (uint32_t k = 0; k < nfa->transitionCount; ++k) {
+    if (dfa->symbolCount <= nfa->symbols[k]) dfa->symbolCount = nfa->symbols[k] + 1;
+  }
+  const size_t size = nfa->stateCount == 0 ? 1 : nfa->stateCount;
+  dfa->nfa = nfa;
+  dfa->current = safeMalloc(size * sizeof(uint32_t));
+  dfa->step = safeMalloc(size * sizeof(uint32_t));
+  dfa->marks = safeCalloc(size, sizeof(uint32_t));
+  dfa->setOffsets = safeReserve(NULL, &dfa->setOffsetCapacity, 1, sizeof(uint32_t));
+  dfa->setOffsets[0] = 0;
+  dfa->start = UNKNOWN;
+  dfa->cacheSize = _cacheSize;
+  return dfa;
+}
+
+void LazyDfa_free(LazyDfa* dfa) {
+  if (dfa == NULL) return;
+  Automaton_free(dfa->nfa);
+  free(dfa->setOffsets);
+  free(dfa->sets);
+  free(dfa->accepting);
+  free(dfa->next);
+  free(dfa->slots);
+  free(dfa->current);
+  free(dfa->step);
+  free(dfa->marks);
+  free(dfa);
+}
+
+bool LazyDfa_accepts(LazyDfa* dfa, const uint32_t* word, size_t length) {
+  const Automaton* nfa = dfa->nfa;
+  size_t k = 0;
+  uint32_t size = 0;
+  if (!dfa->fallback && dfa->start == UNKNOWN) dfa->start = _addState(dfa, nfa->initialStates, nfa->initialStateCount);
+  if (dfa->fallback) {
+    memcpy(dfa->current, nfa->initialStates, nfa->initialStateCount * sizeof(uint32_t));
+    size = nfa->initialStateCount;
+  } else {
+    uint32_t state = dfa->start;
+    for (; k < length; ++k) {
+      // No word leaves the empty set.
+      if (dfa->setOffsets[state + 1] == dfa->setOffsets[state] || dfa->symbolCount <= word[k]) return false;
+      ++dfa->symbolsSinceFlush;
+      const size_t edge = (size_t)state * dfa->symbolCount + word[k];
+      if (dfa->next[edge] != UNKNOWN) {
+        ++dfa->hits;
+        state = dfa->next[edge];
+        continue;
+      }
+      ++dfa->misses;
+      const uint32_t* set = dfa->sets + dfa->setOffsets[state];
+      const uint32_t count =
+        _stepSet(dfa, set, dfa->setOffsets[state + 1] - dfa->setOffsets[state], word[k], dfa->step, true);
+      const uint32_t flushes = dfa->flushes;
+      const uint32_t target = _addState(dfa, dfa->step, count);
+      if (target == UNKNOWN) {
+        // The rest of the word is read by simulating the NFA, from the set just computed.
+        memcpy(dfa->current, dfa->step, count * sizeof(uint32_t));
+        size = count;
+        ++k;
+        break;
+      }
+      // A flush drops the state the transition leaves from.
+      if (flushes == dfa->flushes) dfa->next[edge] = target;
+      state = target;
+    }
+    if (!dfa->fallback) return dfa->accepting[state];
+  }
+
+  for (; k < length && 0 < size; ++k) {
+    if (dfa->symbolCount <= word[k]) return false;
+    size = _stepSet(dfa, dfa->current, size, word[k], dfa->step, false);
+    uint32_t* swap = dfa->current;
+    dfa->current = dfa->step;
+    dfa->step = swap;
+  }
+  for (uint32_t j = 0; j < size; ++j) {
+    if (Automaton_isAccepting(nfa, dfa->current[j])) return true;
+  }
+  return false;
+}
@@ -0,0 +1,73 @@
+#ifndef LAZY_DFA_HEADER
+#define LAZY_DFA_HEADER
+
+#include "Automaton.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** Initialize module's internal state. */
+void initializeLazyDfaModule();
+
+/** Shutdown module's internal state. */
+void shutdownLazyDfaModule();
+
+/**
+ * A DFA built on demand while testing words, as in RE2: each of its states
+ * is a set of states of an NFA, and its transitions are only computed the
+ * first time a word takes them. They're cached in a bounded amount of memory
+ * (LAZY_DFA_CACHE_SIZE bytes, plus what the arrays grow in advance), so
+ * words are tested at the speed of a DFA after a few of them, without ever
+ * determinizing the whole automaton.
+ *
+ * When the cache is full, it's flushed and filled again. If it's flushed so
+ * often that it barely saves any work (fewer than 10 symbols read per state
+ * built), the DFA gives up on caching, and every word from then on is tested
+ * by simulating the NFA.
+ */
+typedef struct {
+  // The automaton, without epsilon transitions nor implicit sink.
+  Automaton* nfa;
+  // The number of symbols of the NFA, which is the length of each row of `next`.
+  uint32_t symbolCount;
+  // The cached states: where their sets begin in `sets`, and their rows of transitions (or UINT32_MAX if unknown).
+  uint32_t* setOffsets;
+  size_t setOffsetCapacity;
+  uint32_t* sets;
+  size_t setCapacity;
+  bool* accepting;
+  size_t acceptingCapacity;
+  uint32_t* next;
+  size_t nextCapacity;
+  uint32_t stateCount;
+  uint32_t* slots;
+  uint32_t slotCapacity;
+  uint32_t start;
+  size_t cacheSize;
+  // Scratch sets of NFA states, and a mark per NFA state to build them without repetitions.
+  uint32_t* current;
+  uint32_t* step;
+  uint32_t* marks;
+  uint32_t epoch;
+  uint64_t symbolsSinceFlush;
+  // Statistics.
+  uint64_t hits;
+  uint64_t misses;
+  uint32_t flushes;
+  uint32_t peakStates;
+  bool fallback;
+} LazyDfa;
+
+/**
+ * Prepares the lazy DFA of an automaton, which is copied.
+ */
+LazyDfa* LazyDfa_new(const Automaton* automaton);
+void LazyDfa_free(LazyDfa* dfa);
+
+/**
+ * @return Whether the automaton accepts a word (of symbols the automaton is
+ *         labeled with; any other symbol rejects the word).
+ */
+bool LazyDfa_accepts(LazyDfa* dfa, const uint32_t* word, size_t length);
+
+#endif
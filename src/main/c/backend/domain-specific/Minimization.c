@@ -0,0 +1,701 @@
+#include "Minimization.h"
+#include "../../shared/Bitset.h"
+#include "../../shared/Environment.h"
+#include "../../shared/Logger.h"
+#include "../../shared/utils.h"
+#include "Automaton.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* MODULE INTERNAL STATE */
+
+#define EMPTY_SLOT UINT32_MAX
+#define MAXIMUM_WORKER_THREADS 64
+
+static Logger* _logger = NULL;
+static size_t _workerThreads = 1;
+static uint32_t _parallelThreshold = 65536;
+
+void initializeMinimizationModule() {
+  _logger = createLogger("Minimization");
+  long long threads = getIntegerOrDefault("WORKER_THREADS", 0);
+  if (threads <= 0) threads = sysconf(_SC_NPROCESSORS_ONLN);
+  if (threads < 1) threads = 1;
+  _workerThreads = threads < MAXIMUM_WORKER_THREADS ? (size_t)threads : MAXIMUM_WORKER_THREADS;
+  const long long threshold = getIntegerOrDefault("PARALLEL_MINIMIZATION_THRESHOLD", 65536);
+  if (threshold < 0 || UINT32_MAX < threshold) {
+    logWarning(_logger, "Invalid parallel minimization threshold %lld, using 65536.", threshold);
+    _parallelThreshold = 65536;
+  } else {
+    _parallelThreshold = (uint32_t)threshold;
+  }
+}
+
+void shutdownMinimizationModule() {
+  if (_logger != NULL) {
+    destroyLogger(_logger);
+  }
+}
+
+/**
+ * A refinable partition of `0..n`. The elements of set `s` are
+ * `elements[first[s]..past[s]]`, and `location` is the inverse of
+ * `elements`. Marked elements are moved to the front of their set, and
+ * `split` separates them from the unmarked ones.
+ */
+typedef struct {
+  uint32_t count;
+  uint32_t* elements;
+  uint32_t* location;
+  uint32_t* set;
+  uint32_t* first;
+  uint32_t* past;
+} Partition;
+
+/**
+ * The state of a minimization. Transitions are kept as parallel `tails`,
+ * `labels` and `heads` arrays, and `adjacent[offsets[q]..offsets[q + 1]]`
+ * lists the transitions whose tail (or head) is `q`, depending on the phase.
+ */
+typedef struct {
+  uint32_t stateCount;
+  uint32_t transitionCount;
+  uint32_t* tails;
+  uint32_t* labels;
+  uint32_t* heads;
+  uint32_t* adjacent;
+  uint32_t* offsets;
+  // Marked elements per set, and the sets with marks (shared by both partitions, as only one is split at a time).
+  uint32_t* marked;
+  uint32_t* touched;
+  uint32_t touchedCount;
+  // States at locations below `reached` were reached by the current search.
+  uint32_t reached;
+  Partition blocks;
+  Partition cords;
+} Minimizer;
+
+/* PRIVATE FUNCTIONS */
+
+static void _Partition_init(Partition* partition, uint32_t size) {
+  const size_t capacity = size == 0 ? 1 : size;
+  partition->count = 0 < size;
+  partition->elements = safeMalloc(capacity * sizeof(uint32_t));
+  partition->location = safeMalloc(capacity * sizeof(uint32_t));
+  partition->set = safeCalloc(capacity, sizeof(uint32_t));
+  partition->first = safeMalloc(capacity * sizeof(uint32_t));
+  partition->past = safeMalloc(capacity * sizeof(uint32_t));
+  for (uint32_t k = 0; k < size; ++k) {
+    partition->elements[k] = partition->location[k] = k;
+  }
+  if (0 < size) {
+    partition->first[0] = 0;
+    partition->past[0] = size;
+  }
+}
+
+static void _Partition_free(Partition* partition) {
+  free(partition->elements);
+  free(partition->location);
+  free(partition->set);
+  free(partition->first);
+  free(partition->past);
+}
+
+static void _mark(Minimizer* minimizer, Partition* partition, uint32_t element) {
+  const uint32_t set = partition->set[element];
+  const uint32_t location = partition->location[element];
+  const uint32_t front = partition->first[set] + minimizer->marked[set];
+  partition->elements[location] = partition->elements[front];
+  partition->location[partition->elements[location]] = location;
+  partition->elements[front] = element;
+  partition->location[element] = front;
+  if (minimizer->marked[set]++ == 0) minimizer->touched[minimizer->touchedCount++] = set;
+}
+
+/**
+ * Splits every touched set in its marked and unmarked elements. The smaller
+ * part becomes the new set, which is what bounds the whole refinement to
+ * O(m log n).
+ */
+static void _split(Minimizer* minimizer, Partition* partition) {
+  while (0 < minimizer->touchedCount) {
+    const uint32_t set = minimizer->touched[--minimizer->touchedCount];
+    const uint32_t boundary = partition->first[set] + minimizer->marked[set];
+    if (boundary == partition->past[set]) {
+      minimizer->marked[set] = 0;
+      continue;
+    }
+    const uint32_t created = partition->count++;
+    if (minimizer->marked[set] <= partition->past[set] - boundary) {
+      partition->first[created] = partition->first[set];
+      partition->past[created] = partition->first[set] = boundary;
+    } else {
+      partition->past[created] = partition->past[set];
+      partition->first[created] = partition->past[set] = boundary;
+    }
+    for (uint32_t k = partition->first[created]; k < partition->past[created]; ++k) {
+      partition->set[partition->elements[k]] = created;
+    }
+    minimizer->marked[set] = minimizer->marked[created] = 0;
+  }
+}
+
+/**
+ * Lists the transitions by `keys` (their tails or their heads).
+ */
+static void _makeAdjacent(Minimizer* minimizer, const uint32_t* keys) {
+  memset(minimizer->offsets, 0, (1 + (size_t)minimizer->stateCount) * sizeof(uint32_t));
+  for (uint32_t t = 0; t < minimizer->transitionCount; ++t) {
+    ++minimizer->offsets[keys[t]];
+  }
+  for (uint32_t q = 0; q < minimizer->stateCount; ++q) {
+    minimizer->offsets[q + 1] += minimizer->offsets[q];
+  }
+  for (uint32_t t = minimizer->transitionCount; 0 < t--;) {
+    minimizer->adjacent[--minimizer->offsets[keys[t]]] = t;
+  }
+}
+
+/**
+ * Moves a state to the reached prefix of the first block.
+ */
+static void _reach(Minimizer* minimizer, uint32_t state) {
+  Partition* blocks = &minimizer->blocks;
+  const uint32_t location = blocks->location[state];
+  if (location < minimizer->reached) return;
+  blocks->elements[location] = blocks->elements[minimizer->reached];
+  blocks->location[blocks->elements[location]] = location;
+  blocks->elements[minimizer->reached] = state;
+  blocks->location[state] = minimizer->reached++;
+}
+
+/**
+ * Extends the reached states along the transitions from `tails` to `heads`,
+ * and then drops every state (and transition) that wasn't reached. Called
+ * with the heads as `tails`, it searches backwards.
+ */
+static void _removeUnreached(Minimizer* minimizer, const uint32_t* tails, const uint32_t* heads) {
+  _makeAdjacent(minimizer, tails);
+  Partition* blocks = &minimizer->blocks;
+  for (uint32_t k = 0; k < minimizer->reached; ++k) {
+    const uint32_t state = blocks->elements[k];
+    for (uint32_t j = minimizer->offsets[state]; j < minimizer->offsets[state + 1]; ++j) {
+      _reach(minimizer, heads[minimizer->adjacent[j]]);
+    }
+  }
+  uint32_t count = 0;
+  for (uint32_t t = 0; t < minimizer->transitionCount; ++t) {
+    if (blocks->location[tails[t]] < minimizer->reached) {
+      minimizer->heads[count] = minimizer->heads[t];
+      minimizer->labels[count] = minimizer->labels[t];
+      minimizer->tails[count] = minimizer->tails[t];
+      ++count;
+    }
+  }
+  minimizer->transitionCount = count;
+  blocks->past[0] = minimizer->reached;
+  minimizer->reached = 0;
+}
+
+/**
+ * The initial partition of the transitions groups them by symbol, with a
+ * counting sort.
+ */
+static void _partitionTransitions(Minimizer* minimizer) {
+  Partition* cords = &minimizer->cords;
+  const uint32_t count = minimizer->transitionCount;
+  if (count == 0) {
+    cords->count = 0;
+    return;
+  }
+  uint32_t maximumLabel = 0;
+  for (uint32_t t = 0; t < count; ++t) {
+    if (maximumLabel < minimizer->labels[t]) maximumLabel = minimizer->labels[t];
+  }
+  uint32_t* starts = safeCalloc((size_t)maximumLabel + 2, sizeof(uint32_t));
+  for (uint32_t t = 0; t < count; ++t) {
+    ++starts[minimizer->labels[t] + 1];
+  }
+  for (uint32_t label = 0; label <= maximumLabel; ++label) {
+    starts[label + 1] += starts[label];
+  }
+  for (uint32_t t = 0; t < count; ++t) {
+    cords->elements[starts[minimizer->labels[t]]++] = t;
+  }
+  free(starts);
+
+  cords->count = 0;
+  cords->first[0] = 0;
+  uint32_t label = minimizer->labels[cords->elements[0]];
+  for (uint32_t k = 0; k < count; ++k) {
+    const uint32_t t = cords->elements[k];
+    if (minimizer->labels[t] != label) {
+      label = minimizer->labels[t];
+      cords->past[cords->count++] = k;
+      cords->first[cords->count] = k;
+    }
+    cords->set[t] = cords->count;
+    cords->location[t] = k;
+  }
+  cords->past[cords->count++] = count;
+}
+
+static void _freeMinimizer(Minimizer* minimizer) {
+  free(minimizer->tails);
+  free(minimizer->labels);
+  free(minimizer->heads);
+  free(minimizer->adjacent);
+  free(minimizer->offsets);
+  free(minimizer->marked);
+  free(minimizer->touched);
+  _Partition_free(&minimizer->blocks);
+  _Partition_free(&minimizer->cords);
+}
+
+/**
+ * Builds the quotient automaton: one state per block, and the transitions
+ * of the first state of each block.
+ */
+static Automaton* _toAutomaton(Minimizer* minimizer, uint32_t initialState, uint32_t acceptingCount) {
+  const Partition* blocks = &minimizer->blocks;
+  uint32_t transitionCount = 0;
+  for (uint32_t t = 0; t < minimizer->transitionCount; ++t) {
+    const uint32_t tail = minimizer->tails[t];
+    if (blocks->location[tail] == blocks->first[blocks->set[tail]]) ++transitionCount;
+  }
+  // Blocks are renumbered so the initial one is 0.
+  uint32_t* renumber = safeMalloc(blocks->count * sizeof(uint32_t));
+  const uint32_t initialBlock = blocks->set[initialState];
+  for (uint32_t b = 0; b < blocks->count; ++b) {
+    renumber[b] = b == initialBlock ? 0 : b < initialBlock ? b + 1 : b;
+  }
+
+  Automaton* automaton = Automaton_new(blocks->count, transitionCount, 1);
+  automaton->initialStates[0] = 0;
+  memset(automaton->offsets, 0, (1 + (size_t)blocks->count) * sizeof(uint32_t));
+  for (uint32_t t = 0; t < minimizer->transitionCount; ++t) {
+    const uint32_t tail = minimizer->tails[t];
+    if (blocks->location[tail] != blocks->first[blocks->set[tail]]) continue;
+    ++automaton->offsets[renumber[blocks->set[tail]] + 1];
+  }
+  for (uint32_t b = 0; b < blocks->count; ++b) {
+    automaton->offsets[b + 1] += automaton->offsets[b];
+  }
+  uint32_t* next = safeMalloc(blocks->count * sizeof(uint32_t));
+  memcpy(next, automaton->offsets, blocks->count * sizeof(uint32_t));
+  for (uint32_t t = 0; t < minimizer->transitionCount; ++t) {
+    const uint32_t tail = minimizer->tails[t];
+    if (blocks->location[tail] != blocks->first[blocks->set[tail]]) continue;
+    const uint32_t position = next[renumber[blocks->set[tail]]]++;
+    automaton->symbols[position] = minimizer->labels[t];
+    automaton->targets[position] = renumber[blocks->set[minimizer->heads[t]]];
+  }
+  // Accepting states were placed first, so a block is accepting if it starts there.
+  for (uint32_t b = 0; b < blocks->count; ++b) {
+    if (blocks->first[b] < acceptingCount) Bitset_set(automaton->accepting, renumber[b]);
+  }
+  free(next);
+  free(renumber);
+  Automaton_normalize(automaton);
+  return automaton;
+}
+
+static inline uint64_t _mix(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+/**
+ * The state of a parallel refinement. Each state is identified by its
+ * location among the live ones (the accepting ones first), and its class is
+ * the first location of the states with its signature: its own class and
+ * the symbols and classes of its transitions. Classes only depend on the
+ * partition, so every round (and the result) is the same for any number of
+ * threads.
+ */
+typedef struct {
+  const Minimizer* minimizer;
+  uint32_t liveCount;
+  // The class of each state (by original number) in this round, and in the next one.
+  uint32_t* classes;
+  uint32_t* next;
+  // The hash of the signature of each state, by location.
+  uint64_t* hashes;
+  size_t threadCount;
+} Refinement;
+
+/**
+ * What a thread does in a round: hashing the signatures of the states at
+ * locations `begin..end`, and then grouping the states whose hash falls in
+ * its part of the table.
+ */
+typedef struct {
+  Refinement* refinement;
+  size_t index;
+  uint32_t begin;
+  uint32_t end;
+  // Open-addressing table of the locations of the classes found, by hash.
+  uint32_t* slots;
+  uint32_t slotCapacity;
+  uint32_t classCount;
+} RefinementWorker;
+
+static uint64_t _hashSignature(const Refinement* refinement, uint32_t state) {
+  const Minimizer* minimizer = refinement->minimizer;
+  uint64_t hash = _mix(refinement->classes[state]);
+  for (uint32_t j = minimizer->offsets[state]; j < minimizer->offsets[state + 1]; ++j) {
+    const uint32_t t = minimizer->adjacent[j];
+    hash = _mix(_mix(hash ^ minimizer->labels[t]) ^ refinement->classes[minimizer->heads[t]]);
+  }
+  return hash;
+}
+
+static bool _sameSignature(const Refinement* refinement, uint32_t state, uint32_t other) {
+  const Minimizer* minimizer = refinement->minimizer;
+  const uint32_t* classes = refinement->classes;
+  const uint32_t begin = minimizer->offsets[state];
+  const uint32_t otherBegin = minimizer->offsets[other];
+  const uint32_t length = minimizer->offsets[state + 1] - begin;
+  if (classes[state] != classes[other] || length != minimizer->offsets[other + 1] - otherBegin) return false;
+  for (uint32_t k = 0; k < length; ++k) {
+    const uint32_t t = minimizer->adjacent[begin + k];
+    const uint32_t u = minimizer->adjacent[otherBegin + k];
+    if (minimizer->labels[t] != minimizer->labels[u] || classes[minimizer->heads[t]] != classes[minimizer->heads[u]]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void* _hashSignatures(void* argument) {
+  RefinementWorker* worker = argument;
+  Refinement* refinement = worker->refinement;
+  const uint32_t* states = refinement->minimizer->blocks.elements;
+  for (uint32_t location = worker->begin; location < worker->end; ++location) {
+    refinement->hashes[location] = _hashSignature(refinement, states[location]);
+  }
+  return NULL;
+}
+
+static void _growRefinementSlots(RefinementWorker* worker) {
+  const uint32_t capacity = worker->slotCapacity == 0 ? 64 : 2 * worker->slotCapacity;
+  uint32_t* slots = safeMalloc(capacity * sizeof(uint32_t));
+  memset(slots, 0xFF, capacity * sizeof(uint32_t));
+  for (uint32_t k = 0; k < worker->slotCapacity; ++k) {
+    const uint32_t location = worker->slots[k];
+    if (location == EMPTY_SLOT) continue;
+    uint32_t slot = (uint32_t)worker->refinement->hashes[location] & (capacity - 1);
+    while (slots[slot] != EMPTY_SLOT) slot = (slot + 1) & (capacity - 1);
+    slots[slot] = location;
+  }
+  free(worker->slots);
+  worker->slots = slots;
+  worker->slotCapacity = capacity;
+}
+
+/**
+ * Gives each state whose hash belongs to the worker the class of the first
+ * state with its signature. The states are visited in order of location, so
+ * that's the class of the first one of them.
+ */
+static void* _groupSignatures(void* argument) {
+  RefinementWorker* worker = argument;
+  Refinement* refinement = worker->refinement;
+  const uint32_t* states = refinement->minimizer->blocks.elements;
+  if (0 < worker->slotCapacity) memset(worker->slots, 0xFF, worker->slotCapacity * sizeof(uint32_t));
+  worker->classCount = 0;
+  for (uint32_t location = 0; location < refinement->liveCount; ++location) {
+    const uint64_t hash = refinement->hashes[location];
+    if ((hash >> 32) % refinement->threadCount != worker->index) continue;
+    if (worker->slotCapacity < 2 * (worker->classCount + 1)) _growRefinementSlots(worker);
+    const uint32_t mask = worker->slotCapacity - 1;
+    uint32_t slot = (uint32_t)hash & mask;
+    for (; worker->slots[slot] != EMPTY_SLOT; slot = (slot + 1) & mask) {
+      const uint32_t other = worker->slots[slot];
+      if (refinement->hashes[other] == hash && _sameSignature(refinement, states[location], states[other])) break;
+    }
+    if (worker->slots[slot] == EMPTY_SLOT) {
+      worker->slots[slot] = location;
+      ++worker->classCount;
+    }
+    refinement->next[states[location]] = worker->slots[slot];
+  }
+  return NULL;
+}
+
+/**
+ * Runs a function on every worker, each one on its own thread (but the
+ * first, which runs on this one).
+ */
+static void _runWorkers(void* (*function)(void*), RefinementWorker* workers, size_t count) {
+  pthread_t* threads = safeMalloc(count * sizeof(pthread_t));
+  bool* started = safeCalloc(count, sizeof(bool));
+  for (size_t k = 1; k < count; ++k) {
+    started[k] = pthread_create(&threads[k], NULL, function, &workers[k]) == 0;
+  }
+  function(&workers[0]);
+  for (size_t k = 1; k < count; ++k) {
+    if (started[k]) {
+      pthread_join(threads[k], NULL);
+    } else {
+      // Couldn't spawn a thread (e.g., resource limits), so its work is done here.
+      function(&workers[k]);
+    }
+  }
+  free(started);
+  free(threads);
+}
+
+/**
+ * Refines the partition of the live states in rounds, like Moore's
+ * algorithm: in each one, the states are split by their signature, on
+ * several threads, until a round doesn't split any class.
+ *
+ * @return The quotient automaton.
+ */
+static Automaton* _refineInParallel(Minimizer* minimizer, uint32_t initialState, uint32_t acceptingCount) {
+  const uint32_t liveCount = minimizer->blocks.past[0];
+  const size_t threadCount = _workerThreads < liveCount ? _workerThreads : liveCount;
+  _makeAdjacent(minimizer, minimizer->tails);
+  Refinement refinement = {
+    .minimizer = minimizer,
+    .liveCount = liveCount,
+    .classes = safeMalloc(minimizer->stateCount * sizeof(uint32_t)),
+    .next = safeMalloc(minimizer->stateCount * sizeof(uint32_t)),
+    .hashes = safeMalloc(liveCount * sizeof(uint64_t)),
+    .threadCount = threadCount,
+  };
+  RefinementWorker* workers = safeCalloc(threadCount, sizeof(RefinementWorker));
+  for (size_t k = 0; k < threadCount; ++k) {
+    workers[k] = (RefinementWorker){
+      .refinement = &refinement,
+      .index = k,
+      .begin = (uint32_t)((uint64_t)liveCount * k / threadCount),
+      .end = (uint32_t)((uint64_t)liveCount * (k + 1) / threadCount),
+    };
+  }
+  uint32_t classCount = acceptingCount < liveCount ? 2 : 1;
+  for (uint32_t location = 0; location < liveCount; ++location) {
+    refinement.classes[minimizer->blocks.elements[location]] = location < acceptingCount ? 0 : acceptingCount;
+  }
+
+  for (uint32_t round = 1;; ++round) {
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    _runWorkers(_hashSignatures, workers, threadCount);
+    _runWorkers(_groupSignatures, workers, threadCount);
+    uint32_t count = 0;
+    for (size_t k = 0; k < threadCount; ++k) {
+      count += workers[k].classCount;
+    }
+    uint32_t* swap = refinement.classes;
+    refinement.classes = refinement.next;
+    refinement.next = swap;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    const double milliseconds =
+      1e3 * (double)(end.tv_sec - start.tv_sec) + 1e-6 * (double)(end.tv_nsec - start.tv_nsec);
+    logDebugging(_logger, "Refinement round %u: %u classes in %.3f ms.", round, count, milliseconds);
+    // Classes are only ever split, so the partition is stable once their number doesn't change.
+    if (count == classCount) break;
+    classCount = count;
+  }
+
+  // Each class becomes a state, numbered in the order of its first location, with the transitions of that state.
+  uint32_t* numbers = safeMalloc(liveCount * sizeof(uint32_t));
+  uint32_t transitionCount = 0;
+  uint32_t stateCount = 0;
+  for (uint32_t location = 0; location < liveCount; ++location) {
+    const uint32_t state = minimizer->blocks.elements[location];
+    if (refinement.classes[state] != location) continue;
+    numbers[location] = stateCount++;
+    transitionCount += minimizer->offsets[state + 1] - minimizer->offsets[state];
+  }
+  Automaton* automaton = Automaton_new(stateCount, transitionCount, 1);
+  automaton->initialStates[0] = numbers[refinement.classes[initialState]];
+  uint32_t transition = 0;
+  for (uint32_t location = 0; location < liveCount; ++location) {
+    const uint32_t state = minimizer->blocks.elements[location];
+    if (refinement.classes[state] != location) continue;
+    automaton->offsets[numbers[location]] = transition;
+    if (location < acceptingCount) Bitset_set(automaton->accepting, numbers[location]);
+    for (uint32_t j = minimizer->offsets[state]; j < minimizer->offsets[state + 1]; ++j) {
+      const uint32_t t = minimizer->adjacent[j];
+      automaton->symbols[transition] = minimizer->labels[t];
+      automaton->targets[transition++] = numbers[refinement.classes[minimizer->heads[t]]];
+    }
+  }
+  automaton->offsets[stateCount] = transition;
+  automaton->deterministic = true;
+
+  for (size_t k = 0; k < threadCount; ++k) {
+    free(workers[k].slots);
+  }
+  free(workers);
+  free(numbers);
+  free(refinement.classes);
+  free(refinement.next);
+  free(refinement.hashes);
+  return automaton;
+}
+
+/**
+ * Numbers the states of a trim DFA breadth-first from the initial one,
+ * following the transitions of each state in order. The minimal DFA of a
+ * language is unique up to the numbering of its states, so this makes it
+ * unique, whichever way it was found.
+ */
+static Automaton* _numberBreadthFirst(Automaton* dfa) {
+  Automaton* numbered = Automaton_new(dfa->stateCount, dfa->transitionCount, 1);
+  uint32_t* numbers = safeMalloc((dfa->stateCount == 0 ? 1 : dfa->stateCount) * sizeof(uint32_t));
+  uint32_t* order = safeMalloc((dfa->stateCount == 0 ? 1 : dfa->stateCount) * sizeof(uint32_t));
+  memset(numbers, 0xFF, dfa->stateCount * sizeof(uint32_t));
+  numbered->initialStates[0] = 0;
+  numbers[dfa->initialStates[0]] = 0;
+  order[0] = dfa->initialStates[0];
+  uint32_t found = 1;
+  uint32_t transition = 0;
+  for (uint32_t state = 0; state < found; ++state) {
+    const uint32_t original = order[state];
+    numbered->offsets[state] = transition;
+    if (Automaton_isAccepting(dfa, original)) Bitset_set(numbered->accepting, state);
+    for (uint32_t k = dfa->offsets[original]; k < dfa->offsets[original + 1]; ++k) {
+      const uint32_t target = dfa->targets[k];
+      if (numbers[target] == EMPTY_SLOT) {
+        numbers[target] = found;
+        order[found++] = target;
+      }
+      numbered->symbols[transition] = dfa->symbols[k];
+      numbered->targets[transition++] = numbers[target];
+    }
+  }
+  numbered->offsets[found] = transition;
+  numbered->deterministic = true;
+  free(numbers);
+  free(order);
+  Automaton_free(dfa);
+  return numbered;
+}
+
+/* PUBLIC FUNCTIONS */
+
+Automaton* minimize(const Automaton* dfa, MinimizationReport* report) {
+  if (dfa == NULL || !dfa->deterministic) exitInvalidArgument(__func__, "The automaton must be deterministic");
+  if (dfa->acceptingSink) {
+    // Complementing keeps a DFA minimal, so a complemented one is minimized as its (partial) complement.
+    Automaton* complement = Automaton_complement(dfa, dfa->sinkAlphabet, dfa->sinkAlphabetSize);
+    Automaton* minimal = minimize(complement, report);
+    Automaton* result = Automaton_complement(minimal, dfa->sinkAlphabet, dfa->sinkAlphabetSize);
+    Automaton_free(complement);
+    Automaton_free(minimal);
+    if ((uint64_t)result->stateCount * result->sinkAlphabetSize == result->transitionCount) {
+      // The sink can't be reached in a complete DFA, so it's minimized as a partial one, which trims its dead states.
+      free(result->sinkAlphabet);
+      result->sinkAlphabet = NULL;
+      result->sinkAlphabetSize = 0;
+      result->acceptingSink = false;
+      minimal = minimize(result, report);
+      Automaton_free(result);
+      return minimal;
+    }
+    return result;
+  }
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  const uint32_t stateCount = dfa->stateCount;
+  const uint32_t transitionCount = dfa->transitionCount;
+  const size_t transitionCapacity = transitionCount == 0 ? 1 : transitionCount;
+  const size_t markCapacity = 1 + (size_t)(stateCount < transitionCount ? transitionCount : stateCount);
+  Minimizer minimizer = {
+    .stateCount = stateCount,
+    .transitionCount = transitionCount,
+    .tails = safeMalloc(transitionCapacity * sizeof(uint32_t)),
+    .labels = safeMalloc(transitionCapacity * sizeof(uint32_t)),
+    .heads = safeMalloc(transitionCapacity * sizeof(uint32_t)),
+    .adjacent = safeMalloc(transitionCapacity * sizeof(uint32_t)),
+    .offsets = safeMalloc((1 + (size_t)stateCount) * sizeof(uint32_t)),
+    .marked = safeCalloc(markCapacity, sizeof(uint32_t)),
+    .touched = safeMalloc(markCapacity * sizeof(uint32_t)),
+  };
+  for (uint32_t q = 0; q < stateCount; ++q) {
+    for (uint32_t k = dfa->offsets[q]; k < dfa->offsets[q + 1]; ++k) {
+      minimizer.tails[k] = q;
+      minimizer.labels[k] = dfa->symbols[k];
+      minimizer.heads[k] = dfa->targets[k];
+    }
+  }
+  _Partition_init(&minimizer.blocks, stateCount);
+  _Partition_init(&minimizer.cords, transitionCount);
+
+  // Keeps the reachable states, and then the ones that reach an accepting state (which go first).
+  _reach(&minimizer, dfa->initialStates[0]);
+  _removeUnreached(&minimizer, minimizer.tails, minimizer.heads);
+  for (uint32_t q = 0; q < stateCount; ++q) {
+    const bool reachable = minimizer.blocks.location[q] < minimizer.blocks.past[0];
+    if (reachable && Automaton_isAccepting(dfa, q)) _reach(&minimizer, q);
+  }
+  const uint32_t acceptingCount = minimizer.reached;
+  Automaton* automaton = NULL;
+  bool parallel = false;
+  if (acceptingCount == 0) {
+    automaton = Automaton_empty();
+  } else {
+    _removeUnreached(&minimizer, minimizer.heads, minimizer.tails);
+    parallel = 1 < _workerThreads && _parallelThreshold < minimizer.blocks.past[0];
+  }
+  if (parallel) {
+    automaton = _numberBreadthFirst(_refineInParallel(&minimizer, dfa->initialStates[0], acceptingCount));
+  } else if (0 < acceptingCount) {
+    // Separates the accepting states from the rest, and the transitions by symbol.
+    minimizer.marked[0] = acceptingCount;
+    minimizer.touched[minimizer.touchedCount++] = 0;
+    _split(&minimizer, &minimizer.blocks);
+    _partitionTransitions(&minimizer);
+
+    // Each cord splits the blocks by the tails of its transitions, and each new block splits the cords by the
+    // transitions that enter it, until neither changes.
+    _makeAdjacent(&minimizer, minimizer.heads);
+    uint32_t block = 1;
+    for (uint32_t cord = 0; cord < minimizer.cords.count; ++cord) {
+      for (uint32_t k = minimizer.cords.first[cord]; k < minimizer.cords.past[cord]; ++k) {
+        _mark(&minimizer, &minimizer.blocks, minimizer.tails[minimizer.cords.elements[k]]);
+      }
+      _split(&minimizer, &minimizer.blocks);
+      for (; block < minimizer.blocks.count; ++block) {
+        for (uint32_t k = minimizer.blocks.first[block]; k < minimizer.blocks.past[block]; ++k) {
+          const uint32_t state = minimizer.blocks.elements[k];
+          for (uint32_t j = minimizer.offsets[state]; j < minimizer.offsets[state + 1]; ++j) {
+            _mark(&minimizer, &minimizer.cords, minimizer.adjacent[j]);
+          }
+        }
+        _split(&minimizer, &minimizer.cords);
+      }
+    }
+    automaton = _numberBreadthFirst(_toAutomaton(&minimizer, dfa->initialStates[0], acceptingCount));
+  }
+
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  const double milliseconds = 1e3 * (double)(end.tv_sec - start.tv_sec) + 1e-6 * (double)(end.tv_nsec - start.tv_nsec);
+  logDebugging(
+    _logger, "Minimized a DFA from %u to %u states (%u to %u transitions%s) in %.3f ms.", stateCount,
+    automaton->stateCount, transitionCount, automaton->transitionCount, parallel ? ", in parallel" : "", milliseconds
+  );
+  if (report != NULL) {
+    *report = (MinimizationReport){
+      .statesBefore = stateCount, .statesAfter = automaton->stateCount, .milliseconds = milliseconds
+    };
+  }
+  _freeMinimizer(&minimizer);
+  return automaton;
+}
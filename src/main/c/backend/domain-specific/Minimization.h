@@ -0,0 +1,49 @@
+#ifndef MINIMIZATION_HEADER
+#define MINIMIZATION_HEADER
+
+#include "Automaton.h"
+#include <stdint.h>
+
+/** Initialize module's internal state. */
+void initializeMinimizationModule();
+
+/** Shutdown module's internal state. */
+void shutdownMinimizationModule();
+
+/**
+ * What a minimization achieved.
+ */
+typedef struct {
+  uint32_t statesBefore;
+  uint32_t statesAfter;
+  double milliseconds;
+} MinimizationReport;
+
+/**
+ * Builds the minimal DFA of the language of `dfa`, which must be
+ * deterministic, with Hopcroft's partition refinement as generalized to
+ * partial transition functions by Valmari and Lehtinen ("Efficient
+ * minimization of DFAs with partial transition functions", 2008). Blocks of
+ * states and "cords" of transitions with the same symbol refine each other,
+ * so it runs in O(m log n) for `m` transitions and `n` states, which is
+ * Hopcroft's O(n k log n) bound when the DFA is complete, without ever adding
+ * a sink state to a partial one.
+ *
+ * Unreachable states and states that can't reach an accepting one are
+ * dropped first, so the result is partial and trim (a single rejecting state
+ * for the empty language). A DFA with an accepting sink keeps it, and drops
+ * the states equivalent to it instead.
+ *
+ * When more than PARALLEL_MINIMIZATION_THRESHOLD states are left, the
+ * partition is refined by WORKER_THREADS threads instead, in rounds: in each
+ * one, the states are hashed and grouped by their signature (their block and
+ * the blocks their transitions enter), until a round doesn't split any block.
+ * Either way, the states of the result are numbered breadth-first from the
+ * initial one, so it's the same automaton.
+ *
+ * @param report If not NULL, receives the state counts before and after.
+ * @return A heap-allocated deterministic automaton.
+ */
+Automaton* minimize(const Automaton* dfa, MinimizationReport* report);
+
+#endif
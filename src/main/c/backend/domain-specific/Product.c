@@ -0,0 +1,593 @@
+#include "Product.h"
+#include "../../shared/Bitset.h"
+#include "../../shared/Logger.h"
+#include "../../shared/utils.h"
+#include "Automaton.h"
+#include "EpsilonRemoval.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* MODULE INTERNAL STATE */
+
+// The implicit states of an operand: the rejecting one of a partial DFA, and the sink of a complemented one.
+#define REJECTING UINT32_MAX
+#define SINK (UINT32_MAX - 1)
+#define EMPTY_SLOT UINT32_MAX
+
+static Logger* _logger = NULL;
+
+void initializeProductModule() {
+  _logger = createLogger("Product");
+}
+
+void shutdownProductModule() {
+  if (_logger != NULL) {
+    destroyLogger(_logger);
+  }
+}
+
+typedef struct {
+  const Automaton* left;
+  const Automaton* right;
+  ProductOperation operation;
+  // Every pair found, packed as `left << 32 | right`, in discovery order (also the order they're expanded in).
+  uint64_t* pairs;
+  size_t pairCount;
+  size_t pairCapacity;
+  // Open-addressing index of the pairs.
+  uint32_t* slots;
+  size_t slotCapacity;
+  // The DFA built so far, in CSR layout.
+  uint32_t* offsets;
+  size_t offsetCapacity;
+  uint32_t* symbols;
+  uint32_t* targets;
+  size_t transitionCount;
+  size_t transitionCapacity;
+} ProductBuilder;
+
+/**
+ * The state of a multi-way product: like a `ProductBuilder`, but its states
+ * are tuples of `width` operand states, the one of id `k` at
+ * `tuples[k * width]`.
+ */
+typedef struct {
+  const Automaton* const* operands;
+  size_t width;
+  ProductOperation operation;
+  uint32_t* tuples;
+  size_t tupleCount;
+  size_t tupleCapacity;
+  uint64_t* hashes;
+  size_t hashCapacity;
+  uint32_t* slots;
+  size_t slotCapacity;
+  uint32_t* offsets;
+  size_t offsetCapacity;
+  uint32_t* symbols;
+  uint32_t* targets;
+  size_t transitionCount;
+  size_t transitionCapacity;
+  // The tuple being expanded, its successor, and where each operand is in its row.
+  uint32_t* current;
+  uint32_t* next;
+  uint32_t* cursors;
+} TupleBuilder;
+
+/**
+ * A sorted list of symbols a pair must read, walked while merging.
+ */
+typedef struct {
+  const uint32_t* symbols;
+  uint32_t count;
+  uint32_t next;
+} SymbolCursor;
+
+/* PRIVATE FUNCTIONS */
+
+static inline uint64_t _mix(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+static inline uint64_t _pack(uint32_t left, uint32_t right) {
+  return (uint64_t)left << 32 | right;
+}
+
+static bool _isAccepting(const ProductBuilder* builder, uint64_t pair) {
+  const uint32_t left = (uint32_t)(pair >> 32);
+  const uint32_t right = (uint32_t)pair;
+  const bool inLeft = left == SINK || (left != REJECTING && Automaton_isAccepting(builder->left, left));
+  const bool inRight = right == SINK || (right != REJECTING && Automaton_isAccepting(builder->right, right));
+  switch (builder->operation) {
+  case PRODUCT_UNION:
+    return inLeft || inRight;
+  case PRODUCT_INTERSECTION:
+    return inLeft && inRight;
+  default:
+    return inLeft && !inRight;
+  }
+}
+
+static void _growSlots(ProductBuilder* builder) {
+  const size_t capacity = builder->slotCapacity == 0 ? 64 : 2 * builder->slotCapacity;
+  uint32_t* slots = safeMalloc(capacity * sizeof(uint32_t));
+  memset(slots, 0xFF, capacity * sizeof(uint32_t));
+  for (size_t k = 0; k < builder->pairCount; ++k) {
+    size_t slot = _mix(builder->pairs[k]) & (capacity - 1);
+    while (slots[slot] != EMPTY_SLOT) slot = (slot + 1) & (capacity - 1);
+    slots[slot] = (uint32_t)k;
+  }
+  free(builder->slots);
+  builder->slots = slots;
+  builder->slotCapacity = capacity;
+}
+
+/**
+ * Finds a pair of states, adding it if it's new.
+ *
+ * @return The index of the pair (its product state).
+ */
+static uint32_t _intern(ProductBuilder* builder, uint32_t left, uint32_t right) {
+  const uint64_t pair = _pack(left, right);
+  if (builder->slotCapacity < 2 * (builder->pairCount + 1)) _growSlots(builder);
+  const size_t mask = builder->slotCapacity - 1;
+  size_t slot = _mix(pair) & mask;
+  for (; builder->slots[slot] != EMPTY_SLOT; slot = (slot + 1) & mask) {
+    if (builder->pairs[builder->slots[slot]] == pair) return builder->slots[slot];
+  }
+  builder->pairs = safeReserve(builder->pairs, &builder->pairCapacity, builder->pairCount + 1, sizeof(uint64_t));
+  builder->pairs[builder->pairCount] = pair;
+  builder->slots[slot] = (uint32_t)builder->pairCount;
+  return (uint32_t)builder->pairCount++;
+}
+
+static void _addTransition(ProductBuilder* builder, uint32_t symbol, uint32_t left, uint32_t right) {
+  const uint32_t target = _intern(builder, left, right);
+  if (builder->transitionCount == builder->transitionCapacity) {
+    builder->transitionCapacity = builder->transitionCount == 0 ? 64 : 2 * builder->transitionCount;
+    builder->symbols = realloc(builder->symbols, builder->transitionCapacity * sizeof(uint32_t));
+    builder->targets = realloc(builder->targets, builder->transitionCapacity * sizeof(uint32_t));
+    if (builder->symbols == NULL || builder->targets == NULL) exitWithPerror(__func__, "realloc error");
+  }
+  builder->symbols[builder->transitionCount] = symbol;
+  builder->targets[builder->transitionCount++] = target;
+}
+
+/**
+ * @return The state an operand reaches from `state` (maybe an implicit one)
+ *         reading `symbol`, by a transition in its row at `cursor`, if any.
+ */
+static uint32_t _step(const Automaton* automaton, uint32_t state, SymbolCursor* row, uint32_t symbol) {
+  if (state == REJECTING) return REJECTING;
+  if (state != SINK && row->next < row->count && row->symbols[row->next] == symbol) {
+    return automaton->targets[automaton->offsets[state] + row->next++];
+  }
+  return Automaton_sinkReads(automaton, symbol) ? SINK : REJECTING;
+}
+
+/**
+ * @return Whether a pair can still reach an accepting pair.
+ */
+static bool _isAlive(const ProductBuilder* builder, uint32_t left, uint32_t right) {
+  switch (builder->operation) {
+  case PRODUCT_UNION:
+    return left != REJECTING || right != REJECTING;
+  case PRODUCT_INTERSECTION:
+    return left != REJECTING && right != REJECTING;
+  default:
+    return left != REJECTING;
+  }
+}
+
+/**
+ * @return The symbols a state reads explicitly (all of them, for the sink).
+ */
+static SymbolCursor _row(const Automaton* automaton, uint32_t state) {
+  if (state == REJECTING) return (SymbolCursor){.symbols = NULL, .count = 0, .next = 0};
+  if (state == SINK) return (SymbolCursor){.symbols = automaton->sinkAlphabet, .count = automaton->sinkAlphabetSize};
+  const uint32_t begin = automaton->offsets[state];
+  return (SymbolCursor){.symbols = automaton->symbols + begin, .count = automaton->offsets[state + 1] - begin};
+}
+
+/**
+ * Computes the successors of a pair, merging the symbols both states read,
+ * which are sorted. A symbol a state doesn't read leads it to an implicit
+ * state, and it only has to be considered when that can keep the pair alive:
+ * the sink of a complemented operand, in a union or on the left of a
+ * difference, or on both sides of an intersection. Then the whole alphabet of
+ * the sink is merged too.
+ */
+static void _expand(ProductBuilder* builder, uint32_t id) {
+  const Automaton* left = builder->left;
+  const Automaton* right = builder->right;
+  const uint32_t p = (uint32_t)(builder->pairs[id] >> 32);
+  const uint32_t q = (uint32_t)builder->pairs[id];
+  SymbolCursor leftRow = _row(left, p);
+  SymbolCursor rightRow = _row(right, q);
+  SymbolCursor cursors[4] = {leftRow, rightRow, {0}, {0}};
+  const ProductOperation operation = builder->operation;
+  if (p != REJECTING && p != SINK && left->acceptingSink &&
+      (operation != PRODUCT_INTERSECTION || right->acceptingSink)) {
+    cursors[2] = (SymbolCursor){.symbols = left->sinkAlphabet, .count = left->sinkAlphabetSize};
+  }
+  if (q != REJECTING && q != SINK && right->acceptingSink && operation == PRODUCT_UNION) {
+    cursors[3] = (SymbolCursor){.symbols = right->sinkAlphabet, .count = right->sinkAlphabetSize};
+  }
+
+  builder->offsets = safeReserve(builder->offsets, &builder->offsetCapacity, (size_t)id + 2, sizeof(uint32_t));
+  builder->offsets[id] = (uint32_t)builder->transitionCount;
+  for (;;) {
+    uint32_t symbol = UINT32_MAX;
+    bool found = false;
+    for (int k = 0; k < 4; ++k) {
+      if (cursors[k].next < cursors[k].count && (!found || cursors[k].symbols[cursors[k].next] < symbol)) {
+        symbol = cursors[k].symbols[cursors[k].next];
+        found = true;
+      }
+    }
+    if (!found) break;
+    for (int k = 0; k < 4; ++k) {
+      if (cursors[k].next < cursors[k].count && cursors[k].symbols[cursors[k].next] == symbol) ++cursors[k].next;
+    }
+    const uint32_t l = _step(left, p, &leftRow, symbol);
+    const uint32_t r = _step(right, q, &rightRow, symbol);
+    if (_isAlive(builder, l, r)) _addTransition(builder, symbol, l, r);
+  }
+}
+
+/**
+ * Computes the successors of a pair of NFA states: for every symbol both
+ * read, every pair of their targets on it.
+ */
+static void _expandNondeterministic(ProductBuilder* builder, uint32_t id) {
+  const Automaton* left = builder->left;
+  const Automaton* right = builder->right;
+  const uint32_t p = (uint32_t)(builder->pairs[id] >> 32);
+  const uint32_t q = (uint32_t)builder->pairs[id];
+  builder->offsets = safeReserve(builder->offsets, &builder->offsetCapacity, (size_t)id + 2, sizeof(uint32_t));
+  builder->offsets[id] = (uint32_t)builder->transitionCount;
+  uint32_t i = left->offsets[p];
+  uint32_t j = right->offsets[q];
+  while (i < left->offsets[p + 1] && j < right->offsets[q + 1]) {
+    const uint32_t symbol = left->symbols[i];
+    if (symbol < right->symbols[j]) {
+      ++i;
+    } else if (right->symbols[j] < symbol) {
+      ++j;
+    } else {
+      uint32_t leftEnd = i;
+      while (leftEnd < left->offsets[p + 1] && left->symbols[leftEnd] == symbol) ++leftEnd;
+      uint32_t rightEnd = j;
+      while (rightEnd < right->offsets[q + 1] && right->symbols[rightEnd] == symbol) ++rightEnd;
+      for (uint32_t k = i; k < leftEnd; ++k) {
+        for (uint32_t l = j; l < rightEnd; ++l) {
+          _addTransition(builder, symbol, left->targets[k], right->targets[l]);
+        }
+      }
+      i = leftEnd;
+      j = rightEnd;
+    }
+  }
+}
+
+/**
+ * @return The automaton of the pairs found, the first `initialCount` of them
+ *         initial.
+ */
+static Automaton* _toAutomaton(ProductBuilder* builder, uint32_t initialCount) {
+  builder->offsets[builder->pairCount] = (uint32_t)builder->transitionCount;
+  Automaton* automaton = Automaton_new((uint32_t)builder->pairCount, (uint32_t)builder->transitionCount, initialCount);
+  for (uint32_t k = 0; k < initialCount; ++k) {
+    automaton->initialStates[k] = k;
+  }
+  memcpy(automaton->offsets, builder->offsets, (1 + builder->pairCount) * sizeof(uint32_t));
+  if (0 < builder->transitionCount) {
+    memcpy(automaton->symbols, builder->symbols, builder->transitionCount * sizeof(uint32_t));
+    memcpy(automaton->targets, builder->targets, builder->transitionCount * sizeof(uint32_t));
+  }
+  for (size_t id = 0; id < builder->pairCount; ++id) {
+    if (_isAccepting(builder, builder->pairs[id])) Bitset_set(automaton->accepting, id);
+  }
+  return automaton;
+}
+
+static uint64_t _hashTuple(const uint32_t* tuple, size_t width) {
+  uint64_t hash = 0;
+  for (size_t k = 0; k < width; ++k) {
+    hash = _mix(hash ^ tuple[k]);
+  }
+  return hash;
+}
+
+static void _growTupleSlots(TupleBuilder* builder) {
+  const size_t capacity = builder->slotCapacity == 0 ? 64 : 2 * builder->slotCapacity;
+  uint32_t* slots = safeMalloc(capacity * sizeof(uint32_t));
+  memset(slots, 0xFF, capacity * sizeof(uint32_t));
+  for (size_t k = 0; k < builder->tupleCount; ++k) {
+    size_t slot = builder->hashes[k] & (capacity - 1);
+    while (slots[slot] != EMPTY_SLOT) slot = (slot + 1) & (capacity - 1);
+    slots[slot] = (uint32_t)k;
+  }
+  free(builder->slots);
+  builder->slots = slots;
+  builder->slotCapacity = capacity;
+}
+
+/**
+ * Finds a tuple of states, adding it if it's new.
+ *
+ * @return The index of the tuple (its product state).
+ */
+static uint32_t _internTuple(TupleBuilder* builder, const uint32_t* tuple) {
+  const size_t width = builder->width;
+  const uint64_t hash = _hashTuple(tuple, width);
+  if (builder->slotCapacity < 2 * (builder->tupleCount + 1)) _growTupleSlots(builder);
+  const size_t mask = builder->slotCapacity - 1;
+  size_t slot = hash & mask;
+  for (; builder->slots[slot] != EMPTY_SLOT; slot = (slot + 1) & mask) {
+    const uint32_t id = builder->slots[slot];
+    if (builder->hashes[id] == hash && memcmp(builder->tuples + id * width, tuple, width * sizeof(uint32_t)) == 0) {
+      return id;
+    }
+  }
+  builder->tuples =
+    safeReserve(builder->tuples, &builder->tupleCapacity, (builder->tupleCount + 1) * width, sizeof(uint32_t));
+  memcpy(builder->tuples + builder->tupleCount * width, tuple, width * sizeof(uint32_t));
+  builder->hashes = safeReserve(builder->hashes, &builder->hashCapacity, builder->tupleCount + 1, sizeof(uint64_t));
+  builder->hashes[builder->tupleCount] = hash;
+  builder->slots[slot] = (uint32_t)builder->tupleCount;
+  return (uint32_t)builder->tupleCount++;
+}
+
+static void _addTupleTransition(TupleBuilder* builder, uint32_t symbol) {
+  const uint32_t target = _internTuple(builder, builder->next);
+  if (builder->transitionCount == builder->transitionCapacity) {
+    builder->transitionCapacity = builder->transitionCount == 0 ? 64 : 2 * builder->transitionCount;
+    builder->symbols = realloc(builder->symbols, builder->transitionCapacity * sizeof(uint32_t));
+    builder->targets = realloc(builder->targets, builder->transitionCapacity * sizeof(uint32_t));
+    if (builder->symbols == NULL || builder->targets == NULL) exitWithPerror(__func__, "realloc error");
+  }
+  builder->symbols[builder->transitionCount] = symbol;
+  builder->targets[builder->transitionCount++] = target;
+}
+
+static bool _isAcceptingTuple(const TupleBuilder* builder, const uint32_t* tuple) {
+  for (size_t k = 0; k < builder->width; ++k) {
+    const bool accepting = tuple[k] != REJECTING && Automaton_isAccepting(builder->operands[k], tuple[k]);
+    if (accepting != (builder->operation == PRODUCT_INTERSECTION)) return accepting;
+  }
+  return builder->operation == PRODUCT_INTERSECTION;
+}
+
+/**
+ * Computes the successors of a tuple. An intersection follows the symbols of
+ * the first operand, and drops a symbol as soon as an operand doesn't read
+ * it; a union follows every symbol some operand reads (merged, as rows are
+ * sorted), and the others reject it.
+ */
+static void _expandTuple(TupleBuilder* builder, uint32_t id) {
+  const size_t width = builder->width;
+  const Automaton* const* operands = builder->operands;
+  uint32_t* current = builder->current;
+  uint32_t* cursors = builder->cursors;
+  memcpy(current, builder->tuples + id * width, width * sizeof(uint32_t));
+  for (size_t k = 0; k < width; ++k) {
+    cursors[k] = current[k] == REJECTING ? 0 : operands[k]->offsets[current[k]];
+  }
+  builder->offsets = safeReserve(builder->offsets, &builder->offsetCapacity, (size_t)id + 2, sizeof(uint32_t));
+  builder->offsets[id] = (uint32_t)builder->transitionCount;
+
+  if (builder->operation == PRODUCT_INTERSECTION) {
+    for (uint32_t t = cursors[0]; t < operands[0]->offsets[current[0] + 1]; ++t) {
+      const uint32_t symbol = operands[0]->symbols[t];
+      builder->next[0] = operands[0]->targets[t];
+      bool alive = true;
+      for (size_t k = 1; alive && k < width; ++k) {
+        const uint32_t end = operands[k]->offsets[current[k] + 1];
+        while (cursors[k] < end && operands[k]->symbols[cursors[k]] < symbol) ++cursors[k];
+        alive = cursors[k] < end && operands[k]->symbols[cursors[k]] == symbol;
+        if (alive) builder->next[k] = operands[k]->targets[cursors[k]];
+      }
+      if (alive) _addTupleTransition(builder, symbol);
+    }
+    return;
+  }
+  for (;;) {
+    uint32_t symbol = UINT32_MAX;
+    bool found = false;
+    for (size_t k = 0; k < width; ++k) {
+      if (current[k] == REJECTING || operands[k]->offsets[current[k] + 1] <= cursors[k]) continue;
+      if (!found || operands[k]->symbols[cursors[k]] < symbol) symbol = operands[k]->symbols[cursors[k]];
+      found = true;
+    }
+    if (!found) break;
+    for (size_t k = 0; k < width; ++k) {
+      const bool reads = current[k] != REJECTING && cursors[k] < operands[k]->offsets[current[k] + 1] &&
+                         operands[k]->symbols[cursors[k]] == symbol;
+      builder->next[k] = reads ? operands[k]->targets[cursors[k]++] : REJECTING;
+    }
+    _addTupleTransition(builder, symbol);
+  }
+}
+
+static void _freeTupleBuilder(TupleBuilder* builder) {
+  free(builder->tuples);
+  free(builder->hashes);
+  free(builder->slots);
+  free(builder->offsets);
+  free(builder->symbols);
+  free(builder->targets);
+  free(builder->current);
+  free(builder->next);
+  free(builder->cursors);
+}
+
+static void _freeBuilder(ProductBuilder* builder) {
+  free(builder->pairs);
+  free(builder->slots);
+  free(builder->offsets);
+  free(builder->symbols);
+  free(builder->targets);
+}
+
+static const char* _operationName(ProductOperation operation) {
+  switch (operation) {
+  case PRODUCT_UNION:
+    return "union";
+  case PRODUCT_INTERSECTION:
+    return "intersection";
+  default:
+    return "difference";
+  }
+}
+
+/* PUBLIC FUNCTIONS */
+
+Automaton* buildProduct(const Automaton* left, const Automaton* right, ProductOperation operation) {
+  if (!left->deterministic || !right->deterministic) {
+    exitInvalidArgument(__func__, "the product needs deterministic automata");
+  }
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  ProductBuilder builder = {.left = left, .right = right, .operation = operation};
+  const uint32_t leftInitial = left->initialStateCount == 0 ? REJECTING : left->initialStates[0];
+  const uint32_t rightInitial = right->initialStateCount == 0 ? REJECTING : right->initialStates[0];
+  _intern(&builder, leftInitial, rightInitial);
+
+  // The pairs are a worklist: each one is expanded once, in the order it was found.
+  for (size_t id = 0; id < builder.pairCount; ++id) {
+    _expand(&builder, (uint32_t)id);
+  }
+  Automaton* dfa = _toAutomaton(&builder, 1);
+  dfa->deterministic = true;
+
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  const double milliseconds = 1e3 * (double)(end.tv_sec - start.tv_sec) + 1e-6 * (double)(end.tv_nsec - start.tv_nsec);
+  logDebugging(
+    _logger, "Built the %s of %u and %u states from %u reachable pairs (of %llu possible) in %.3f ms.",
+    _operationName(operation), left->stateCount, right->stateCount, dfa->stateCount,
+    (unsigned long long)(left->stateCount + 1ULL) * (right->stateCount + 1ULL), milliseconds
+  );
+  _freeBuilder(&builder);
+  return dfa;
+}
+
+Automaton* buildMultiProduct(const Automaton* const* operands, size_t count, ProductOperation operation) {
+  if (operation == PRODUCT_DIFFERENCE) exitInvalidArgument(__func__, "a difference only has two operands");
+  if (count == 0) exitInvalidArgument(__func__, "the product needs operands");
+  bool sinks = false;
+  for (size_t k = 0; k < count; ++k) {
+    if (!operands[k]->deterministic) exitInvalidArgument(__func__, "the product needs deterministic automata");
+    sinks = sinks || operands[k]->acceptingSink;
+  }
+  if (count == 1) return Automaton_copy(operands[0]);
+  if (count == 2) return buildProduct(operands[0], operands[1], operation);
+  if (sinks) {
+    Automaton** complete = safeMalloc(count * sizeof(Automaton*));
+    for (size_t k = 0; k < count; ++k) {
+      complete[k] = Automaton_materializeSink(operands[k]);
+    }
+    Automaton* product = buildMultiProduct((const Automaton* const*)complete, count, operation);
+    for (size_t k = 0; k < count; ++k) {
+      Automaton_free(complete[k]);
+    }
+    free(complete);
+    return product;
+  }
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  TupleBuilder builder = {
+    .operands = operands,
+    .width = count,
+    .operation = operation,
+    .current = safeMalloc(count * sizeof(uint32_t)),
+    .next = safeMalloc(count * sizeof(uint32_t)),
+    .cursors = safeMalloc(count * sizeof(uint32_t)),
+  };
+  bool rejected = false;
+  for (size_t k = 0; k < count; ++k) {
+    builder.next[k] = operands[k]->initialStateCount == 0 ? REJECTING : operands[k]->initialStates[0];
+    rejected = rejected || builder.next[k] == REJECTING;
+  }
+  if (operation == PRODUCT_INTERSECTION && rejected) {
+    _freeTupleBuilder(&builder);
+    return Automaton_empty();
+  }
+  _internTuple(&builder, builder.next);
+
+  // The tuples are a worklist: each one is expanded once, in the order it was found.
+  for (size_t id = 0; id < builder.tupleCount; ++id) {
+    _expandTuple(&builder, (uint32_t)id);
+  }
+  builder.offsets[builder.tupleCount] = (uint32_t)builder.transitionCount;
+  Automaton* dfa = Automaton_new((uint32_t)builder.tupleCount, (uint32_t)builder.transitionCount, 1);
+  dfa->initialStates[0] = 0;
+  memcpy(dfa->offsets, builder.offsets, (1 + builder.tupleCount) * sizeof(uint32_t));
+  if (0 < builder.transitionCount) {
+    memcpy(dfa->symbols, builder.symbols, builder.transitionCount * sizeof(uint32_t));
+    memcpy(dfa->targets, builder.targets, builder.transitionCount * sizeof(uint32_t));
+  }
+  for (size_t id = 0; id < builder.tupleCount; ++id) {
+    if (_isAcceptingTuple(&builder, builder.tuples + id * count)) Bitset_set(dfa->accepting, id);
+  }
+  dfa->deterministic = true;
+
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  const double milliseconds = 1e3 * (double)(end.tv_sec - start.tv_sec) + 1e-6 * (double)(end.tv_nsec - start.tv_nsec);
+  logDebugging(
+    _logger, "Built the %s of %zu DFAs at once from %u reachable tuples in %.3f ms.", _operationName(operation), count,
+    dfa->stateCount, milliseconds
+  );
+  _freeTupleBuilder(&builder);
+  return dfa;
+}
+
+Automaton* buildNondeterministicIntersection(const Automaton* left, const Automaton* right) {
+  if (left->acceptingSink || right->acceptingSink || Automaton_hasEpsilons(left) || Automaton_hasEpsilons(right)) {
+    Automaton* completeLeft = Automaton_materializeSink(left);
+    Automaton* completeRight = Automaton_materializeSink(right);
+    Automaton* leftWithoutEpsilons = removeEpsilons(completeLeft);
+    Automaton* rightWithoutEpsilons = removeEpsilons(completeRight);
+    Automaton* intersection = buildNondeterministicIntersection(leftWithoutEpsilons, rightWithoutEpsilons);
+    Automaton_free(completeLeft);
+    Automaton_free(completeRight);
+    Automaton_free(leftWithoutEpsilons);
+    Automaton_free(rightWithoutEpsilons);
+    return intersection;
+  }
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  ProductBuilder builder = {.left = left, .right = right, .operation = PRODUCT_INTERSECTION};
+  for (uint32_t k = 0; k < left->initialStateCount; ++k) {
+    for (uint32_t l = 0; l < right->initialStateCount; ++l) {
+      _intern(&builder, left->initialStates[k], right->initialStates[l]);
+    }
+  }
+  const uint32_t initialCount = (uint32_t)builder.pairCount;
+  builder.offsets = safeReserve(builder.offsets, &builder.offsetCapacity, 1, sizeof(uint32_t));
+  for (size_t id = 0; id < builder.pairCount; ++id) {
+    _expandNondeterministic(&builder, (uint32_t)id);
+  }
+  Automaton* nfa = _toAutomaton(&builder, initialCount);
+  Automaton_normalize(nfa);
+
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  const double milliseconds = 1e3 * (double)(end.tv_sec - start.tv_sec) + 1e-6 * (double)(end.tv_nsec - start.tv_nsec);
+  logDebugging(
+    _logger, "Built the NFA intersection of %u and %u states from %u reachable pairs (of %llu possible) in %.3f ms.",
+    left->stateCount, right->stateCount, nfa->stateCount,
+    (unsigned long long)left->stateCount * right->stateCount, milliseconds
+  );
+  _freeBuilder(&builder);
+  return nfa;
+}
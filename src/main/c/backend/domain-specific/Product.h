@@ -0,0 +1,68 @@
+#ifndef PRODUCT_HEADER
+#define PRODUCT_HEADER
+
+#include "Automaton.h"
+#include <stddef.h>
+
+/** Initialize module's internal state. */
+void initializeProductModule();
+
+/** Shutdown module's internal state. */
+void shutdownProductModule();
+
+/**
+ * The language operation a product computes, by the states it accepts.
+ */
+typedef enum {
+  PRODUCT_UNION,
+  PRODUCT_INTERSECTION,
+  PRODUCT_DIFFERENCE
+} ProductOperation;
+
+/**
+ * Builds a DFA for the union, intersection or difference of the languages of
+ * two DFAs, by running them side by side. Only the pairs of states reachable
+ * from the initial pair are explored, so the result is never larger than the
+ * part of the |left| x |right| table that is actually reached.
+ *
+ * A missing transition of a (partial) operand is followed as an implicit
+ * rejecting state, which is also what the difference uses for the
+ * complement of `right`: a pair is accepting when `left` accepts and `right`
+ * doesn't, so no complement is ever built. The accepting sink of a
+ * complemented operand is followed implicitly too, but the pairs it reaches
+ * are built, with a transition per symbol of its alphabet.
+ *
+ * @return A heap-allocated deterministic automaton, whose states are numbered
+ *         in the order they were discovered (the initial state is 0).
+ */
+Automaton* buildProduct(const Automaton* left, const Automaton* right, ProductOperation operation);
+
+/**
+ * Builds a DFA for the union or intersection of the languages of several
+ * DFAs at once, by running all of them side by side: its states are the
+ * tuples of their states reachable from the initial tuple. Unlike a chain of
+ * pairwise products, no intermediate automaton is built, and an intersection
+ * never explores a tuple that a later operand would reject.
+ *
+ * Operands are stepped in the given order, and an intersection stops
+ * stepping a tuple as soon as one of them rejects the symbol, so the most
+ * restrictive ones should come first. Accepting sinks are built first; two
+ * operands are just a `buildProduct`.
+ *
+ * @return A heap-allocated deterministic automaton, whose states are numbered
+ *         in the order they were discovered (the initial state is 0).
+ */
+Automaton* buildMultiProduct(const Automaton* const* operands, size_t count, ProductOperation operation);
+
+/**
+ * Builds an NFA for the intersection of the languages of two NFAs, without
+ * determinizing them: a pair of states reads a symbol when both do, and
+ * reaches every pair of their targets on it. Its initial pairs are those of
+ * initial states. Epsilon transitions are removed first, and accepting sinks
+ * are built.
+ *
+ * @return A heap-allocated automaton, with only the reachable pairs.
+ */
+Automaton* buildNondeterministicIntersection(const Automaton* left, const Automaton* right);
+
+#endif
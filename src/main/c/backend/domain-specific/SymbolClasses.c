@@ -0,0 +1,221 @@
+#include "SymbolClasses.h"
+#include "../../shared/Logger.h"
+#include "../../shared/utils.h"
+#include "Alphabet.h"
+#include "Automaton.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* MODULE INTERNAL STATE */
+
+#define EMPTY_SLOT UINT32_MAX
+
+static Logger* _logger = NULL;
+
+void initializeSymbolClassesModule() {
+  _logger = createLogger("SymbolClasses");
+}
+
+void shutdownSymbolClassesModule() {
+  if (_logger != NULL) {
+    destroyLogger(_logger);
+  }
+}
+
+/**
+ * A place where a symbol appears: the transition `edge` (packed as
+ * `tail << 32 | head`) of automaton `source`, or the alphabet `source` (past
+ * the automata) with no edge. Two symbols are equivalent when they appear in
+ * the same places.
+ */
+typedef struct {
+  uint32_t symbol;
+  uint32_t source;
+  uint64_t edge;
+} Occurrence;
+
+typedef struct {
+  Occurrence* occurrences;
+  size_t count;
+  size_t capacity;
+} OccurrenceList;
+
+/* PRIVATE FUNCTIONS */
+
+static void _addOccurrence(OccurrenceList* list, uint32_t symbol, uint32_t source, uint64_t edge) {
+  if (list->count == list->capacity) {
+    list->capacity = list->capacity == 0 ? 64 : 2 * list->capacity;
+    list->occurrences = realloc(list->occurrences, list->capacity * sizeof(Occurrence));
+    if (list->occurrences == NULL) exitWithPerror(__func__, "realloc error");
+  }
+  list->occurrences[list->count++] = (Occurrence){.symbol = symbol, .source = source, .edge = edge};
+}
+
+static int _compareOccurrences(const void* left, const void* right) {
+  const Occurrence* a = left;
+  const Occurrence* b = right;
+  if (a->symbol != b->symbol) return (a->symbol > b->symbol) - (a->symbol < b->symbol);
+  if (a->source != b->source) return (a->source > b->source) - (a->source < b->source);
+  return (a->edge > b->edge) - (a->edge < b->edge);
+}
+
+static inline uint64_t _mix(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+static bool _samePlaces(const Occurrence* left, const Occurrence* right, size_t count) {
+  for (size_t k = 0; k < count; ++k) {
+    if (left[k].source != right[k].source || left[k].edge != right[k].edge) return false;
+  }
+  return true;
+}
+
+static int _compareSymbols(const void* left, const void* right) {
+  const uint32_t a = *(const uint32_t*)left;
+  const uint32_t b = *(const uint32_t*)right;
+  return (a > b) - (a < b);
+}
+
+/* PUBLIC FUNCTIONS */
+
+SymbolClasses* computeSymbolClasses(
+  const Automaton* const* automata, size_t automatonCount, const uint32_t* const* alphabets,
+  const uint32_t* alphabetSizes, size_t alphabetCount
+) {
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  const uint32_t symbolCount = Alphabet_size();
+  OccurrenceList list = {0};
+  for (size_t a = 0; a < automatonCount; ++a) {
+    const Automaton* automaton = automata[a];
+    for (uint32_t state = 0; state < automaton->stateCount; ++state) {
+      for (uint32_t k = automaton->offsets[state]; k < automaton->offsets[state + 1]; ++k) {
+        if (automaton->symbols[k] == EPSILON) continue;
+        _addOccurrence(&list, automaton->symbols[k], (uint32_t)a, (uint64_t)state << 32 | automaton->targets[k]);
+      }
+    }
+  }
+  for (size_t a = 0; a < alphabetCount; ++a) {
+    for (uint32_t k = 0; k < alphabetSizes[a]; ++k) {
+      _addOccurrence(&list, alphabets[a][k], (uint32_t)(automatonCount + a), 0);
+    }
+  }
+  if (1 < list.count) qsort(list.occurrences, list.count, sizeof(Occurrence), _compareOccurrences);
+
+  // The places of symbol `s` are `occurrences[begin[s]..begin[s + 1]]`, without repetitions.
+  size_t* begin = safeCalloc((size_t)symbolCount + 1, sizeof(size_t));
+  size_t unique = 0;
+  for (size_t k = 0; k < list.count; ++k) {
+    if (0 < unique && _compareOccurrences(&list.occurrences[unique - 1], &list.occurrences[k]) == 0) continue;
+    if (symbolCount <= list.occurrences[k].symbol) exitInvalidArgument(__func__, "symbol out of the alphabet");
+    list.occurrences[unique++] = list.occurrences[k];
+    ++begin[list.occurrences[k].symbol + 1];
+  }
+  for (uint32_t s = 0; s < symbolCount; ++s) {
+    begin[s + 1] += begin[s];
+  }
+
+  // Symbols are classified in increasing order, so each class is found (and numbered) by its smallest symbol.
+  SymbolClasses* classes = safeMalloc(sizeof(SymbolClasses));
+  const size_t capacity = symbolCount == 0 ? 1 : symbolCount;
+  classes->symbolCount = symbolCount;
+  classes->classCount = 0;
+  classes->classOf = safeMalloc(capacity * sizeof(uint32_t));
+  classes->representatives = safeMalloc(capacity * sizeof(uint32_t));
+  classes->sizes = safeCalloc(capacity, sizeof(uint32_t));
+  uint32_t slotCapacity = 64;
+  while (slotCapacity < 2 * (size_t)symbolCount) slotCapacity *= 2;
+  uint32_t* slots = safeMalloc(slotCapacity * sizeof(uint32_t));
+  memset(slots, 0xFF, slotCapacity * sizeof(uint32_t));
+  for (uint32_t s = 0; s < symbolCount; ++s) {
+    const Occurrence* places = list.occurrences + begin[s];
+    const size_t count = begin[s + 1] - begin[s];
+    uint64_t hash = _mix(count);
+    for (size_t k = 0; k < count; ++k) {
+      hash = _mix(hash ^ _mix((uint64_t)places[k].source << 32 ^ places[k].edge));
+    }
+    uint32_t slot = (uint32_t)hash & (slotCapacity - 1);
+    for (; slots[slot] != EMPTY_SLOT; slot = (slot + 1) & (slotCapacity - 1)) {
+      const uint32_t other = classes->representatives[slots[slot]];
+      if (begin[other + 1] - begin[other] == count && _samePlaces(list.occurrences + begin[other], places, count)) {
+        break;
+      }
+    }
+    if (slots[slot] == EMPTY_SLOT) {
+      slots[slot] = classes->classCount;
+      classes->representatives[classes->classCount++] = s;
+    }
+    classes->classOf[s] = slots[slot];
+    ++classes->sizes[slots[slot]];
+  }
+  free(slots);
+  free(begin);
+  free(list.occurrences);
+
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  const double milliseconds = 1e3 * (double)(end.tv_sec - start.tv_sec) + 1e-6 * (double)(end.tv_nsec - start.tv_nsec);
+  logDebugging(
+    _logger, "Partitioned %u symbols into %u classes (%zu places) in %.3f ms.", symbolCount, classes->classCount,
+    unique, milliseconds
+  );
+  return classes;
+}
+
+void SymbolClasses_free(SymbolClasses* classes) {
+  if (classes == NULL) return;
+  free(classes->classOf);
+  free(classes->representatives);
+  free(classes->sizes);
+  free(classes);
+}
+
+void SymbolClasses_relabelAutomaton(const SymbolClasses* classes, Automaton* automaton) {
+  for (uint32_t k = 0; k < automaton->transitionCount; ++k) {
+    if (automaton->symbols[k] != EPSILON) automaton->symbols[k] = classes->classOf[automaton->symbols[k]];
+  }
+  Automaton_normalize(automaton);
+  // Symbols of a class lead to the same states, so their transitions are now repeated.
+  uint32_t position = 0;
+  uint32_t begin = 0;
+  for (uint32_t state = 0; state < automaton->stateCount; ++state) {
+    const uint32_t end = automaton->offsets[state + 1];
+    automaton->offsets[state] = position;
+    const uint32_t rowStart = position;
+    for (uint32_t k = begin; k < end; ++k) {
+      if (rowStart < position && automaton->symbols[position - 1] == automaton->symbols[k] &&
+          automaton->targets[position - 1] == automaton->targets[k]) {
+        continue;
+      }
+      automaton->symbols[position] = automaton->symbols[k];
+      automaton->targets[position++] = automaton->targets[k];
+    }
+    begin = end;
+  }
+  automaton->offsets[automaton->stateCount] = position;
+  automaton->transitionCount = position;
+  Automaton_normalize(automaton);
+  if (automaton->acceptingSink) {
+    automaton->sinkAlphabetSize =
+      SymbolClasses_relabelAlphabet(classes, automaton->sinkAlphabet, automaton->sinkAlphabetSize);
+  }
+}
+
+uint32_t SymbolClasses_relabelAlphabet(const SymbolClasses* classes, uint32_t* alphabet, uint32_t size) {
+  for (uint32_t k = 0; k < size; ++k) {
+    alphabet[k] = classes->classOf[alphabet[k]];
+  }
+  if (1 < size) qsort(alphabet, size, sizeof(uint32_t), _compareSymbols);
+  uint32_t unique = 0;
+  for (uint32_t k = 0; k < size; ++k) {
+    if (unique == 0 || alphabet[unique - 1] != alphabet[k]) alphabet[unique++] = alphabet[k];
+  }
+  return unique;
+}
@@ -0,0 +1,58 @@
+#ifndef SYMBOL_CLASSES_HEADER
+#define SYMBOL_CLASSES_HEADER
+
+#include "Automaton.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/** Initialize module's internal state. */
+void initializeSymbolClassesModule();
+
+/** Shutdown module's internal state. */
+void shutdownSymbolClassesModule();
+
+/**
+ * A partition of the global alphabet in classes of symbols that behave the
+ * same everywhere: two symbols are in the same class when every automaton
+ * has the same transitions on both, and every alphabet has both or neither.
+ * Since every language operation preserves that, automata can be labeled
+ * with classes instead of symbols, and their rows grow with the number of
+ * behaviours they distinguish, not with the size of the alphabet.
+ *
+ * Classes are numbered by their smallest symbol, which represents them.
+ */
+typedef struct {
+  uint32_t symbolCount;
+  uint32_t classCount;
+  uint32_t* classOf;
+  uint32_t* representatives;
+  uint32_t* sizes;
+} SymbolClasses;
+
+/**
+ * Partitions the interned symbols by the transitions of `automata` (labeled
+ * with symbols) and by the sorted `alphabets`.
+ *
+ * @return A heap-allocated partition, released with `SymbolClasses_free`.
+ */
+SymbolClasses* computeSymbolClasses(
+  const Automaton* const* automata, size_t automatonCount, const uint32_t* const* alphabets,
+  const uint32_t* alphabetSizes, size_t alphabetCount
+);
+
+void SymbolClasses_free(SymbolClasses* classes);
+
+/**
+ * Relabels the transitions of an automaton (and its sink alphabet) with
+ * the classes of their symbols, merging the ones that become equal.
+ */
+void SymbolClasses_relabelAutomaton(const SymbolClasses* classes, Automaton* automaton);
+
+/**
+ * Replaces the sorted symbols of an alphabet by their sorted classes.
+ *
+ * @return The number of classes.
+ */
+uint32_t SymbolClasses_relabelAlphabet(const SymbolClasses* classes, uint32_t* alphabet, uint32_t size);
+
+#endif
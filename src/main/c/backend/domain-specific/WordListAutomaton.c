@@ -0,0 +1,361 @@
+#include "WordListAutomaton.h"
+#include "../../frontend/lexical-analysis/SymbolFileReader.h"
+#include "../../shared/Bitset.h"
+#include "../../shared/Logger.h"
+#include "../../shared/MappedFile.h"
+#include "../../shared/hashUtils.h"
+#include "../../shared/utils.h"
+#include "Alphabet.h"
+#include "Automaton.h"
+#include <ctype.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* MODULE INTERNAL STATE */
+
+#define EMPTY_SLOT UINT32_MAX
+
+static Logger* _logger = NULL;
+
+void initializeWordListAutomatonModule() {
+  _logger = createLogger("WordListAutomaton");
+}
+
+void shutdownWordListAutomatonModule() {
+  if (_logger != NULL) {
+    destroyLogger(_logger);
+  }
+}
+
+typedef struct {
+  uint32_t symbol;
+  uint32_t target;
+} Transition;
+
+typedef struct {
+  Transition* transitions;
+  uint32_t transitionCount;
+  uint32_t transitionCapacity;
+  uint32_t hash;
+  bool final;
+} State;
+
+/**
+ * The automaton under construction. States along the path of the last word
+ * added are still open (they may get new transitions); every other state is
+ * in the register, where no two states are equivalent. When a state of the
+ * path gets closed, it's either registered or replaced by its equivalent, so
+ * the automaton is always minimal except for the open path.
+ */
+typedef struct {
+  State* states;
+  uint32_t stateCount;
+  uint32_t stateCapacity;
+  // Ids of replaced states, reused before growing `states`.
+  uint32_t* freeStates;
+  uint32_t freeCount;
+  uint32_t freeCapacity;
+  uint32_t liveStates;
+  uint32_t peakStates;
+  // Open-addressing table of registered states, keyed by their transitions and finality.
+  uint32_t* registry;
+  uint32_t registryCapacity;
+  uint32_t registeredCount;
+  // The last word added, and the states along its path (`path[0]` is the initial state).
+  uint32_t* word;
+  size_t wordLength;
+  size_t wordCapacity;
+  uint32_t* path;
+  size_t pathCapacity;
+} Builder;
+
+/* PRIVATE FUNCTIONS */
+
+static uint32_t _newState(Builder* builder) {
+  uint32_t id;
+  if (0 < builder->freeCount) {
+    id = builder->freeStates[--builder->freeCount];
+  } else {
+    size_t capacity = builder->stateCapacity;
+    builder->states = safeReserve(builder->states, &capacity, builder->stateCount + 1, sizeof(State));
+    builder->stateCapacity = (uint32_t)capacity;
+    id = builder->stateCount++;
+  }
+  builder->states[id] = (State){.transitions = NULL, .transitionCount = 0, .transitionCapacity = 0, .final = false};
+  if (builder->peakStates < ++builder->liveStates) builder->peakStates = builder->liveStates;
+  return id;
+}
+
+static void _freeState(Builder* builder, uint32_t id) {
+  free(builder->states[id].transitions);
+  builder->states[id].transitions = NULL;
+  size_t capacity = builder->freeCapacity;
+  builder->freeStates = safeReserve(builder->freeStates, &capacity, builder->freeCount + 1, sizeof(uint32_t));
+  builder->freeCapacity = (uint32_t)capacity;
+  builder->freeStates[builder->freeCount++] = id;
+  --builder->liveStates;
+}
+
+static void _addTransition(Builder* builder, uint32_t from, uint32_t symbol, uint32_t target) {
+  State* state = &builder->states[from];
+  size_t capacity = state->transitionCapacity;
+  state->transitions = safeReserve(state->transitions, &capacity, state->transitionCount + 1, sizeof(Transition));
+  state->transitionCapacity = (uint32_t)capacity;
+  state->transitions[state->transitionCount++] = (Transition){.symbol = symbol, .target = target};
+}
+
+/**
+ * Sorts the transitions by symbol id (insertion sort, as they're almost
+ * always few and already sorted), so equivalent states look the same.
+ */
+static void _sortTransitions(State* state) {
+  for (uint32_t k = 1; k < state->transitionCount; ++k) {
+    Transition transition = state->transitions[k];
+    uint32_t j = k;
+    for (; 0 < j && transition.symbol < state->transitions[j - 1].symbol; --j) {
+      state->transitions[j] = state->transitions[j - 1];
+    }
+    state->transitions[j] = transition;
+  }
+}
+
+static bool _equivalent(const State* state, const State* other) {
+  return state->hash == other->hash && state->final == other->final &&
+         state->transitionCount == other->transitionCount &&
+         (state->transitionCount == 0 ||
+          memcmp(state->transitions, other->transitions, state->transitionCount * sizeof(Transition)) == 0);
+}
+
+static void _growRegistry(Builder* builder) {
+  const uint32_t capacity = builder->registryCapacity == 0 ? 64 : 2 * builder->registryCapacity;
+  uint32_t* registry = safeMalloc(capacity * sizeof(uint32_t));
+  memset(registry, 0xFF, capacity * sizeof(uint32_t));
+  for (uint32_t k = 0; k < builder->registryCapacity; ++k) {
+    const uint32_t id = builder->registry[k];
+    if (id == EMPTY_SLOT) continue;
+    uint32_t slot = builder->states[id].hash & (capacity - 1);
+    while (registry[slot] != EMPTY_SLOT) slot = (slot + 1) & (capacity - 1);
+    registry[slot] = id;
+  }
+  free(builder->registry);
+  builder->registry = registry;
+  builder->registryCapacity = capacity;
+}
+
+/**
+ * Closes the state at `depth` of the current path: if an equivalent state is
+ * already registered, the parent is redirected to it and the state is
+ * released; otherwise, the state is registered.
+ */
+static void _replaceOrRegister(Builder* builder, size_t depth) {
+  const uint32_t id = builder->path[depth];
+  State* state = &builder->states[id];
+  _sortTransitions(state);
+  const uint8_t final = state->final;
+  state->hash = murmurHash3(2, &final, sizeof(final), state->transitions, state->transitionCount * sizeof(Transition));
+
+  if (builder->registryCapacity < 2 * (builder->registeredCount + 1)) _growRegistry(builder);
+  const uint32_t mask = builder->registryCapacity - 1;
+  uint32_t slot = state->hash & mask;
+  for (; builder->registry[slot] != EMPTY_SLOT; slot = (slot + 1) & mask) {
+    const uint32_t other = builder->registry[slot];
+    if (_equivalent(&builder->states[other], state)) {
+      // The open state is always the last child of its parent.
+      State* parent = &builder->states[builder->path[depth - 1]];
+      parent->transitions[parent->transitionCount - 1].target = other;
+      _freeState(builder, id);
+      return;
+    }
+  }
+  builder->registry[slot] = id;
+  ++builder->registeredCount;
+}
+
+/**
+ * Closes the path of the last word, from its end up to (but excluding) `depth`.
+ */
+static void _closePath(Builder* builder, size_t depth) {
+  for (size_t k = builder->wordLength; depth < k; --k) {
+    _replaceOrRegister(builder, k);
+  }
+}
+
+/**
+ * Adds a word, which must not sort before the last one.
+ *
+ * @return `false` if the word is out of order.
+ */
+static bool _addWord(Builder* builder, const uint32_t* word, size_t length) {
+  size_t prefix = 0;
+  while (prefix < length && prefix < builder->wordLength && word[prefix] == builder->word[prefix]) ++prefix;
+  if (prefix < length && prefix < builder->wordLength) {
+    if (strcmp(Alphabet_symbol(word[prefix]), Alphabet_symbol(builder->word[prefix])) < 0) return false;
+  } else if (prefix == length && length < builder->wordLength) {
+    // A proper prefix of the last word.
+    return false;
+  }
+
+  _closePath(builder, prefix);
+  builder->path = safeReserve(builder->path, &builder->pathCapacity, length + 1, sizeof(uint32_t));
+  for (size_t k = prefix; k < length; ++k) {
+    const uint32_t state = _newState(builder);
+    _addTransition(builder, builder->path[k], word[k], state);
+    builder->path[k + 1] = state;
+  }
+  builder->states[builder->path[length]].final = true;
+
+  builder->word = safeReserve(builder->word, &builder->wordCapacity, length, sizeof(uint32_t));
+  if (prefix < length) memcpy(builder->word + prefix, word + prefix, (length - prefix) * sizeof(uint32_t));
+  builder->wordLength = length;
+  return true;
+}
+
+/**
+ * Closes the last path and lays the automaton out in CSR, numbering states
+ * in breadth-first order from the initial state.
+ */
+static Automaton* _toAutomaton(Builder* builder) {
+  _closePath(builder, 0);
+  const uint32_t initial = builder->path[0];
+  _sortTransitions(&builder->states[initial]);
+
+  uint32_t* renumber = safeMalloc(builder->stateCount * sizeof(uint32_t));
+  memset(renumber, 0xFF, builder->stateCount * sizeof(uint32_t));
+  uint32_t* queue = safeMalloc(builder->liveStates * sizeof(uint32_t));
+  uint32_t tail = 0;
+  uint32_t transitionCount = 0;
+  renumber[initial] = tail;
+  queue[tail++] = initial;
+  for (uint32_t head = 0; head < tail; ++head) {
+    const State* state = &builder->states[queue[head]];
+    transitionCount += state->transitionCount;
+    for (uint32_t k = 0; k < state->transitionCount; ++k) {
+      const uint32_t target = state->transitions[k].target;
+      if (renumber[target] == EMPTY_SLOT) {
+        renumber[target] = tail;
+        queue[tail++] = target;
+      }
+    }
+  }
+
+  Automaton* automaton = Automaton_new(tail, transitionCount, 1);
+  automaton->initialStates[0] = 0;
+  automaton->deterministic = true;
+  uint32_t position = 0;
+  for (uint32_t k = 0; k < tail; ++k) {
+    const State* state = &builder->states[queue[k]];
+    automaton->offsets[k] = position;
+    if (state->final) Bitset_set(automaton->accepting, k);
+    for (uint32_t j = 0; j < state->transitionCount; ++j) {
+      automaton->symbols[position] = state->transitions[j].symbol;
+      automaton->targets[position++] = renumber[state->transitions[j].target];
+    }
+  }
+  automaton->offsets[tail] = position;
+  free(queue);
+  free(renumber);
+  return automaton;
+}
+
+static void _freeBuilder(Builder* builder) {
+  for (uint32_t k = 0; k < builder->stateCount; ++k) {
+    free(builder->states[k].transitions);
+  }
+  free(builder->states);
+  free(builder->freeStates);
+  free(builder->registry);
+  free(builder->word);
+  free(builder->path);
+}
+
+/**
+ * The word list being built, as the context of `readWordList`.
+ */
+typedef struct {
+  Builder* builder;
+  const char* path;
+  size_t wordCount;
+} Listing;
+
+static bool _addListedWord(const uint32_t* word, size_t length, size_t lineNumber, void* context) {
+  Listing* listing = context;
+  if (!_addWord(listing->builder, word, length)) {
+    logError(_logger, "The word list \"%s\" is not sorted (on line %zu).", listing->path, lineNumber);
+    return false;
+  }
+  ++listing->wordCount;
+  return true;
+}
+
+/* PUBLIC FUNCTIONS */
+
+bool readWordList(const char* path, WordListVisitorFn visitor, void* context) {
+  MappedFile* file = MappedFile_open(path, _logger);
+  if (file == NULL) return false;
+  uint32_t* word = NULL;
+  size_t wordCapacity = 0;
+  size_t lineNumber = 0;
+  bool valid = true;
+
+  const char* end = file->data + file->size;
+  for (const char* p = file->data; valid && p < end;) {
+    const char* newline = memchr(p, '\n', (size_t)(end - p));
+    const char* lineEnd = newline == NULL ? end : newline;
+    ++lineNumber;
+    size_t length = 0;
+    size_t tokens = 0;
+    bool lambda = false;
+    for (const char* q = p; valid;) {
+      while (q < lineEnd && isspace((unsigned char)*q)) ++q;
+      if (q == lineEnd) break;
+      const char* token = q;
+      while (q < lineEnd && !isspace((unsigned char)*q)) ++q;
+      const size_t tokenLength = (size_t)(q - token);
+      ++tokens;
+      if (tokenLength == 6 && memcmp(token, "lambda", 6) == 0) {
+        lambda = true;
+        continue;
+      }
+      const char* reason = invalidSymbolReason(token, tokenLength);
+      if (reason != NULL) {
+        logError(
+          _logger, "Invalid symbol \"%.*s\" in \"%s\" (on line %zu): %s.", (int)tokenLength, token, path, lineNumber,
+          reason
+        );
+        valid = false;
+        break;
+      }
+      word = safeReserve(word, &wordCapacity, length + 1, sizeof(uint32_t));
+      word[length++] = Alphabet_intern(token, tokenLength);
+    }
+    if (valid && lambda && 1 < tokens) {
+      logError(_logger, "The empty word must be alone in its line, in \"%s\" (on line %zu).", path, lineNumber);
+      valid = false;
+    }
+    if (valid && 0 < tokens) valid = visitor(word, length, lineNumber, context);
+    p = lineEnd + 1;
+  }
+  free(word);
+  MappedFile_close(file);
+  return valid;
+}
+
+Automaton* buildWordListAutomaton(const char* path) {
+  Builder builder = {0};
+  builder.path = safeReserve(NULL, &builder.pathCapacity, 1, sizeof(uint32_t));
+  builder.path[0] = _newState(&builder);
+  Listing listing = {.builder = &builder, .path = path, .wordCount = 0};
+  Automaton* automaton = NULL;
+  if (readWordList(path, _addListedWord, &listing)) {
+    automaton = _toAutomaton(&builder);
+    logDebugging(
+      _logger, "Built the minimal DFA of \"%s\": %zu words, %u states, %u transitions (peak of %u states).", path,
+      listing.wordCount, automaton->stateCount, automaton->transitionCount, builder.peakStates
+    );
+  }
+  _freeBuilder(&builder);
+  return automaton;
+}
@@ -0,0 +1,53 @@
+#ifndef WORD_LIST_AUTOMATON_HEADER
+#define WORD_LIST_AUTOMATON_HEADER
+
+#include "Automaton.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** Initialize module's internal state. */
+void initializeWordListAutomatonModule();
+
+/** Shutdown module's internal state. */
+void shutdownWordListAutomatonModule();
+
+/**
+ * Receives a word of a word list (its symbols, interned) and the line it's
+ * on.
+ *
+ * @return Whether to keep reading.
+ */
+typedef bool (*WordListVisitorFn)(const uint32_t* word, size_t length, size_t lineNumber, void* context);
+
+/**
+ * Streams the words of a word file (in the format below) to a visitor, in
+ * the order they're listed.
+ *
+ * @return Whether the whole file was read: it isn't if it can't be read or
+ *         contains an invalid symbol (after logging the reason), or if the
+ *         visitor stops.
+ */
+bool readWordList(const char* path, WordListVisitorFn visitor, void* context);
+
+/**
+ * Builds the minimal DFA of the finite language listed in a word file, as in
+ * `W = words("dict.txt")`. Each line holds one word, as a sequence of symbols
+ * separated by blanks; a line with just "lambda" is the empty word, and empty
+ * lines are ignored.
+ *
+ * The file is streamed once, and the automaton is kept minimal while it
+ * grows (Daciuk et al., "Incremental construction of minimal acyclic
+ * finite-state automata", 2000), so memory is proportional to the minimal
+ * automaton instead of to the word list. For that, words must be sorted
+ * lexicographically, comparing symbols byte by byte (e.g., with
+ * "LC_ALL=C sort" when symbols are separated by single spaces). Repeated
+ * words are allowed.
+ *
+ * @return A heap-allocated deterministic automaton, or NULL (after logging
+ *         the reason) if the file can't be read, isn't sorted or contains an
+ *         invalid symbol.
+ */
+Automaton* buildWordListAutomaton(const char* path);
+
+#endif
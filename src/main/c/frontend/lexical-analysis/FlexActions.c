@@ -5,8 +5,11 @@
 #include "../../shared/Type.h"
 #include "../syntactic-analysis/BisonParser.h"
 #include "LexicalAnalyzerContext.h"
+#include <errno.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 /* MODULE INTERNAL STATE */
 
@@ -126,6 +129,36 @@ Token SymbolLexemeAction(LexicalAnalyzerContext* lexicalAnalyzerContext) {
   return SYMBOL;
 }
 
+Token FilePathLexemeAction(LexicalAnalyzerContext* lexicalAnalyzerContext) {
+  _logLexicalAnalyzerContext(__func__, lexicalAnalyzerContext);
+  // Strips the surrounding quotes.
+  const int length = lexicalAnalyzerContext->length - 2;
+  memmove(lexicalAnalyzerContext->lexeme, lexicalAnalyzerContext->lexeme + 1, length);
+  lexicalAnalyzerContext->lexeme[length] = '\0';
+  lexicalAnalyzerContext->semanticValue->filePath.path = lexicalAnalyzerContext->lexeme;
+  lexicalAnalyzerContext->semanticValue->filePath.length = length;
+  free(lexicalAnalyzerContext);
+  return FILE_PATH;
+}
+
+Token ExponentLexemeAction(LexicalAnalyzerContext* lexicalAnalyzerContext) {
+  _logLexicalAnalyzerContext(__func__, lexicalAnalyzerContext);
+  // Skips the caret (`strtoull` skips the spaces after it).
+  errno = 0;
+  const unsigned long long exponent = strtoull(lexicalAnalyzerContext->lexeme + 1, NULL, 10);
+  if (errno == ERANGE || UINT_MAX < exponent) {
+    logError(
+      _logger, "The exponent \"%s\" at line %d is too large.", lexicalAnalyzerContext->lexeme,
+      lexicalAnalyzerContext->line
+    );
+    destroyLexicalAnalyzerContext(lexicalAnalyzerContext);
+    return UNKNOWN;
+  }
+  lexicalAnalyzerContext->semanticValue->exponent = (unsigned int)exponent;
+  destroyLexicalAnalyzerContext(lexicalAnalyzerContext);
+  return POWER;
+}
+
 Token UnknownLexemeAction(LexicalAnalyzerContext* lexicalAnalyzerContext) {
   _logLexicalAnalyzerContext(__func__, lexicalAnalyzerContext);
   destroyLexicalAnalyzerContext(lexicalAnalyzerContext);
@@ -30,6 +30,8 @@ void EndLanguageDefinitionLexemeAction(LexicalAnalyzerContext* lexicalAnalyzerCo
 Token TokenLexemeAction(LexicalAnalyzerContext* lexicalAnalyzerContext, Token token);
 Token IdLexemeAction(LexicalAnalyzerContext* lexicalAnalyzerContext);
 Token SymbolLexemeAction(LexicalAnalyzerContext* lexicalAnalyzerContext);
+Token FilePathLexemeAction(LexicalAnalyzerContext* lexicalAnalyzerContext);
+Token ExponentLexemeAction(LexicalAnalyzerContext* lexicalAnalyzerContext);
 
 Token UnknownLexemeAction(LexicalAnalyzerContext* lexicalAnalyzerContext);
 
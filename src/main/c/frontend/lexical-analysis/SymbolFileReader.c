@@ -0,0 +1,299 @@
+#include "SymbolFileReader.h"
+#include "../../shared/Environment.h"
+#include "../../shared/Logger.h"
+#include "../../shared/MappedFile.h"
+#include "../../shared/Set.h"
+#include "../../shared/SetElement.h"
+#include "../../shared/hashUtils.h"
+#include "../../shared/utils.h"
+#include "../syntactic-analysis/ASTUtils.h"
+#include "../syntactic-analysis/AbstractSyntaxTree.h"
+#include <ctype.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* MODULE INTERNAL STATE */
+
+// Files are split in chunks of at least this size, so small files are read by a single thread.
+#define MINIMUM_CHUNK_SIZE (1 << 20)
+#define MAXIMUM_WORKER_THREADS 64
+
+static Logger* _logger = NULL;
+static size_t _workerThreads = 1;
+
+void initializeSymbolFileReaderModule() {
+  _logger = createLogger("SymbolFileReader");
+  long long threads = getIntegerOrDefault("WORKER_THREADS", 0);
+  if (threads <= 0) threads = sysconf(_SC_NPROCESSORS_ONLN);
+  if (threads < 1) threads = 1;
+  _workerThreads = threads < MAXIMUM_WORKER_THREADS ? (size_t)threads : MAXIMUM_WORKER_THREADS;
+}
+
+void shutdownSymbolFileReaderModule() {
+  if (_logger != NULL) {
+    destroyLogger(_logger);
+  }
+}
+
+/**
+ * A symbol inside the mapped file.
+ */
+typedef struct {
+  const char* start;
+  uint32_t length;
+  uint32_t hash;
+} Line;
+
+/**
+ * Open-addressing set of lines. It's sized up front for the maximum number of
+ * lines it can receive, so it never rehashes. Slots hold 1-based indexes into
+ * `lines`, 0 being an empty slot.
+ */
+typedef struct {
+  Line* lines;
+  size_t count;
+  uint32_t* slots;
+  size_t mask;
+} LineSet;
+
+/**
+ * The part of the file processed by a single worker. Chunks always start
+ * right after a newline, so line numbers can be recovered by adding up the
+ * newlines of the previous chunks.
+ */
+typedef struct {
+  const char* begin;
+  const char* end;
+  size_t newlineCount;
+  LineSet lines;
+  // The first invalid symbol found, if any.
+  size_t invalidLine;
+  const char* invalidStart;
+  size_t invalidLength;
+  const char* invalidReason;
+} Chunk;
+
+/* PRIVATE FUNCTIONS */
+
+static void _LineSet_init(LineSet* set, size_t maximumCount) {
+  size_t capacity = 16;
+  while (capacity < 2 * maximumCount) capacity <<= 1;
+  set->lines = safeMalloc((maximumCount == 0 ? 1 : maximumCount) * sizeof(Line));
+  set->count = 0;
+  set->slots = safeCalloc(capacity, sizeof(uint32_t));
+  set->mask = capacity - 1;
+}
+
+static void _LineSet_add(LineSet* set, Line line) {
+  for (size_t k = line.hash & set->mask;; k = (k + 1) & set->mask) {
+    const uint32_t slot = set->slots[k];
+    if (slot == 0) {
+      set->lines[set->count++] = line;
+      set->slots[k] = (uint32_t)set->count;
+      return;
+    }
+    const Line* other = &set->lines[slot - 1];
+    if (other->hash == line.hash && other->length == line.length && memcmp(other->start, line.start, line.length) == 0) {
+      return;
+    }
+  }
+}
+
+static void _LineSet_free(LineSet* set) {
+  free(set->lines);
+  free(set->slots);
+}
+
+static size_t _countNewlines(const char* begin, const char* end) {
+  size_t count = 0;
+  for (const char* p = begin; p < end && (p = memchr(p, '\n', (size_t)(end - p))) != NULL; ++p) {
+    ++count;
+  }
+  return count;
+}
+
+/**
+ * Tokenizes and deduplicates a chunk. Runs on a worker thread, so it must not
+ * log nor touch any shared state.
+ */
+static void* _readChunk(void* argument) {
+  Chunk* chunk = argument;
+  chunk->newlineCount = _countNewlines(chunk->begin, chunk->end);
+  _LineSet_init(&chunk->lines, chunk->newlineCount + 1);
+
+  size_t lineNumber = 0;
+  for (const char* p = chunk->begin; p < chunk->end;) {
+    const char* newline = memchr(p, '\n', (size_t)(chunk->end - p));
+    const char* lineEnd = newline == NULL ? chunk->end : newline;
+    ++lineNumber;
+    while (p < lineEnd && isspace((unsigned char)*p)) ++p;
+    const char* q = lineEnd;
+    while (p < q && isspace((unsigned char)q[-1])) --q;
+    if (p < q) {
+      const size_t length = (size_t)(q - p);
+      const char* reason = invalidSymbolReason(p, length);
+      if (reason != NULL) {
+        chunk->invalidLine = lineNumber;
+        chunk->invalidStart = p;
+        chunk->invalidLength = length;
+        chunk->invalidReason = reason;
+        return NULL;
+      }
+      const Line line = {.start = p, .length = (uint32_t)length, .hash = murmurHash3(1, p, length)};
+      _LineSet_add(&chunk->lines, line);
+    }
+    p = lineEnd + 1;
+  }
+  return NULL;
+}
+
+/**
+ * Splits the file in (roughly) equally sized chunks, cutting them right after
+ * a newline.
+ */
+static size_t _splitInChunks(const char* data, size_t size, Chunk* chunks, size_t chunkCount) {
+  const char* begin = data;
+  const char* end = data + size;
+  size_t count = 0;
+  for (size_t k = 0; k < chunkCount && begin < end; ++k) {
+    const char* cut = k + 1 == chunkCount ? end : data + size / chunkCount * (k + 1);
+    if (cut < begin) cut = begin;
+    if (cut < end) {
+      const char* newline = memchr(cut, '\n', (size_t)(end - cut));
+      cut = newline == NULL ? end : newline + 1;
+    }
+    chunks[count++] = (Chunk){.begin = begin, .end = cut};
+    begin = cut;
+  }
+  return count;
+}
+
+static void _readChunks(Chunk* chunks, size_t chunkCount) {
+  pthread_t* threads = safeMalloc(chunkCount * sizeof(pthread_t));
+  bool* started = safeCalloc(chunkCount, sizeof(bool));
+  for (size_t k = 1; k < chunkCount; ++k) {
+    started[k] = pthread_create(&threads[k], NULL, _readChunk, &chunks[k]) == 0;
+  }
+  _readChunk(&chunks[0]);
+  for (size_t k = 1; k < chunkCount; ++k) {
+    if (started[k]) {
+      pthread_join(threads[k], NULL);
+    } else {
+      // Couldn't spawn a thread (e.g., resource limits), so the chunk is read here.
+      _readChunk(&chunks[k]);
+    }
+  }
+  free(started);
+  free(threads);
+}
+
+/**
+ * Logs the first invalid symbol of the file, if any.
+ *
+ * @return `true` if every chunk is valid.
+ */
+static bool _validateChunks(const char* path, Chunk* chunks, size_t chunkCount) {
+  size_t previousLines = 0;
+  for (size_t k = 0; k < chunkCount; ++k) {
+    if (chunks[k].invalidReason != NULL) {
+      logError(
+        _logger, "Invalid symbol \"%.*s\" in \"%s\" (on line %zu): %s.", (int)chunks[k].invalidLength,
+        chunks[k].invalidStart, path, previousLines + chunks[k].invalidLine, chunks[k].invalidReason
+      );
+      return false;
+    }
+    previousLines += chunks[k].newlineCount;
+  }
+  return true;
+}
+
+/**
+ * Merges the deduplicated chunks into a symbol set.
+ */
+static SymbolSet _mergeChunks(Chunk* chunks, size_t chunkCount, size_t* symbolCount) {
+  size_t count = 0;
+  for (size_t k = 0; k < chunkCount; ++k) {
+    count += chunks[k].lines.count;
+  }
+  LineSet symbols;
+  _LineSet_init(&symbols, count);
+  for (size_t k = 0; k < chunkCount; ++k) {
+    for (size_t j = 0; j < chunks[k].lines.count; ++j) {
+      _LineSet_add(&symbols, chunks[k].lines.lines[j]);
+    }
+  }
+
+  SymbolSet set = Set_new(Symbol_hashEle, Symbol_equalsEle, Symbol_freeEle, Symbol_toStringEle);
+  Set_reserve(set, symbols.count);
+  for (size_t k = 0; k < symbols.count; ++k) {
+    const Line* line = &symbols.lines[k];
+    char* symbol = safeMalloc(line->length + 1);
+    memcpy(symbol, line->start, line->length);
+    symbol[line->length] = '\0';
+    SetElement element = {.symbol = {.symbol = symbol, .length = (int)line->length}};
+    Set_add(set, element);
+  }
+  *symbolCount = symbols.count;
+  _LineSet_free(&symbols);
+  return set;
+}
+
+/* PUBLIC FUNCTIONS */
+
+SymbolSet readSymbolFile(const char* path) {
+  MappedFile* file = MappedFile_open(path, _logger);
+  if (file == NULL) return NULL;
+  if (UINT32_MAX <= file->size) {
+    logError(_logger, "The symbol file \"%s\" is too large (%zu bytes).", path, file->size);
+    MappedFile_close(file);
+    return NULL;
+  }
+  const char* data = file->data;
+  const size_t size = file->size;
+
+  size_t chunkCount = 1 + size / MINIMUM_CHUNK_SIZE;
+  if (_workerThreads < chunkCount) chunkCount = _workerThreads;
+  Chunk* chunks = safeCalloc(chunkCount, sizeof(Chunk));
+  chunkCount = _splitInChunks(data, size, chunks, chunkCount);
+
+  SymbolSet set = NULL;
+  if (chunkCount == 0) {
+    set = Set_new(Symbol_hashEle, Symbol_equalsEle, Symbol_freeEle, Symbol_toStringEle);
+    logDebugging(_logger, "The symbol file \"%s\" is empty.", path);
+  } else {
+    _readChunks(chunks, chunkCount);
+    if (_validateChunks(path, chunks, chunkCount)) {
+      size_t symbolCount = 0;
+      set = _mergeChunks(chunks, chunkCount, &symbolCount);
+      logDebugging(
+        _logger, "Loaded %zu symbols from \"%s\" (%zu bytes, %zu thread(s)).", symbolCount, path, size, chunkCount
+      );
+    }
+    for (size_t k = 0; k < chunkCount; ++k) {
+      _LineSet_free(&chunks[k].lines);
+    }
+  }
+
+  free(chunks);
+  MappedFile_close(file);
+  return set;
+}
+
+const char* invalidSymbolReason(const char* start, size_t length) {
+  for (size_t k = 0; k < length; ++k) {
+    const char c = start[k];
+    if (isspace((unsigned char)c) || c == ',' || c == '{' || c == '}') {
+      return "symbols can't contain blanks, commas or braces";
+    }
+  }
+  if ((length == 6 && memcmp(start, "lambda", 6) == 0) || (length == 1 && *start == '|') ||
+      (length == 2 && memcmp(start, "->", 2) == 0)) {
+    return "reserved word";
+  }
+  return NULL;
+}
@@ -0,0 +1,36 @@
+#ifndef SYMBOL_FILE_READER_HEADER
+#define SYMBOL_FILE_READER_HEADER
+
+#include "../syntactic-analysis/AbstractSyntaxTree.h"
+#include <stddef.h>
+
+/** Initialize module's internal state. */
+void initializeSymbolFileReaderModule();
+
+/** Shutdown module's internal state. */
+void shutdownSymbolFileReaderModule();
+
+/**
+ * Loads a symbol set from a newline-separated file, as in `sigma =
+ * file("alphabet.txt")`. Each line holds one symbol; surrounding blanks and
+ * empty lines are ignored, and repeated symbols are only added once.
+ *
+ * The file is memory-mapped and, if it's large enough, split among
+ * "WORKER_THREADS" threads that tokenize and deduplicate their chunks in
+ * parallel.
+ *
+ * @return A heap-allocated `SymbolSet`, or NULL (after logging the reason) if
+ *         the file can't be read or contains an invalid symbol.
+ */
+SymbolSet readSymbolFile(const char* path);
+
+/**
+ * Symbols read from files must be lexable as symbols inside braces too, so
+ * they can't contain blanks, commas nor braces, and can't be a reserved word
+ * ("lambda", "|" or "->").
+ *
+ * @return Why the symbol is invalid, or NULL if it's valid.
+ */
+const char* invalidSymbolReason(const char* start, size_t length);
+
+#endif
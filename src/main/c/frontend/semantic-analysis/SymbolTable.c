@@ -0,0 +1,375 @@
+#include "SymbolTable.h"
+#include "../../shared/Array.h"
+#include "../../shared/Logger.h"
+#include "../../shared/hashUtils.h"
+#include "../../shared/utils.h"
+#include "../syntactic-analysis/ASTUtils.h"
+#include "../syntactic-analysis/AbstractSyntaxTree.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* MODULE INTERNAL STATE */
+
+static Logger* _logger = NULL;
+
+void initializeSymbolTableModule() {
+  _logger = createLogger("SymbolTable");
+}
+
+void shutdownSymbolTableModule() {
+  if (_logger != NULL) {
+    destroyLogger(_logger);
+  }
+}
+
+#define EMPTY_SLOT UINT32_MAX
+
+typedef struct {
+  const char* id;
+  uint32_t hash;
+  uint32_t sentenceIndex;
+} Slot;
+
+/**
+ * Open-addressing table from identifiers to sentence indexes, plus the
+ * dependency graph of the program in CSR layout: the sentences that sentence
+ * `k` depends on are `dependencies[dependencyOffsets[k]..dependencyOffsets[k + 1]]`.
+ */
+typedef struct SymbolTableCDT {
+  Program* program;
+  uint32_t sentenceCount;
+  uint32_t capacity;
+  Slot* slots;
+  uint32_t* dependencyOffsets;
+  uint32_t* dependencies;
+  uint32_t dependencyCount;
+  uint32_t dependencyCapacity;
+  bool* requested;
+  bool* required;
+  // Every sentence, placed after the sentences it depends on.
+  uint32_t* order;
+} SymbolTableCDT;
+
+/* PRIVATE FUNCTIONS */
+
+static Id _sentenceId(Sentence* sentence);
+static const char* _sentenceTypeName(SentenceType type);
+static Slot* _findSlot(SymbolTable table, const char* id, uint32_t hash);
+static bool _bind(SymbolTable table, uint32_t sentenceIndex);
+static bool _addDependency(SymbolTable table, Sentence* referrer, Id id, SentenceType expectedType);
+static bool _addLanguageDependencies(SymbolTable table, Sentence* referrer, LanguageExpression* expression);
+static bool _hasCycles(SymbolTable table);
+static bool _isRequestable(SentenceType type);
+
+/**
+ * The identifier bound by a sentence.
+ */
+static Id _sentenceId(Sentence* sentence) {
+  switch (sentence->type) {
+  case GRAMMAR_DEFINITION:
+    return sentence->grammarDefinition->id;
+  case SYMBOL_SET:
+    return sentence->symbolSetBinding->id;
+  case PRODUCTION_SET:
+    return sentence->productionSetBinding->id;
+  case QUERY_SENTENCE:
+    return sentence->queryBinding->id;
+  case LANGUAGE_SENTENCE:
+  default:
+    return sentence->languageBinding->id;
+  }
+}
+
+static const char* _sentenceTypeName(SentenceType type) {
+  switch (type) {
+  case GRAMMAR_DEFINITION:
+    return "a grammar";
+  case SYMBOL_SET:
+    return "a symbol set";
+  case PRODUCTION_SET:
+    return "a production set";
+  case QUERY_SENTENCE:
+    return "a query";
+  case LANGUAGE_SENTENCE:
+  default:
+    return "a language";
+  }
+}
+
+/**
+ * Only languages and queries produce something, so they're the only sentences that can be requested.
+ */
+static bool _isRequestable(SentenceType type) {
+  return type == LANGUAGE_SENTENCE || type == QUERY_SENTENCE;
+}
+
+/**
+ * Linear probing. Returns the slot holding `id`, or the empty slot where it
+ * should be inserted.
+ */
+static Slot* _findSlot(SymbolTable table, const char* id, uint32_t hash) {
+  const uint32_t mask = table->capacity - 1;
+  for (uint32_t k = hash & mask;; k = (k + 1) & mask) {
+    Slot* slot = &table->slots[k];
+    if (slot->sentenceIndex == EMPTY_SLOT) return slot;
+    if (slot->hash == hash && strcmp(slot->id, id) == 0) return slot;
+  }
+}
+
+static bool _bind(SymbolTable table, uint32_t sentenceIndex) {
+  Sentence* sentence = Array_get(table->program->sentences, sentenceIndex).sentence;
+  Id id = _sentenceId(sentence);
+  uint32_t hash = murmurHash3(1, id.id, (size_t)id.length);
+  Slot* slot = _findSlot(table, id.id, hash);
+  if (slot->sentenceIndex != EMPTY_SLOT) {
+    logError(
+      _logger, "Identifier \"%s\" (sentence %u) is already bound to %s (sentence %u).", id.id, sentenceIndex,
+      _sentenceTypeName(Array_get(table->program->sentences, slot->sentenceIndex).sentence->type), slot->sentenceIndex
+    );
+    return false;
+  }
+  slot->id = id.id;
+  slot->hash = hash;
+  slot->sentenceIndex = sentenceIndex;
+  return true;
+}
+
+/**
+ * Records that `referrer` depends on `id`, which must be bound to a sentence of `expectedType`.
+ */
+static bool _addDependency(SymbolTable table, Sentence* referrer, Id id, SentenceType expectedType) {
+  const char* referrerId = _sentenceId(referrer).id;
+  int64_t index = SymbolTable_indexOf(table, id.id);
+  if (index < 0) {
+    logError(_logger, "Undeclared identifier \"%s\" referenced by \"%s\".", id.id, referrerId);
+    return false;
+  }
+  SentenceType type = Array_get(table->program->sentences, index).sentence->type;
+  if (type != expectedType) {
+    logError(
+      _logger, "\"%s\" references \"%s\" as %s, but it is bound to %s.", referrerId, id.id,
+      _sentenceTypeName(expectedType), _sentenceTypeName(type)
+    );
+    return false;
+  }
+  if (table->dependencyCount == table->dependencyCapacity) {
+    table->dependencyCapacity *= 2;
+    table->dependencies = realloc(table->dependencies, table->dependencyCapacity * sizeof(uint32_t));
+    if (table->dependencies == NULL) exitWithPerror(__func__, "realloc error");
+  }
+  table->dependencies[table->dependencyCount++] = (uint32_t)index;
+  return true;
+}
+
+typedef struct {
+  SymbolTable table;
+  Sentence* referrer;
+  bool valid;
+} DependencyCollector;
+
+static void _collectDependency(LanguageExpression* expression, void* context) {
+  if (expression->type != LANGUAGE || expression->language->type == WORDS_FILE) return;
+  DependencyCollector* collector = context;
+  const SentenceType type = expression->language->type == GRAMMAR_ID ? GRAMMAR_DEFINITION : LANGUAGE_SENTENCE;
+  collector->valid = _addDependency(collector->table, collector->referrer, expression->language->id, type) &&
+                     collector->valid;
+}
+
+static bool _addLanguageDependencies(SymbolTable table, Sentence* referrer, LanguageExpression* expression) {
+  DependencyCollector collector = {.table = table, .referrer = referrer, .valid = true};
+  LanguageExpression_walk(expression, _collectDependency, &collector);
+  return collector.valid;
+}
+
+/**
+ * Iterative depth-first search over the dependency graph. Only language
+ * bindings can reference each other, so that's the only way to close a cycle.
+ * Sentences are appended to the evaluation order as they are finished
+ * (post-order), so dependencies always come first.
+ */
+static bool _hasCycles(SymbolTable table) {
+  enum { UNVISITED = 0, IN_PROGRESS, DONE };
+  uint8_t* state = safeCalloc(table->sentenceCount, sizeof(uint8_t));
+  uint32_t* stack = safeMalloc(table->sentenceCount * sizeof(uint32_t));
+  uint32_t* nextEdge = safeMalloc(table->sentenceCount * sizeof(uint32_t));
+  bool cycle = false;
+  uint32_t finished = 0;
+  for (uint32_t root = 0; !cycle && root < table->sentenceCount; ++root) {
+    if (state[root] != UNVISITED) continue;
+    uint32_t depth = 0;
+    stack[depth++] = root;
+    state[root] = IN_PROGRESS;
+    nextEdge[root] = table->dependencyOffsets[root];
+    while (!cycle && 0 < depth) {
+      uint32_t node = stack[depth - 1];
+      if (nextEdge[node] == table->dependencyOffsets[node + 1]) {
+        state[node] = DONE;
+        table->order[finished++] = node;
+        --depth;
+        continue;
+      }
+      uint32_t next = table->dependencies[nextEdge[node]++];
+      if (state[next] == IN_PROGRESS) {
+        Sentence* sentence = Array_get(table->program->sentences, next).sentence;
+        logError(_logger, "The language \"%s\" depends on itself.", _sentenceId(sentence).id);
+        cycle = true;
+      } else if (state[next] == UNVISITED) {
+        state[next] = IN_PROGRESS;
+        nextEdge[next] = table->dependencyOffsets[next];
+        stack[depth++] = next;
+      }
+    }
+  }
+  free(nextEdge);
+  free(stack);
+  free(state);
+  return cycle;
+}
+
+/* PUBLIC FUNCTIONS */
+
+SymbolTable SymbolTable_new(Program* program) {
+  SymbolTableCDT* table = safeMalloc(sizeof(SymbolTableCDT));
+  table->program = program;
+  table->sentenceCount = (uint32_t)Array_getLen(program->sentences);
+  table->capacity = 1;
+  while (table->capacity < 2 * table->sentenceCount) table->capacity <<= 1;
+  table->slots = safeMalloc(table->capacity * sizeof(Slot));
+  for (uint32_t k = 0; k < table->capacity; ++k) table->slots[k].sentenceIndex = EMPTY_SLOT;
+  table->dependencyOffsets = safeMalloc((1 + table->sentenceCount) * sizeof(uint32_t));
+  table->dependencyCapacity = 3 * table->sentenceCount + 1;
+  table->dependencies = safeMalloc(table->dependencyCapacity * sizeof(uint32_t));
+  table->dependencyCount = 0;
+  table->requested = safeCalloc(table->sentenceCount, sizeof(bool));
+  table->required = safeCalloc(table->sentenceCount, sizeof(bool));
+  table->order = safeMalloc((table->sentenceCount == 0 ? 1 : table->sentenceCount) * sizeof(uint32_t));
+
+  // Bindings may be referenced before they are defined, so every identifier is bound first.
+  bool valid = true;
+  for (uint32_t k = 0; k < table->sentenceCount; ++k) {
+    valid = _bind(table, k) && valid;
+  }
+  for (uint32_t k = 0; k < table->sentenceCount; ++k) {
+    table->dependencyOffsets[k] = table->dependencyCount;
+    Sentence* sentence = Array_get(program->sentences, k).sentence;
+    switch (sentence->type) {
+    case GRAMMAR_DEFINITION: {
+      GrammarDefinition* grammar = sentence->grammarDefinition;
+      bool terminals = _addDependency(table, sentence, grammar->terminalSetId, SYMBOL_SET);
+      bool nonTerminals = _addDependency(table, sentence, grammar->nonTerminalSetId, SYMBOL_SET);
+      bool productions = _addDependency(table, sentence, grammar->productionSetId, PRODUCTION_SET);
+      valid = terminals && nonTerminals && productions && valid;
+      break;
+    }
+    case LANGUAGE_SENTENCE:
+      valid = _addLanguageDependencies(table, sentence, sentence->languageBinding->LanguageExpression) && valid;
+      break;
+    case QUERY_SENTENCE: {
+      QueryBinding* query = sentence->queryBinding;
+      valid = _addLanguageDependencies(table, sentence, query->leftLanguageExpression) && valid;
+      if (query->rightLanguageExpression != NULL) {
+        valid = _addLanguageDependencies(table, sentence, query->rightLanguageExpression) && valid;
+      }
+      break;
+    }
+    default:
+      break;
+    }
+  }
+  table->dependencyOffsets[table->sentenceCount] = table->dependencyCount;
+
+  if (!valid || _hasCycles(table)) {
+    SymbolTable_free(table);
+    return NULL;
+  }
+  return table;
+}
+
+void SymbolTable_free(SymbolTable table) {
+  if (table == NULL) exitInvalidArgument(__func__, "SymbolTable instance can't be NULL");
+  free(table->order);
+  free(table->required);
+  free(table->requested);
+  free(table->dependencies);
+  free(table->dependencyOffsets);
+  free(table->slots);
+  free(table);
+}
+
+Sentence* SymbolTable_find(SymbolTable table, const char* id) {
+  int64_t index = SymbolTable_indexOf(table, id);
+  return index < 0 ? NULL : Array_get(table->program->sentences, index).sentence;
+}
+
+int64_t SymbolTable_indexOf(SymbolTable table, const char* id) {
+  if (table == NULL) exitInvalidArgument(__func__, "SymbolTable instance can't be NULL");
+  Slot* slot = _findSlot(table, id, murmurHash3(1, id, strlen(id)));
+  return slot->sentenceIndex == EMPTY_SLOT ? -1 : (int64_t)slot->sentenceIndex;
+}
+
+bool SymbolTable_request(SymbolTable table, char** ids, size_t count) {
+  if (table == NULL) exitInvalidArgument(__func__, "SymbolTable instance can't be NULL");
+  if (count == 0) {
+    for (uint32_t k = 0; k < table->sentenceCount; ++k) {
+      table->requested[k] = true;
+      table->required[k] = true;
+    }
+    return true;
+  }
+
+  // Breadth-first search from the requested bindings; the queue holds each sentence at most once.
+  uint32_t* queue = safeMalloc((table->sentenceCount + count) * sizeof(uint32_t));
+  uint32_t tail = 0;
+  bool valid = true;
+  for (size_t k = 0; k < count; ++k) {
+    int64_t index = SymbolTable_indexOf(table, ids[k]);
+    if (index < 0) {
+      logError(_logger, "The requested language \"%s\" is not defined.", ids[k]);
+      valid = false;
+    } else if (!_isRequestable(Array_get(table->program->sentences, index).sentence->type)) {
+      logError(_logger, "The requested identifier \"%s\" is not bound to a language or a query.", ids[k]);
+      valid = false;
+    } else if (!table->requested[index]) {
+      table->requested[index] = true;
+      if (!table->required[index]) {
+        table->required[index] = true;
+        queue[tail++] = (uint32_t)index;
+      }
+    }
+  }
+  for (uint32_t head = 0; head < tail; ++head) {
+    uint32_t node = queue[head];
+    for (uint32_t e = table->dependencyOffsets[node]; e < table->dependencyOffsets[node + 1]; ++e) {
+      uint32_t next = table->dependencies[e];
+      if (!table->required[next]) {
+        table->required[next] = true;
+        queue[tail++] = next;
+      }
+    }
+  }
+  free(queue);
+  return valid;
+}
+
+bool SymbolTable_isRequested(SymbolTable table, size_t sentenceIndex) {
+  if (table == NULL) exitInvalidArgument(__func__, "SymbolTable instance can't be NULL");
+  return sentenceIndex < table->sentenceCount && table->requested[sentenceIndex];
+}
+
+bool SymbolTable_isRequired(SymbolTable table, size_t sentenceIndex) {
+  if (table == NULL) exitInvalidArgument(__func__, "SymbolTable instance can't be NULL");
+  return sentenceIndex < table->sentenceCount && table->required[sentenceIndex];
+}
+
+const uint32_t* SymbolTable_evaluationOrder(SymbolTable table) {
+  if (table == NULL) exitInvalidArgument(__func__, "SymbolTable instance can't be NULL");
+  return table->order;
+}
+
+size_t SymbolTable_sentenceCount(SymbolTable table) {
+  if (table == NULL) exitInvalidArgument(__func__, "SymbolTable instance can't be NULL");
+  return table->sentenceCount;
+}
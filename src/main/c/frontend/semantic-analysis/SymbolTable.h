@@ -0,0 +1,70 @@
+#ifndef SYMBOL_TABLE_HEADER
+#define SYMBOL_TABLE_HEADER
+
+#include "../syntactic-analysis/AbstractSyntaxTree.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** Initialize module's internal state. */
+void initializeSymbolTableModule();
+
+/** Shutdown module's internal state. */
+void shutdownSymbolTableModule();
+
+typedef struct SymbolTableCDT* SymbolTable;
+
+/**
+ * Builds the symbol table of `program`, validating every sentence: each
+ * identifier must be bound once, every reference must point to a binding of
+ * the right kind, and language bindings can't depend on themselves.
+ *
+ * @return A heap-allocated `SymbolTable`, or NULL (after logging every error
+ *         found) if the program is invalid. The table borrows the identifiers
+ *         of the AST, so it must be freed before the program.
+ */
+SymbolTable SymbolTable_new(Program* program);
+void SymbolTable_free(SymbolTable table);
+
+/**
+ * @return The sentence bound to `id`, or NULL if there is none.
+ */
+Sentence* SymbolTable_find(SymbolTable table, const char* id);
+
+/**
+ * @return The index of the sentence bound to `id` inside the program, or -1 if there is none.
+ */
+int64_t SymbolTable_indexOf(SymbolTable table, const char* id);
+
+/**
+ * Requests the language and query bindings named in `ids`, and marks as
+ * required every sentence they transitively depend on. With no ids, every
+ * sentence is both requested and required.
+ *
+ * @return `false` if some id is not bound to a language or a query.
+ */
+bool SymbolTable_request(SymbolTable table, char** ids, size_t count);
+
+/**
+ * @return `true` if the sentence at `sentenceIndex` was explicitly requested.
+ */
+bool SymbolTable_isRequested(SymbolTable table, size_t sentenceIndex);
+
+/**
+ * @return `true` if the sentence at `sentenceIndex` is needed to evaluate the requested bindings.
+ */
+bool SymbolTable_isRequired(SymbolTable table, size_t sentenceIndex);
+
+/**
+ * @return The indexes of every sentence of the program, ordered so that each
+ *         one comes after all the sentences it depends on. The array belongs
+ *         to the table.
+ */
+const uint32_t* SymbolTable_evaluationOrder(SymbolTable table);
+
+/**
+ * @return The number of sentences in the program.
+ */
+size_t SymbolTable_sentenceCount(SymbolTable table);
+
+#endif
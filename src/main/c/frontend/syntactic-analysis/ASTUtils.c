@@ -6,10 +6,12 @@
 #include "../../shared/SetElement.h"
 #include "../../shared/String.h"
 #include "../../shared/hashUtils.h"
+#include "../../shared/utils.h"
 #include "AbstractSyntaxTree.h"
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -22,6 +24,8 @@ static Logger* _logger = NULL;
 #define COLORIZE_SYMBOL(str) GREEN_COLOR str RESET_COLOR
 #define COLORIZE_ID(str) BLUE_COLOR str RESET_COLOR
 
+enum { INITIAL_WALK_CAPACITY = 64 };
+
 void initializeASTUtilsModule() {
   _logger = createLogger("ASTUtils");
 }
@@ -56,6 +60,9 @@ void SentenceArray_freeEle(ArrayElement ele) {
     break;
   case LANGUAGE_SENTENCE:
     LanguageBinding_free(ele.sentence->languageBinding);
+    break;
+  case QUERY_SENTENCE:
+    QueryBinding_free(ele.sentence->queryBinding);
   }
   free(ele.sentence);
 }
@@ -75,6 +82,9 @@ char* Sentence_toString(Sentence* sentence) {
   case LANGUAGE_SENTENCE:
     str = LanguageBinding_toString(sentence->languageBinding);
     break;
+  case QUERY_SENTENCE:
+    str = QueryBinding_toString(sentence->queryBinding);
+    break;
   }
 
   return str;
@@ -301,6 +311,57 @@ char* ProductionSetBinding_toString(ProductionSetBinding* productionSetBinding)
 }
 
 //////////// LANGUAGES ////////////
+
+typedef struct {
+  LanguageExpression* expression;
+  bool expanded;
+} WalkFrame;
+
+size_t LanguageExpression_walk(
+  LanguageExpression* languageExpression, LanguageExpressionVisitorFn visitor, void* context
+) {
+  size_t capacity = INITIAL_WALK_CAPACITY;
+  size_t length = 0;
+  size_t visited = 0;
+  WalkFrame* stack = safeMalloc(capacity * sizeof(WalkFrame));
+  stack[length++] = (WalkFrame){.expression = languageExpression, .expanded = false};
+
+  while (0 < length) {
+    WalkFrame* frame = &stack[length - 1];
+    LanguageExpression* expression = frame->expression;
+    if (frame->expanded || expression->type == LANGUAGE) {
+      // Children were already visited (or there are none), so it's the parent's turn.
+      --length;
+      ++visited;
+      if (visitor != NULL) visitor(expression, context);
+      continue;
+    }
+    frame->expanded = true;
+    if (capacity < length + 2) {
+      capacity *= 2;
+      stack = realloc(stack, capacity * sizeof(WalkFrame));
+      if (stack == NULL) exitWithPerror(__func__, "realloc error");
+    }
+    switch (expression->type) {
+    case LANG_REVERSE:
+    case LANG_COMPLEMENT:
+    case LANG_STAR:
+    case LANG_PLUS:
+    case LANG_POWER:
+    case LANG_EMPTY:
+      stack[length++] = (WalkFrame){.expression = expression->unaryLanguageExpression, .expanded = false};
+      break;
+    default:
+      // The left operand goes on top so it's visited first.
+      stack[length++] = (WalkFrame){.expression = expression->rightLanguageExpression, .expanded = false};
+      stack[length++] = (WalkFrame){.expression = expression->leftLanguageExpression, .expanded = false};
+      break;
+    }
+  }
+  free(stack);
+  return visited;
+}
+
 void LanguageBinding_free(LanguageBinding* languageBinding) {
   logDebugging(_logger, "Executing destructor: %s", __func__);
   LanguageExpression_free(languageBinding->LanguageExpression);
@@ -308,35 +369,31 @@ void LanguageBinding_free(LanguageBinding* languageBinding) {
   free(languageBinding);
 }
 
-void LanguageExpression_free(LanguageExpression* languageExpression) {
-  logDebugging(_logger, "Executing destructor: %s", __func__);
-  switch (languageExpression->type) {
-  case LANGUAGE:
+static void _LanguageExpression_freeVisitor(LanguageExpression* languageExpression, void* context) {
+  if (languageExpression->type == LANGUAGE) {
     Language_free(languageExpression->language);
-    break;
-  case LANG_UNION:
-  case LANG_INTERSEC:
-  case LANG_MINUS:
-  case LANG_CONCAT:
-    LanguageExpression_free(languageExpression->leftLanguageExpression);
-    LanguageExpression_free(languageExpression->rightLanguageExpression);
-    break;
-  case LANG_REVERSE:
-  case LANG_COMPLEMENT:
-    LanguageExpression_free(languageExpression->unaryLanguageExpression);
-    break;
-  default:
-    break;
+    ++*(size_t*)context;
   }
   free(languageExpression);
 }
 
+void LanguageExpression_free(LanguageExpression* languageExpression) {
+  size_t languages = 0;
+  const size_t nodes = LanguageExpression_walk(languageExpression, _LanguageExpression_freeVisitor, &languages);
+  logDebugging(_logger, "Executing destructor: %s (%zu nodes, %zu languages)", __func__, nodes, languages);
+}
+
 void Language_free(Language* language) {
-  free(language->id.id);
+  if (language->type == WORDS_FILE) {
+    free(language->path.path);
+  } else {
+    free(language->id.id);
+  }
   free(language);
 }
 
-// LANG_UNION, LANG_INTERSEC, LANG_MINUS, LANG_CONCAT, LANG_REVERSE
+// LANG_UNION, LANG_INTERSEC, LANG_MINUS, LANG_CONCAT, LANG_REVERSE, LANG_COMPLEMENT, LANG_STAR, LANG_PLUS, LANG_POWER,
+// LANG_EMPTY
 char LanguageExpressionType_toString(LanguageExpressionType type) {
   switch (type) {
   case LANG_UNION:
@@ -351,33 +408,147 @@ char LanguageExpressionType_toString(LanguageExpressionType type) {
     return 'R';
   case LANG_COMPLEMENT:
     return 'N';
+  case LANG_STAR:
+    return '*';
+  case LANG_PLUS:
+    return '+';
+  case LANG_POWER:
+    return '^';
+  case LANG_EMPTY:
+    return 'E';
   default:
     return '?';
   }
 }
 
+typedef enum {
+  EXPRESSION_TASK,
+  TEXT_TASK,
+  UNARY_OPERATOR_TASK,
+  POSTFIX_OPERATOR_TASK,
+  BINARY_OPERATOR_TASK
+} ToStringTaskType;
+
+typedef struct {
+  ToStringTaskType type;
+  union {
+    LanguageExpression* expression;
+    const char* text;
+    char operator;
+  };
+  // The exponent of a `^` postfix operator.
+  unsigned int exponent;
+} ToStringTask;
+
+typedef struct {
+  char* buffer;
+  size_t length;
+  size_t capacity;
+} StringBuffer;
+
+static void _StringBuffer_append(StringBuffer* buffer, const char* str, size_t length) {
+  if (buffer->capacity < buffer->length + length + 1) {
+    while (buffer->capacity < buffer->length + length + 1) buffer->capacity *= 2;
+    buffer->buffer = realloc(buffer->buffer, buffer->capacity);
+    if (buffer->buffer == NULL) exitWithPerror(__func__, "realloc error");
+  }
+  memcpy(buffer->buffer + buffer->length, str, length);
+  buffer->length += length;
+  buffer->buffer[buffer->length] = '\0';
+}
+
+static void _StringBuffer_appendString(StringBuffer* buffer, const char* str) {
+  _StringBuffer_append(buffer, str, strlen(str));
+}
+
+/**
+ * Renders the expression in-order into a single growing buffer, using an
+ * explicit stack of pending tasks, so the cost is linear in the size of the
+ * expression regardless of its depth.
+ */
 char* LanguageExpression_toString(LanguageExpression* languageExpression) {
-  if (languageExpression->type == LANGUAGE) {
-    if (languageExpression->language->type == GRAMMAR_ID) {
-      return safeAsprintf("L(" COLORIZE_ID("%s") ")", languageExpression->language->id);
+  StringBuffer buffer = {.buffer = safeMalloc(INITIAL_WALK_CAPACITY), .length = 0, .capacity = INITIAL_WALK_CAPACITY};
+  buffer.buffer[0] = '\0';
+  size_t capacity = INITIAL_WALK_CAPACITY;
+  size_t length = 0;
+  ToStringTask* stack = safeMalloc(capacity * sizeof(ToStringTask));
+  stack[length++] = (ToStringTask){.type = EXPRESSION_TASK, .expression = languageExpression};
+
+  while (0 < length) {
+    // Every task pushes at most 3 new ones.
+    if (capacity < length + 3) {
+      capacity *= 2;
+      stack = realloc(stack, capacity * sizeof(ToStringTask));
+      if (stack == NULL) exitWithPerror(__func__, "realloc error");
+    }
+    ToStringTask task = stack[--length];
+    switch (task.type) {
+    case TEXT_TASK:
+      _StringBuffer_appendString(&buffer, task.text);
+      break;
+    case UNARY_OPERATOR_TASK: {
+      char str[] = {task.operator, '(', '\0'};
+      _StringBuffer_appendString(&buffer, str);
+      break;
+    }
+    case POSTFIX_OPERATOR_TASK: {
+      char str[16];
+      if (task.operator == '^') {
+        snprintf(str, sizeof(str), ")^%u", task.exponent);
+      } else {
+        snprintf(str, sizeof(str), ")%c", task.operator);
+      }
+      _StringBuffer_appendString(&buffer, str);
+      break;
+    }
+    case BINARY_OPERATOR_TASK: {
+      char str[] = {' ', task.operator, ' ', '\0'};
+      _StringBuffer_appendString(&buffer, str);
+      break;
+    }
+    case EXPRESSION_TASK: {
+      LanguageExpression* expression = task.expression;
+      char operator = LanguageExpressionType_toString(expression->type);
+      switch (expression->type) {
+      case LANGUAGE:
+        if (expression->language->type == WORDS_FILE) {
+          _StringBuffer_appendString(&buffer, "words(\"");
+          _StringBuffer_append(&buffer, expression->language->path.path, expression->language->path.length);
+          _StringBuffer_appendString(&buffer, "\")");
+          break;
+        }
+        _StringBuffer_appendString(&buffer, expression->language->type == GRAMMAR_ID ? "L(" : "(");
+        _StringBuffer_appendString(&buffer, BLUE_COLOR);
+        _StringBuffer_append(&buffer, expression->language->id.id, expression->language->id.length);
+        _StringBuffer_appendString(&buffer, RESET_COLOR ")");
+        break;
+      case LANG_REVERSE:
+      case LANG_COMPLEMENT:
+      case LANG_EMPTY:
+        stack[length++] = (ToStringTask){.type = TEXT_TASK, .text = ")"};
+        stack[length++] = (ToStringTask){.type = EXPRESSION_TASK, .expression = expression->unaryLanguageExpression};
+        stack[length++] = (ToStringTask){.type = UNARY_OPERATOR_TASK, .operator = operator};
+        break;
+      case LANG_STAR:
+      case LANG_PLUS:
+      case LANG_POWER:
+        stack[length++] =
+          (ToStringTask){.type = POSTFIX_OPERATOR_TASK, .operator = operator, .exponent = expression->exponent};
+        stack[length++] = (ToStringTask){.type = EXPRESSION_TASK, .expression = expression->unaryLanguageExpression};
+        stack[length++] = (ToStringTask){.type = TEXT_TASK, .text = "("};
+        break;
+      default:
+        stack[length++] = (ToStringTask){.type = EXPRESSION_TASK, .expression = expression->rightLanguageExpression};
+        stack[length++] = (ToStringTask){.type = BINARY_OPERATOR_TASK, .operator = operator};
+        stack[length++] = (ToStringTask){.type = EXPRESSION_TASK, .expression = expression->leftLanguageExpression};
+        break;
+      }
+      break;
+    }
     }
-    return safeAsprintf("(" COLORIZE_ID("%s") ")", languageExpression->language->id);
-  }
-  if (languageExpression->type == LANG_COMPLEMENT || languageExpression->type == LANG_REVERSE) {
-    char* unaryExpression = LanguageExpression_toString(languageExpression->unaryLanguageExpression);
-    char languageExpressionType = LanguageExpressionType_toString(languageExpression->type);
-    char* str = safeAsprintf("%c(%s)", languageExpressionType, unaryExpression);
-    free(unaryExpression);
-    return str;
   }
-
-  char* leftExpression = LanguageExpression_toString(languageExpression->leftLanguageExpression);
-  char* rightExpression = LanguageExpression_toString(languageExpression->rightLanguageExpression);
-  char languageExpressionType = LanguageExpressionType_toString(languageExpression->type);
-  char* str = safeAsprintf("%s %c %s", leftExpression, languageExpressionType, rightExpression);
-  free(leftExpression);
-  free(rightExpression);
-  return str;
+  free(stack);
+  return buffer.buffer;
 }
 
 char* LanguageBinding_toString(LanguageBinding* languageBinding) {
@@ -388,3 +559,32 @@ char* LanguageBinding_toString(LanguageBinding* languageBinding) {
   free(languageExpression);
   return str;
 }
+
+//////////// Queries ////////////
+
+void QueryBinding_free(QueryBinding* queryBinding) {
+  logDebugging(_logger, "Executing destructor: %s", __func__);
+  LanguageExpression_free(queryBinding->leftLanguageExpression);
+  if (queryBinding->rightLanguageExpression != NULL) LanguageExpression_free(queryBinding->rightLanguageExpression);
+  free(queryBinding->id.id);
+  free(queryBinding);
+}
+
+char* QueryBinding_toString(QueryBinding* queryBinding) {
+  char* left = LanguageExpression_toString(queryBinding->leftLanguageExpression);
+  char* str;
+  if (queryBinding->type == QUERY_EMPTINESS) {
+    str = safeAsprintf("QueryBinding{ id: " COLORIZE_ID("%s") ", query: empty(%s) }", queryBinding->id.id, left);
+  } else {
+    char* right = LanguageExpression_toString(queryBinding->rightLanguageExpression);
+    const char* relation = "==";
+    if (queryBinding->type == QUERY_INCLUSION) relation = "⊆";
+    if (queryBinding->type == QUERY_MEMBERSHIP) relation = "∈";
+    str = safeAsprintf(
+      "QueryBinding{ id: " COLORIZE_ID("%s") ", query: %s %s %s }", queryBinding->id.id, left, relation, right
+    );
+    free(right);
+  }
+  free(left);
+  return str;
+}
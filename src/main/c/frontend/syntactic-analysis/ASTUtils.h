@@ -5,6 +5,7 @@
 #include "../../shared/SetElement.h"
 #include "AbstractSyntaxTree.h"
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 void initializeASTUtilsModule();
@@ -43,6 +44,20 @@ char* ProductionRhsRule_toString(ProductionRhsRule* productionRhsRule);
 char* ProductionRhsRule_toStringEle(SetElement ele);
 
 //////////// Languages ////////////
+
+typedef void (*LanguageExpressionVisitorFn)(LanguageExpression* languageExpression, void* context);
+
+/**
+ * Visits every node of `languageExpression` in post-order (operands before
+ * their operator, left before right). It uses an explicit heap-allocated
+ * stack instead of recursion, so arbitrarily deep expressions can't overflow
+ * the call stack. The visitor may free the node it receives, and it may be NULL
+ * to just count the nodes. Returns how many nodes were visited.
+ */
+size_t LanguageExpression_walk(
+  LanguageExpression* languageExpression, LanguageExpressionVisitorFn visitor, void* context
+);
+
 void LanguageBinding_free(LanguageBinding* languageBinding);
 void LanguageExpression_free(LanguageExpression* languageExpression);
 void Language_free(Language* language);
@@ -50,4 +65,8 @@ char* LanguageBinding_toString(LanguageBinding* languageBinding);
 char* LanguageExpression_toString(LanguageExpression* languageExpression);
 char LanguageExpressionType_toString(LanguageExpressionType type);
 
+//////////// Queries ////////////
+void QueryBinding_free(QueryBinding* queryBinding);
+char* QueryBinding_toString(QueryBinding* queryBinding);
+
 #endif
@@ -15,7 +15,7 @@ typedef struct SetCDT* Set;
  * Node types for the Abstract Syntax Tree (AST).
  */
 
-typedef enum { GRAMMAR_DEFINITION, SYMBOL_SET, PRODUCTION_SET, LANGUAGE_SENTENCE } SentenceType;
+typedef enum { GRAMMAR_DEFINITION, SYMBOL_SET, PRODUCTION_SET, LANGUAGE_SENTENCE, QUERY_SENTENCE } SentenceType;
 
 typedef enum { SYMBOL_SYMBOL_T, SYMBOL_T, LAMBDA_T } ProductionRhsRuleType;
 
@@ -26,10 +26,17 @@ typedef enum {
   LANG_MINUS,
   LANG_CONCAT,
   LANG_REVERSE,
-  LANG_COMPLEMENT
+  LANG_COMPLEMENT,
+  LANG_STAR,
+  LANG_PLUS,
+  LANG_POWER,
+  // The empty language over the alphabet of its operand (a single language). Only the rewriting introduces it.
+  LANG_EMPTY
 } LanguageExpressionType;
 
-typedef enum { GRAMMAR_ID, LANGUAGE_ID } LanguageIdType;
+typedef enum { GRAMMAR_ID, LANGUAGE_ID, WORDS_FILE } LanguageIdType;
+
+typedef enum { QUERY_EMPTINESS, QUERY_INCLUSION, QUERY_EQUIVALENCE, QUERY_MEMBERSHIP } QueryType;
 
 /**
  * This typedefs allows self-referencing types.
@@ -37,6 +44,7 @@ typedef enum { GRAMMAR_ID, LANGUAGE_ID } LanguageIdType;
 
 typedef struct Id Id;
 typedef struct Symbol Symbol;
+typedef struct FilePath FilePath;
 
 typedef struct Program Program;
 typedef struct Sentence Sentence;
@@ -48,6 +56,7 @@ typedef struct ProductionRhsRule ProductionRhsRule;
 typedef struct LanguageBinding LanguageBinding;
 typedef struct LanguageExpression LanguageExpression;
 typedef struct Language Language;
+typedef struct QueryBinding QueryBinding;
 
 typedef Array SentenceArray;
 typedef Set SymbolSet;
@@ -64,6 +73,11 @@ struct Symbol {
   int length;
 };
 
+struct FilePath {
+  char* path;
+  int length;
+};
+
 struct Program {
   SentenceArray sentences;
 };
@@ -96,11 +110,30 @@ struct LanguageExpression {
     };
   };
   LanguageExpressionType type;
+  // The exponent of a LANG_POWER expression (whose operand is the unary one).
+  unsigned int exponent;
 };
 
 struct Language {
   LanguageIdType type;
+  union {
+    Id id;
+    // The word list of a WORDS_FILE language.
+    FilePath path;
+  };
+};
+
+/**
+ * A question about languages: whether the left one is empty (the right one is
+ * NULL), included in the right one, or equal to it. A membership query asks
+ * which words of the left one (always a word list, which is streamed rather
+ * than built) are in the right one.
+ */
+struct QueryBinding {
   Id id;
+  LanguageExpression* leftLanguageExpression;
+  LanguageExpression* rightLanguageExpression;
+  QueryType type;
 };
 
 struct ProductionSetBinding {
@@ -114,6 +147,7 @@ struct Sentence {
     SymbolSetBinding* symbolSetBinding;
     ProductionSetBinding* productionSetBinding;
     LanguageBinding* languageBinding;
+    QueryBinding* queryBinding;
   };
   SentenceType type;
 };
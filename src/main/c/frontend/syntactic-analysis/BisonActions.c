@@ -7,6 +7,7 @@
 #include "../../shared/SetElement.h"
 #include "../../shared/String.h"
 #include "../../shared/utils.h"
+#include "../lexical-analysis/SymbolFileReader.h"
 #include "ASTUtils.h"
 #include "AbstractSyntaxTree.h"
 #include <stdarg.h>
@@ -152,6 +153,13 @@ SymbolSet SymbolSet_add(SymbolSet array, Symbol symbol) {
   return array;
 }
 
+SymbolSet SymbolSetFile_new(FilePath path) {
+  _logSyntacticAnalyzerPushAction(__func__, "FilePath(%s)", path.path);
+  SymbolSet set = readSymbolFile(path.path);
+  free(path.path);
+  return set;
+}
+
 ProductionSetBinding* ProductionSetBinding_new(Id setId, ProductionSet productions) {
   _logSyntacticAnalyzerAction(__func__);
   ProductionSetBinding* productionSetBinding = safeMalloc(sizeof(ProductionSetBinding));
@@ -261,6 +269,14 @@ Language* Language_new(Id referenceId, LanguageIdType type) {
   return language;
 }
 
+Language* WordsLanguage_new(FilePath path) {
+  _logSyntacticAnalyzerPushAction(__func__, "FilePath(%s)", path.path);
+  Language* language = safeMalloc(sizeof(Language));
+  language->path = path;
+  language->type = WORDS_FILE;
+  return language;
+}
+
 LanguageExpression* SimpleLanguageExpression_new(Language* language) {
   _logSyntacticAnalyzerAction(__FUNCTION__);
   LanguageExpression* langExpression = safeMalloc(sizeof(LanguageExpression));
@@ -277,6 +293,15 @@ LanguageExpression* UnaryTypeLanguageExpression_new(LanguageExpression* lang, La
   return langExpression;
 }
 
+LanguageExpression* PowerLanguageExpression_new(LanguageExpression* lang, unsigned int exponent) {
+  _logSyntacticAnalyzerAction(__func__);
+  LanguageExpression* langExpression = safeMalloc(sizeof(LanguageExpression));
+  langExpression->type = LANG_POWER;
+  langExpression->unaryLanguageExpression = lang;
+  langExpression->exponent = exponent;
+  return langExpression;
+}
+
 LanguageExpression* ComplexLanguageExpression_new(
   LanguageExpression* leftLang, LanguageExpression* rightLang, LanguageExpressionType type
 ) {
@@ -302,6 +327,25 @@ Sentence* LanguageBindingSentence_new(LanguageBinding* languageBinding) {
   sentence->languageBinding = languageBinding;
   return sentence;
 }
+
+QueryBinding*
+QueryBinding_new(Id queryId, LanguageExpression* leftLang, LanguageExpression* rightLang, QueryType type) {
+  _logSyntacticAnalyzerAction(__func__);
+  QueryBinding* queryBinding = safeMalloc(sizeof(QueryBinding));
+  queryBinding->id = queryId;
+  queryBinding->leftLanguageExpression = leftLang;
+  queryBinding->rightLanguageExpression = rightLang;
+  queryBinding->type = type;
+  return queryBinding;
+}
+
+Sentence* QueryBindingSentence_new(QueryBinding* queryBinding) {
+  _logSyntacticAnalyzerAction(__func__);
+  Sentence* sentence = safeMalloc(sizeof(Sentence));
+  sentence->type = QUERY_SENTENCE;
+  sentence->queryBinding = queryBinding;
+  return sentence;
+}
 ///////////// Set operations /////////////
 
 SymbolSet SymbolSet_union(SymbolSet left, SymbolSet right) {
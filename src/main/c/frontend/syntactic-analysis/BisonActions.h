@@ -28,6 +28,7 @@ SymbolSetBinding* SymbolSetBinding_new(Id setId, SymbolSet symbols);
 
 SymbolSet SymbolSet_new(Symbol symbol);
 SymbolSet SymbolSet_add(SymbolSet array, Symbol symbol);
+SymbolSet SymbolSetFile_new(FilePath path);
 
 ProductionSetBinding* ProductionSetBinding_new(Id setId, ProductionSet productions);
 
@@ -43,12 +44,16 @@ ProductionRhsRule* ProductionRhsRuleSymbol_new(Symbol symbol);
 ProductionRhsRule* ProductionRhsRuleLambda_new();
 
 Language* Language_new(Id referenceId, LanguageIdType type);
+Language* WordsLanguage_new(FilePath path);
 LanguageExpression* SimpleLanguageExpression_new(Language* language);
 LanguageExpression* UnaryTypeLanguageExpression_new(LanguageExpression* lang, LanguageExpressionType type);
+LanguageExpression* PowerLanguageExpression_new(LanguageExpression* lang, unsigned int exponent);
 LanguageExpression*
 ComplexLanguageExpression_new(LanguageExpression* leftLang, LanguageExpression* rightLang, LanguageExpressionType type);
 LanguageBinding* LanguageBinding_new(Id langId, LanguageExpression* langExpression);
 Sentence* LanguageBindingSentence_new(LanguageBinding* languageBinding);
+QueryBinding* QueryBinding_new(Id queryId, LanguageExpression* leftLang, LanguageExpression* rightLang, QueryType type);
+Sentence* QueryBindingSentence_new(QueryBinding* queryBinding);
 
 // Set operations
 SymbolSet SymbolSet_union(SymbolSet left, SymbolSet right);
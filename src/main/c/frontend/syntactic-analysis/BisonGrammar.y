@@ -8,6 +8,9 @@
 #include "../../shared/Array.h"
 #include <stdio.h>
 
+// Deeply nested language expressions need a deeper stack than Bison's default (10000).
+#define YYMAXDEPTH parserMaximumDepth()
+
 %}
 
 %code requires {
@@ -26,7 +29,9 @@
 	/** Terminals. */
 	Token token;
   Id id;
+  unsigned int exponent;
   Symbol symbol;
+  FilePath filePath;
 
 	/** Non-terminals. */
 	Program* program;
@@ -43,6 +48,7 @@
   ProductionRhsRuleSet productionRhsRules;
   ProductionRhsRule* productionRhsRule;
   LanguageBinding* languageBinding;
+  QueryBinding* queryBinding;
   LanguageExpression* languageExpression;
   Language* language;
 }
@@ -63,8 +69,18 @@
 %token <token> SUBTRACTION
 %token <token> CONCAT
 %token <token> COMPLEMENT
+%token <token> STAR
+%token <token> PLUS
+%token <exponent> POWER
+%token <token> INCLUSION
+%token <token> EQUIVALENCE
+%token <token> MEMBERSHIP
+%token <token> EMPTY_PARENTHESIS_OPEN
 %token <token> LANG_REVERSE_PARENTHESIS_OPEN
 %token <symbol> SYMBOL
+%token <filePath> FILE_PATH
+%token <token> FILE_PARENTHESIS_OPEN
+%token <token> WORDS_PARENTHESIS_OPEN
 %token <token> L
 %token <token> PARENTHESIS_OPEN
 %token <token> PARENTHESIS_CLOSE
@@ -86,6 +102,7 @@
 %type <productionRhsRules> productionRhsRules
 %type <productionRhsRule> productionRhsRule
 %type <languageBinding> languageBinding
+%type <queryBinding> queryBinding
 %type <languageExpression> languageExpression
 %type <language> language
 
@@ -119,6 +136,7 @@ actually needed.
 %left SUBTRACTION
 %left CONCAT
 %left COMPLEMENT
+%left STAR PLUS POWER
 
 
 %%
@@ -136,6 +154,7 @@ sentence: grammarDefinition                     { $$ = GrammarDefinitionSentence
   | symbolSetBinding                            { $$ = SymbolSetBindingSentence_new($1); }
   | productionSetBinding                        { $$ = ProductionSetBindingSentence_new($1); }
   | languageBinding                             { $$ = LanguageBindingSentence_new($1); }
+  | queryBinding                                { $$ = QueryBindingSentence_new($1); }
   ;
 
 grammarDefinition:
@@ -158,6 +177,7 @@ symbolSet: BRACES_OPEN symbols[values] BRACES_CLOSE             { $$ = $values;
   | symbolSet[left] INTERSECTION symbolSet[right]               { $$ = SymbolSet_intersection($left, $right); }
   | symbolSet[left] SUBTRACTION symbolSet[right]                { $$ = SymbolSet_subtraction($left, $right); }
   | PARENTHESIS_OPEN symbolSet[sSet] PARENTHESIS_CLOSE       { $$ = $sSet; }
+  | FILE_PARENTHESIS_OPEN FILE_PATH[path] PARENTHESIS_CLOSE     { $$ = SymbolSetFile_new($path); if ($$ == NULL) YYABORT; }
   ;
 
 symbols: SYMBOL                                                 { $$ = SymbolSet_new($1); }
@@ -199,11 +219,25 @@ languageExpression: language                                                { $$
  | languageExpression[left] CONCAT languageExpression[right]                { $$ = ComplexLanguageExpression_new($left, $right, LANG_CONCAT); }
  | LANG_REVERSE_PARENTHESIS_OPEN languageExpression[lang] PARENTHESIS_CLOSE { $$ = UnaryTypeLanguageExpression_new($lang, LANG_REVERSE); }
  | COMPLEMENT languageExpression[lang]                                      { $$ = UnaryTypeLanguageExpression_new($lang, LANG_COMPLEMENT); }
+ | languageExpression[lang] STAR                                            { $$ = UnaryTypeLanguageExpression_new($lang, LANG_STAR); }
+ | languageExpression[lang] PLUS                                            { $$ = UnaryTypeLanguageExpression_new($lang, LANG_PLUS); }
+ | languageExpression[lang] POWER[exponent]                                 { $$ = PowerLanguageExpression_new($lang, $exponent); }
  | PARENTHESIS_OPEN languageExpression[lang] PARENTHESIS_CLOSE              { $$ = $lang; }
  ;
 
+queryBinding: ID[queryID] EQUALS EMPTY_PARENTHESIS_OPEN languageExpression[lang] PARENTHESIS_CLOSE
+                                                                            { $$ = QueryBinding_new($queryID, $lang, NULL, QUERY_EMPTINESS); }
+ | ID[queryID] EQUALS languageExpression[left] INCLUSION languageExpression[right]
+                                                                            { $$ = QueryBinding_new($queryID, $left, $right, QUERY_INCLUSION); }
+ | ID[queryID] EQUALS languageExpression[left] EQUIVALENCE languageExpression[right]
+                                                                            { $$ = QueryBinding_new($queryID, $left, $right, QUERY_EQUIVALENCE); }
+ | ID[queryID] EQUALS WORDS_PARENTHESIS_OPEN FILE_PATH[path] PARENTHESIS_CLOSE MEMBERSHIP languageExpression[lang]
+                                                                            { $$ = QueryBinding_new($queryID, SimpleLanguageExpression_new(WordsLanguage_new($path)), $lang, QUERY_MEMBERSHIP); }
+ ;
+
 language: L PARENTHESIS_OPEN ID[grammarID] PARENTHESIS_CLOSE                { $$ = Language_new($grammarID, GRAMMAR_ID); }
  | ID[id]                                                                   { $$ = Language_new($id, LANGUAGE_ID); }
+ | WORDS_PARENTHESIS_OPEN FILE_PATH[path] PARENTHESIS_CLOSE                 { $$ = WordsLanguage_new($path); }
  ;
  
 %%
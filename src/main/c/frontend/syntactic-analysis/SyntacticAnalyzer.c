@@ -1,5 +1,6 @@
 #include "SyntacticAnalyzer.h"
 #include "../../shared/CompilerState.h"
+#include "../../shared/Environment.h"
 #include "../../shared/Logger.h"
 #include "../../shared/Type.h"
 #include "../lexical-analysis/LexicalAnalyzerContext.h"
@@ -8,10 +9,22 @@
 /* MODULE INTERNAL STATE */
 
 static CompilerState* _currentCompilerState = NULL;
+#define DEFAULT_PARSER_MAXIMUM_DEPTH 10000000
+
+static long _parserMaximumDepth = DEFAULT_PARSER_MAXIMUM_DEPTH;
 static Logger* _logger = NULL;
 
 void initializeSyntacticAnalyzerModule() {
   _logger = createLogger("SyntacticAnalyzer");
+  const long long depth = getIntegerOrDefault("PARSER_MAXIMUM_DEPTH", DEFAULT_PARSER_MAXIMUM_DEPTH);
+  if (depth <= 0) {
+    logWarning(
+      _logger, "Invalid PARSER_MAXIMUM_DEPTH (%lld), using the default (%d).", depth, DEFAULT_PARSER_MAXIMUM_DEPTH
+    );
+    _parserMaximumDepth = DEFAULT_PARSER_MAXIMUM_DEPTH;
+  } else {
+    _parserMaximumDepth = (long)depth;
+  }
 }
 
 void shutdownSyntacticAnalyzerModule() {
@@ -43,6 +56,10 @@ void yyerror(const char* error) {
 
 /* PUBLIC FUNCTIONS */
 
+long parserMaximumDepth() {
+  return _parserMaximumDepth;
+}
+
 CompilerState* currentCompilerState() {
   return _currentCompilerState;
 }
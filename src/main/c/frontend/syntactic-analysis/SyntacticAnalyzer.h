@@ -23,6 +23,13 @@ typedef enum { ACCEPT, OUT_OF_MEMORY, REJECT, UNKNOWN_ERROR } SyntacticAnalysisS
  */
 CompilerState* currentCompilerState();
 
+/**
+ * The maximum number of states the Bison stack can hold, as configured with
+ * the "PARSER_MAXIMUM_DEPTH" environment variable. The stack grows on demand
+ * up to this limit; exceeding it rejects the input as "memory exhausted".
+ */
+long parserMaximumDepth();
+
 /**
  * Executes the parsing phase of the compiler.
  */
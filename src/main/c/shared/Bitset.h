@@ -0,0 +1,44 @@
+#ifndef BITSET_HEADER
+#define BITSET_HEADER
+
+#include "utils.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * A fixed-size set of small integers, packed in 64-bit words. It's a plain
+ * heap-allocated array, so it's released with `free`.
+ */
+typedef uint64_t* Bitset;
+
+/** The number of words needed to hold `size` bits. */
+static inline size_t Bitset_words(size_t size) {
+  return (size + 63) / 64;
+}
+
+/** A new bitset of `size` bits, all of them cleared. */
+static inline Bitset Bitset_new(size_t size) {
+  return safeCalloc(Bitset_words(size) == 0 ? 1 : Bitset_words(size), sizeof(uint64_t));
+}
+
+static inline bool Bitset_test(const uint64_t* bitset, size_t bit) {
+  return (bitset[bit >> 6] >> (bit & 63)) & 1;
+}
+
+static inline void Bitset_set(uint64_t* bitset, size_t bit) {
+  bitset[bit >> 6] |= UINT64_C(1) << (bit & 63);
+}
+
+static inline void Bitset_clear(uint64_t* bitset, size_t bit) {
+  bitset[bit >> 6] &= ~(UINT64_C(1) << (bit & 63));
+}
+
+/** The number of bits set among the first `size` bits. */
+static inline size_t Bitset_count(const uint64_t* bitset, size_t size) {
+  size_t count = 0;
+  for (size_t k = 0; k < Bitset_words(size); ++k) count += (size_t)__builtin_popcountll(bitset[k]);
+  return count;
+}
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef COMPILER_STATE_HEADER
 #define COMPILER_STATE_HEADER
 
+#include "Configuration.h"
 #include "Type.h"
 
 /**
@@ -19,9 +20,13 @@ typedef struct {
   // A flag that indicates the current state of the compilation so far.
   boolean succeed;
 
+  // The symbol table of the program, built after the syntactic analysis.
+  void* symbolTable;
+
+  // The command-line configuration.
+  const Configuration* configuration;
+
   // TODO: Add an stack to handle nested scopes.
-  // TODO: Add a symbol table.
-  // TODO: Add configuration.
   // TODO: ...
 
   // The computed value of the entire program (only for the calculator).
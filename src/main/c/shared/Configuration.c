@@ -0,0 +1,81 @@
+#include "Configuration.h"
+#include "Logger.h"
+#include "Type.h"
+#include "utils.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* PRIVATE FUNCTIONS */
+
+static boolean _addEmittedIds(Configuration* configuration, const char* list, const Logger* logger);
+
+/**
+ * Appends every id in a comma-separated list to the emitted ids. Empty ids
+ * (e.g., "T,,U" or a trailing comma) are rejected.
+ */
+static boolean _addEmittedIds(Configuration* configuration, const char* list, const Logger* logger) {
+  const char* start = list;
+  while (true) {
+    const char* end = strchr(start, ',');
+    const size_t length = end == NULL ? strlen(start) : (size_t)(end - start);
+    if (length == 0) {
+      logError(logger, "Invalid \"--emit\" list: \"%s\" (empty identifier).", list);
+      return false;
+    }
+    char* id = safeCalloc(1 + length, sizeof(char));
+    memcpy(id, start, length);
+    configuration->emittedIds =
+      realloc((void*)configuration->emittedIds, (1 + configuration->emittedIdsCount) * sizeof(char*));
+    if (configuration->emittedIds == NULL) exitWithPerror(__func__, "realloc error");
+    configuration->emittedIds[configuration->emittedIdsCount++] = id;
+    if (end == NULL) return true;
+    start = end + 1;
+  }
+}
+
+/* PUBLIC FUNCTIONS */
+
+Configuration* createConfiguration(const int count, const char** arguments) {
+  Logger* logger = createLogger("Configuration");
+  Configuration* configuration = safeMalloc(sizeof(Configuration));
+  configuration->emittedIds = NULL;
+  configuration->emittedIdsCount = 0;
+
+  static const char emitOption[] = "--emit";
+  static const size_t emitOptionLength = sizeof(emitOption) - 1;
+  boolean valid = true;
+  for (int k = 1; valid && k < count; ++k) {
+    const char* argument = arguments[k];
+    if (strcmp(argument, emitOption) == 0) {
+      if (k + 1 < count) {
+        valid = _addEmittedIds(configuration, arguments[++k], logger);
+      } else {
+        logError(logger, "Missing identifier list after \"%s\".", emitOption);
+        valid = false;
+      }
+    } else if (strncmp(argument, emitOption, emitOptionLength) == 0 && argument[emitOptionLength] == '=') {
+      valid = _addEmittedIds(configuration, argument + emitOptionLength + 1, logger);
+    } else {
+      logError(logger, "Unknown argument: \"%s\".", argument);
+      valid = false;
+    }
+  }
+
+  destroyLogger(logger);
+  if (!valid) {
+    destroyConfiguration(configuration);
+    return NULL;
+  }
+  return configuration;
+}
+
+void destroyConfiguration(Configuration* configuration) {
+  if (configuration != NULL) {
+    for (size_t k = 0; k < configuration->emittedIdsCount; ++k) {
+      free(configuration->emittedIds[k]);
+    }
+    free((void*)configuration->emittedIds);
+    free(configuration);
+  }
+}
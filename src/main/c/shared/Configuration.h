@@ -0,0 +1,32 @@
+#ifndef CONFIGURATION_HEADER
+#define CONFIGURATION_HEADER
+
+#include "Type.h"
+#include <stddef.h>
+
+/**
+ * The command-line configuration of a compilation.
+ */
+typedef struct {
+  // The language and query bindings requested with "--emit", or NULL if every binding must be emitted.
+  char** emittedIds;
+  size_t emittedIdsCount;
+} Configuration;
+
+/**
+ * Parses the command-line arguments of the application. Returns NULL (after
+ * logging the reason) if the arguments are invalid.
+ *
+ * Supported options:
+ *	--emit <id>[,<id>...]	Only evaluate the listed language and query
+ *				bindings (and whatever they depend on). Can be
+ *				repeated.
+ */
+Configuration* createConfiguration(const int count, const char** arguments);
+
+/**
+ * Destroy a configuration and its resources.
+ */
+void destroyConfiguration(Configuration* configuration);
+
+#endif
@@ -1,5 +1,6 @@
 #include "Environment.h"
 #include "Type.h"
+#include <errno.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -16,6 +17,20 @@ boolean getBooleanOrDefault(const char* name, const boolean defaultValue) {
   }
 }
 
+long long getIntegerOrDefault(const char* name, const long long defaultValue) {
+  const char* value = getStringOrDefault(name, NULL);
+  if (value == NULL || *value == '\0') {
+    return defaultValue;
+  }
+  char* end = NULL;
+  errno = 0;
+  const long long integer = strtoll(value, &end, 10);
+  if (errno != 0 || *end != '\0') {
+    return defaultValue;
+  }
+  return integer;
+}
+
 const char* getStringOrDefault(const char* name, const char* defaultValue) {
   const char* value = getenv(name);
   if (value == NULL) {
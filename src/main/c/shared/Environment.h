@@ -10,6 +10,13 @@
  */
 boolean getBooleanOrDefault(const char* name, const boolean defaultValue);
 
+/**
+ * Analog to "getStringOrDefault", but parsing the value as a decimal integer.
+ * The default value is used when the variable is undefined or isn't a valid
+ * integer.
+ */
+long long getIntegerOrDefault(const char* name, const long long defaultValue);
+
 /**
  * Gets the value of an environment variable by name, or returns a default
  * value if the variable is undefined.
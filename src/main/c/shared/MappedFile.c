@@ -0,0 +1,51 @@
+#include "MappedFile.h"
+#include "Logger.h"
+#include "utils.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* PUBLIC FUNCTIONS */
+
+MappedFile* MappedFile_open(const char* path, const Logger* logger) {
+  const int descriptor = open(path, O_RDONLY);
+  if (descriptor < 0) {
+    logError(logger, "Can't open the file \"%s\": %s.", path, strerror(errno));
+    return NULL;
+  }
+  struct stat status;
+  if (fstat(descriptor, &status) != 0 || !S_ISREG(status.st_mode)) {
+    logError(logger, "The file \"%s\" is not a regular file.", path);
+    close(descriptor);
+    return NULL;
+  }
+  MappedFile* file = safeMalloc(sizeof(MappedFile));
+  file->data = NULL;
+  file->size = (size_t)status.st_size;
+  if (0 < file->size) {
+    void* mapping = mmap(NULL, file->size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (mapping == MAP_FAILED) {
+      logError(logger, "Can't map the file \"%s\": %s.", path, strerror(errno));
+      close(descriptor);
+      free(file);
+      return NULL;
+    }
+    madvise(mapping, file->size, MADV_SEQUENTIAL);
+    file->data = mapping;
+  }
+  // The mapping outlives the descriptor.
+  close(descriptor);
+  return file;
+}
+
+void MappedFile_close(MappedFile* file) {
+  if (file != NULL) {
+    if (file->data != NULL) munmap((void*)file->data, file->size);
+    free(file);
+  }
+}
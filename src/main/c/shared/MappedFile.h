@@ -0,0 +1,30 @@
+#ifndef MAPPED_FILE_HEADER
+#define MAPPED_FILE_HEADER
+
+#include "Logger.h"
+#include <stddef.h>
+
+/**
+ * A read-only, memory-mapped file. Empty files have no mapping (`data` is
+ * NULL and `size` is 0).
+ */
+typedef struct {
+  const char* data;
+  size_t size;
+} MappedFile;
+
+/**
+ * Maps a whole regular file in memory, hinting the kernel that it will be
+ * read sequentially.
+ *
+ * @return A heap-allocated `MappedFile`, or NULL (after logging the reason
+ *         with `logger`) if the file can't be opened or mapped.
+ */
+MappedFile* MappedFile_open(const char* path, const Logger* logger);
+
+/**
+ * Unmaps the file and releases its resources.
+ */
+void MappedFile_close(MappedFile* file);
+
+#endif
@@ -91,6 +91,11 @@ void Set_freeNotElements(Set set) {
   Set_free(set);
 }
 
+void Set_reserve(Set set, size_t count) {
+  if (set == NULL) SET_INSTANCE_NULL;
+  if (set->capacity < count) growTo(set, count);
+}
+
 bool Set_add(Set set, SetElement ele) {
   if (set == NULL) SET_INSTANCE_NULL;
   uint32_t idx;
@@ -157,6 +162,7 @@ bool Set_Has(Set set, SetElement ele) {
 void Set_union(Set dest, Set src) {
   if (dest == NULL) SET_INSTANCE_NULL;
   if (src == NULL) return;
+  Set_reserve(dest, dest->count + src->count);
 
   for (int i = 0; i < src->capacity; ++i) {
     Node* node = src->nodes[i];
@@ -206,25 +212,26 @@ char* Set_toString(Set set) {
   if (set == NULL) SET_INSTANCE_NULL;
   if (set->toStringEleFn == NULL) exitInvalidArgument(__func__, "print element function not set");
   if (set->count == 0) return safeAsprintf("{}");
-  char* str = safeAsprintf("{ ");
 
+  // The element strings are joined at the end, so large sets aren't copied over and over again.
+  char** eleStrs = safeMalloc(set->count * sizeof(char*));
+  size_t length = strlen("{  }");
+  size_t count = 0;
   for (int i = 0; i < set->capacity; ++i) {
-    Node* node = set->nodes[i];
-    if (node == NULL) continue;
-    while (node != NULL) {
-      char* eleStr = set->toStringEleFn(node->element);
-      char* newStr = safeAsprintf("%s%s, ", str, eleStr);
-      free(str);
-      free(eleStr);
-      str = newStr;
-      node = node->next;
+    for (Node* node = set->nodes[i]; node != NULL; node = node->next) {
+      eleStrs[count] = set->toStringEleFn(node->element);
+      length += strlen(eleStrs[count++]) + strlen(", ");
     }
   }
 
-  size_t len = strlen(str);
-  str[len - 2] = ' ';
-  str[len - 1] = '}';
-
+  char* str = safeMalloc(length + 1);
+  char* end = stpcpy(str, "{ ");
+  for (size_t i = 0; i < count; ++i) {
+    end = stpcpy(end, eleStrs[i]);
+    end = stpcpy(end, i + 1 < count ? ", " : " }");
+    free(eleStrs[i]);
+  }
+  free((void*)eleStrs);
   return str;
 }
 
@@ -296,10 +303,21 @@ uint32_t hashIdx(Set set, SetElement ele, uint32_t* idx) {
 }
 
 void growTo(Set set, size_t newCapacity) {
-  Node** aux = (Node**)realloc((void*)set->nodes, newCapacity * sizeof(Node*));
-  if (aux == NULL) exitWithPerror(__func__, "realloc error");
+  Node** nodes = (Node**)calloc(newCapacity, sizeof(Node*));
+  if (nodes == NULL) exitWithPerror(__func__, "calloc error");
+  for (size_t i = 0; i < set->capacity; ++i) {
+    Node* node = set->nodes[i];
+    while (node != NULL) {
+      Node* next = node->next;
+      size_t idx = node->hash % newCapacity;
+      node->next = nodes[idx];
+      nodes[idx] = node;
+      node = next;
+    }
+  }
+  free((void*)set->nodes);
   set->capacity = newCapacity;
-  set->nodes = aux;
+  set->nodes = nodes;
 }
 
 void growBy(Set set, size_t extraCapacity) {
@@ -31,6 +31,13 @@ Set Set_new(
 );
 void Set_free(Set set);
 
+/**
+ * Grows the set so that it can hold `count` elements with, on average, at
+ * most one element per bucket. Existing elements are rehashed. Use it before
+ * bulk insertions of a known size; it never shrinks the set.
+ */
+void Set_reserve(Set set, size_t count);
+
 /**
  * If `ele` is already in `set` and `freeEleFn` was set on initialization,
  * then `ele` will be freed by this function.
@@ -1,7 +1,10 @@
 #ifndef TYPE_HEADER
 #define TYPE_HEADER
 
-typedef enum { false = 0, true = 1 } boolean;
+// Based on <stdbool.h>, so both headers can be included in any order.
+#include <stdbool.h>
+
+typedef bool boolean;
 
 typedef int Token;
 
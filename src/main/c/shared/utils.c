@@ -48,3 +48,13 @@ void* safeCalloc(size_t n, size_t size) {
   if (ptr == NULL) exitWithPerror(__func__, "@calloc error");
   return ptr;
 }
+
+void* safeReserve(void* array, size_t* capacity, size_t count, size_t elementSize) {
+  if (count <= *capacity) return array;
+  size_t newCapacity = *capacity == 0 ? 16 : *capacity;
+  while (newCapacity < count) newCapacity *= 2;
+  array = realloc(array, newCapacity * elementSize);
+  if (array == NULL) exitWithPerror(__func__, "@realloc error");
+  *capacity = newCapacity;
+  return array;
+}
@@ -10,4 +10,10 @@ __attribute__((noreturn)) void exitInvalidArgument(const char* functionName, con
 void* safeMalloc(size_t size);
 void* safeCalloc(size_t n, size_t size);
 
+/**
+ * Grows a heap-allocated array so that it can hold at least `count` elements,
+ * doubling its capacity from 16. Returns the (possibly moved) array.
+ */
+void* safeReserve(void* array, size_t* capacity, size_t count, size_t elementSize);
+
 #endif